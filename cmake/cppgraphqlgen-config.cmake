@@ -30,5 +30,9 @@ The following functions are defined to help with code generation and build targe
 include(CMakeFindDependencyMacro)
 find_package(Threads REQUIRED)
 find_package(pegtl 3.2.7 CONFIG REQUIRED)
+
+# graphqljson links to simdjson if it was found when cppgraphqlgen was built.
+find_package(simdjson CONFIG QUIET)
+
 include("${CMAKE_CURRENT_LIST_DIR}/cppgraphqlgen-targets.cmake")
 include("${CMAKE_CURRENT_LIST_DIR}/cppgraphqlgen-functions.cmake")
@@ -157,6 +157,8 @@ struct [[nodiscard("unnecessary construction")]] OutputField
 	TypeModifierStack modifiers;
 	std::string_view description;
 	std::optional<std::string_view> deprecationReason;
+	std::optional<std::size_t> costWeight;
+	std::vector<std::string_view> costMultipliers;
 	std::optional<tao::graphqlpeg::position> position;
 	bool interfaceField = false;
 	bool inheritedField = false;
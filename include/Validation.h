@@ -27,10 +27,20 @@ struct [[nodiscard("unnecessary construction")]] ValidateArgument
 
 using ValidateTypeFieldArguments = internal::string_view_map<ValidateArgument>;
 
+// A pagination argument which multiplies the cost of the field selection set, and the value to
+// use if it's not specified in the query.
+struct [[nodiscard("unnecessary construction")]] ValidateCostMultiplier
+{
+	std::string_view argumentName;
+	size_t defaultValue = 1;
+};
+
 struct [[nodiscard("unnecessary construction")]] ValidateTypeField
 {
 	ValidateType returnType;
 	ValidateTypeFieldArguments arguments;
+	size_t costWeight = 1;
+	std::vector<ValidateCostMultiplier> costMultipliers;
 };
 
 using ValidateDirectiveArguments = internal::string_view_map<ValidateArgument>;
@@ -128,7 +138,8 @@ using ValidateFieldArguments = internal::string_view_map<ValidateArgumentValuePt
 struct [[nodiscard("unnecessary construction")]] ValidateField
 {
 	ValidateField(ValidateType&& returnType, ValidateType&& objectType, std::string_view fieldName,
-		ValidateFieldArguments&& arguments);
+		ValidateFieldArguments&& arguments, std::string_view scopedTypeName,
+		schema_location position);
 
 	[[nodiscard("unnecessary call")]] bool operator==(const ValidateField& other) const;
 
@@ -136,8 +147,19 @@ struct [[nodiscard("unnecessary construction")]] ValidateField
 	ValidateType objectType;
 	std::string_view fieldName;
 	ValidateFieldArguments arguments;
+
+	// These members are only used to report a conflict if the field is merged from a fragment.
+	std::string_view scopedTypeName;
+	schema_location position;
+
+	// Static cost of the field including its selection set, which is filled in after visiting it.
+	size_t cost = 0;
 };
 
+// Fields selected in the same selection set, indexed by their alias (or name if there is no alias).
+// They are shared between the selection sets which spread the same fragment.
+using ValidateSelectionFields = internal::string_view_map<std::shared_ptr<const ValidateField>>;
+
 using ValidateTypes = internal::string_view_map<ValidateType>;
 
 // ValidateVariableTypeVisitor visits the AST and builds a ValidateType structure representing
@@ -165,12 +187,56 @@ private:
 	ValidateType _variableType;
 };
 
+// ValidateSchema stores the Introspection schema information which does not change between
+// queries. It is immutable once it has been constructed, so a single instance can be shared by
+// every ValidateExecutableVisitor on any thread.
+class [[nodiscard("unnecessary construction")]] ValidateSchema
+{
+public:
+	GRAPHQLSERVICE_EXPORT explicit ValidateSchema(std::shared_ptr<schema::Schema> schema);
+
+	using FieldTypes = internal::string_view_map<ValidateTypeField>;
+	using TypeFields = internal::string_view_map<FieldTypes>;
+	using InputFieldTypes = ValidateTypeFieldArguments;
+	using InputTypeFields = internal::string_view_map<InputFieldTypes>;
+	using EnumValues = internal::string_view_map<internal::string_view_set>;
+	using Directives = internal::string_view_map<ValidateDirective>;
+	using MatchingTypes = internal::string_view_map<internal::string_view_set>;
+	using ScalarTypes = internal::string_view_set;
+
+	[[nodiscard("unnecessary call")]] static constexpr bool isScalarType(
+		introspection::TypeKind kind);
+
+	[[nodiscard("unnecessary call")]] static ValidateTypeFieldArguments getArguments(
+		const std::vector<std::shared_ptr<const schema::InputValue>>& args);
+
+private:
+	friend class ValidateExecutableVisitor;
+
+	[[nodiscard("unnecessary call")]] FieldTypes getTypeFields(
+		const schema::BaseType& type, bool isQueryType) const;
+
+	const std::shared_ptr<schema::Schema> _schema;
+
+	ValidateTypes _operationTypes;
+	ValidateTypes _types;
+	MatchingTypes _matchingTypes;
+	Directives _directives;
+	EnumValues _enumValues;
+	ScalarTypes _scalarTypes;
+	TypeFields _typeFields;
+	InputTypeFields _inputTypeFields;
+};
+
 // ValidateExecutableVisitor visits the AST and validates that it is executable against the service
-// schema.
+// schema. Each instance only holds the state for validating one query at a time, so create a new
+// one on the stack for each query and share the ValidateSchema between them.
 class [[nodiscard("unnecessary construction")]] ValidateExecutableVisitor
 {
 public:
 	GRAPHQLSERVICE_EXPORT ValidateExecutableVisitor(std::shared_ptr<schema::Schema> schema);
+	GRAPHQLSERVICE_EXPORT ValidateExecutableVisitor(
+		std::shared_ptr<const ValidateSchema> validationSchema, RequestCostLimit costLimit = {});
 
 	GRAPHQLSERVICE_EXPORT void visit(const peg::ast_node& root);
 
@@ -178,22 +244,17 @@ public:
 	getStructuredErrors();
 
 private:
-	[[nodiscard("unnecessary call")]] static ValidateTypeFieldArguments getArguments(
-		const std::vector<std::shared_ptr<const schema::InputValue>>& args);
-
-	using FieldTypes = internal::string_view_map<ValidateTypeField>;
-	using TypeFields = internal::string_view_map<FieldTypes>;
-	using InputFieldTypes = ValidateTypeFieldArguments;
-	using InputTypeFields = internal::string_view_map<InputFieldTypes>;
-	using EnumValues = internal::string_view_map<internal::string_view_set>;
-
-	[[nodiscard("unnecessary call")]] constexpr bool isScalarType(introspection::TypeKind kind);
+	using FieldTypes = ValidateSchema::FieldTypes;
+	using TypeFields = ValidateSchema::TypeFields;
+	using InputFieldTypes = ValidateSchema::InputFieldTypes;
+	using InputTypeFields = ValidateSchema::InputTypeFields;
+	using EnumValues = ValidateSchema::EnumValues;
 
 	[[nodiscard("unnecessary call")]] bool matchesScopedType(std::string_view name) const;
 
-	[[nodiscard("unnecessary call")]] TypeFields::const_iterator getScopedTypeFields();
+	[[nodiscard("unnecessary call")]] TypeFields::const_iterator getScopedTypeFields() const;
 	[[nodiscard("unnecessary call")]] InputTypeFields::const_iterator getInputTypeFields(
-		std::string_view name);
+		std::string_view name) const;
 	[[nodiscard("unnecessary call")]] static const ValidateType& getValidateFieldType(
 		const FieldTypes::mapped_type& value);
 	[[nodiscard("unnecessary call")]] static const ValidateType& getValidateFieldType(
@@ -214,6 +275,13 @@ private:
 	void visitFragmentSpread(const peg::ast_node& fragmentSpread);
 	void visitInlineFragment(const peg::ast_node& inlineFragment);
 
+	void mergeFragmentFields(const ValidateSelectionFields& fragmentFields);
+
+	[[nodiscard("unnecessary call")]] size_t getCostMultiplier(
+		const ValidateTypeField& typeField, const ValidateFieldArguments& arguments) const;
+	[[nodiscard("unnecessary call")]] static size_t getSelectionCost(
+		const ValidateSelectionFields& selectionFields) noexcept;
+
 	void visitDirectives(
 		introspection::DirectiveLocation location, const peg::ast_node& directives);
 
@@ -223,27 +291,31 @@ private:
 		const ValidateType& variableType, const schema_location& position,
 		const ValidateType& inputType);
 
-	const std::shared_ptr<schema::Schema> _schema;
+	const std::shared_ptr<const ValidateSchema> _validationSchema;
+	const std::shared_ptr<schema::Schema>& _schema;
+	const RequestCostLimit _costLimit;
 	std::list<schema_error> _errors;
 
-	using Directives = internal::string_view_map<ValidateDirective>;
+	using Directives = ValidateSchema::Directives;
 	using AstNodeRef = std::reference_wrapper<const peg::ast_node>;
 	using ExecutableNodes = internal::string_view_map<AstNodeRef>;
 	using FragmentSet = internal::string_view_set;
-	using MatchingTypes = internal::string_view_map<internal::string_view_set>;
-	using ScalarTypes = internal::string_view_set;
+	using MatchingTypes = ValidateSchema::MatchingTypes;
+	using ScalarTypes = ValidateSchema::ScalarTypes;
 	using VariableDefinitions = internal::string_view_map<AstNodeRef>;
 	using VariableTypes = internal::string_view_map<ValidateArgument>;
 	using OperationVariables = std::optional<VariableTypes>;
 	using VariableSet = internal::string_view_set;
 
-	// These members store Introspection schema information which does not change between queries.
-	ValidateTypes _operationTypes;
-	ValidateTypes _types;
-	MatchingTypes _matchingTypes;
-	Directives _directives;
-	EnumValues _enumValues;
-	ScalarTypes _scalarTypes;
+	// These members reference Introspection schema information in the shared ValidateSchema.
+	const ValidateTypes& _operationTypes;
+	const ValidateTypes& _types;
+	const MatchingTypes& _matchingTypes;
+	const Directives& _directives;
+	const EnumValues& _enumValues;
+	const ScalarTypes& _scalarTypes;
+	const TypeFields& _typeFields;
+	const InputTypeFields& _inputTypeFields;
 
 	// These members store information that's specific to a single query and changes every time we
 	// visit a new one. They must be reset in between queries.
@@ -257,12 +329,17 @@ private:
 	VariableDefinitions _variableDefinitions;
 	VariableSet _referencedVariables;
 	FragmentSet _fragmentStack;
+	size_t _cyclicFragmentSpreads = 0;
 	size_t _fieldCount = 0;
 	size_t _introspectionFieldCount = 0;
-	TypeFields _typeFields;
-	InputTypeFields _inputTypeFields;
+	bool _subscriptionRoot = false;
 	ValidateType _scopedType;
-	internal::string_view_map<ValidateField> _selectionFields;
+	ValidateSelectionFields _selectionFields;
+
+	// Fragments which have already been validated in the current operation, or in the fragment
+	// definitions outside of an operation. A fragment selection set is always validated in the scope
+	// of its own type condition, so every spread of the same fragment has the same fields and errors.
+	internal::string_view_map<std::shared_ptr<const ValidateSelectionFields>> _validatedFragments;
 };
 
 } // namespace graphql::service
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifndef BINARYRESPONSE_H
+#define BINARYRESPONSE_H
+
+#include "graphqlservice/GraphQLResponse.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace graphql::response {
+
+// CBOR (RFC 8949) and MessagePack are compact binary alternatives to JSON, e.g. for requests
+// between services. Unlike JSON, they keep IdType values with ByteData as binary bytes instead of
+// base64 encoded strings, and parsing them turns those bytes back into an IdType.
+using BinaryData = std::vector<std::uint8_t>;
+
+[[nodiscard("unnecessary conversion")]] GRAPHQLRESPONSE_EXPORT BinaryData toCBOR(
+	Value&& response);
+
+// Append CBOR to the output buffer as it is written, e.g. to pass to Request::resolve. The buffer
+// must outlive the Writer.
+[[nodiscard("unnecessary construction")]] GRAPHQLRESPONSE_EXPORT Writer makeCBORWriter(
+	BinaryData& output);
+
+[[nodiscard("unnecessary conversion")]] GRAPHQLRESPONSE_EXPORT Value parseCBOR(
+	const BinaryData& cbor);
+
+[[nodiscard("unnecessary conversion")]] GRAPHQLRESPONSE_EXPORT BinaryData toMessagePack(
+	Value&& response);
+
+// Append MessagePack to the output buffer as it is written, e.g. to pass to Request::resolve. The
+// buffer must outlive the Writer.
+[[nodiscard("unnecessary construction")]] GRAPHQLRESPONSE_EXPORT Writer makeMessagePackWriter(
+	BinaryData& output);
+
+[[nodiscard("unnecessary conversion")]] GRAPHQLRESPONSE_EXPORT Value parseMessagePack(
+	const BinaryData& msgpack);
+
+} // namespace graphql::response
+
+#endif // BINARYRESPONSE_H
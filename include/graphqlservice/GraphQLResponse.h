@@ -23,6 +23,8 @@
 #include <cstdint>
 #include <initializer_list>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -48,8 +50,10 @@ enum class [[nodiscard("unnecessary conversion")]] Type : std::uint8_t {
 
 struct Value;
 
-using MapType = std::vector<std::pair<std::string, Value>>;
-using ListType = std::vector<Value>;
+// Maps and lists allocate their elements from a std::pmr::memory_resource, so all of them in a
+// single response can share an arena like ValueArena. Otherwise they use the default resource.
+using MapType = std::pmr::vector<std::pair<std::string, Value>>;
+using ListType = std::pmr::vector<Value>;
 using StringType = std::string;
 using BooleanType = bool;
 using IntType = int;
@@ -223,7 +227,10 @@ struct ValueTypeTraits<FloatType>
 // Represent a discriminated union of GraphQL response value types.
 struct [[nodiscard("unnecessary conversion")]] Value
 {
-	GRAPHQLRESPONSE_EXPORT Value(Type type = Type::Null);
+	// Type::Map and Type::List allocate from the resource, which must outlive the Value and
+	// anything its elements are moved into. If it is nullptr they use the default resource.
+	GRAPHQLRESPONSE_EXPORT Value(
+		Type type = Type::Null, std::pmr::memory_resource* resource = nullptr);
 	GRAPHQLRESPONSE_EXPORT ~Value();
 
 	GRAPHQLRESPONSE_EXPORT explicit Value(const char* value);
@@ -296,8 +303,19 @@ private:
 	{
 		[[nodiscard("unnecessary call")]] bool operator==(const MapData& rhs) const;
 
+		// Maps with up to this many members are searched linearly instead of building an index.
+		static constexpr size_t c_linearSearchLimit = 16;
+
+		[[nodiscard("unnecessary call")]] MapType::const_iterator find(
+			std::string_view name) const noexcept;
+		void indexMember(size_t offset) noexcept;
+		void rebuildIndex(size_t count);
+
 		MapType map;
-		std::vector<size_t> members;
+
+		// Open-addressed hash table of 1-based offsets into map, where 0 marks an empty slot. It
+		// stays empty until the map grows past c_linearSearchLimit members.
+		std::pmr::vector<size_t> members;
 	};
 
 	// Type::String
@@ -339,6 +357,28 @@ private:
 	TypeData _data;
 };
 
+// Monotonic arena for the maps and lists in a response, e.g. to pass to Request::resolve for a
+// single request. Deallocation is a no-op, and all of the memory is released at once when the
+// arena is destroyed, so it must outlive every Value which allocated from it. Resolvers may run on
+// multiple threads, so each allocation locks a mutex.
+class [[nodiscard("unnecessary construction")]] ValueArena final : public std::pmr::memory_resource
+{
+public:
+	GRAPHQLRESPONSE_EXPORT explicit ValueArena(size_t initialSize = c_defaultInitialSize);
+	GRAPHQLRESPONSE_EXPORT ~ValueArena() override;
+
+	static constexpr size_t c_defaultInitialSize = 4096;
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	[[nodiscard("unnecessary call")]] bool do_is_equal(
+		const std::pmr::memory_resource& other) const noexcept override;
+
+	std::mutex _mutex;
+	std::pmr::monotonic_buffer_resource _resource;
+};
+
 #ifdef GRAPHQL_DLLEXPORTS
 // Export all of the specialized template methods
 template <>
@@ -391,7 +431,7 @@ private:
 		virtual ~Concept() = default;
 
 		virtual void start_object() const = 0;
-		virtual void add_member(const std::string& key) const = 0;
+		virtual void add_member(std::string_view key) const = 0;
 		virtual void end_object() const = 0;
 
 		virtual void start_array() const = 0;
@@ -399,6 +439,7 @@ private:
 
 		virtual void write_null() const = 0;
 		virtual void write_string(const std::string& value) const = 0;
+		virtual void write_id(IdType&& value) const = 0;
 		virtual void write_bool(bool value) const = 0;
 		virtual void write_int(int value) const = 0;
 		virtual void write_float(double value) const = 0;
@@ -417,7 +458,7 @@ private:
 			_pimpl->start_object();
 		}
 
-		void add_member(const std::string& key) const final
+		void add_member(std::string_view key) const final
 		{
 			_pimpl->add_member(key);
 		}
@@ -447,6 +488,20 @@ private:
 			_pimpl->write_string(value);
 		}
 
+		// Writers for text formats like JSON do not need to implement write_id, they just get
+		// the string value, which is base64 encoded if the ID holds ByteData.
+		void write_id(IdType&& value) const final
+		{
+			if constexpr (requires { _pimpl->write_id(std::move(value)); })
+			{
+				_pimpl->write_id(std::move(value));
+			}
+			else
+			{
+				_pimpl->write_string(value.release<IdType::OpaqueString>());
+			}
+		}
+
 		void write_bool(bool value) const final
 		{
 			_pimpl->write_bool(value);
@@ -477,6 +532,14 @@ public:
 	}
 
 	GRAPHQLRESPONSE_EXPORT void write(Value value) const;
+
+	// Write the members of a map or the elements of a list one at a time, e.g. when streaming them
+	// as they are resolved.
+	GRAPHQLRESPONSE_EXPORT void start_object() const;
+	GRAPHQLRESPONSE_EXPORT void add_member(std::string_view key) const;
+	GRAPHQLRESPONSE_EXPORT void end_object() const;
+	GRAPHQLRESPONSE_EXPORT void start_array() const;
+	GRAPHQLRESPONSE_EXPORT void end_array() const;
 };
 
 } // namespace graphql::response
@@ -25,8 +25,10 @@
 #include "graphqlservice/internal/SortedMap.h"
 #include "graphqlservice/internal/Version.h"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <filesystem>
 #include <functional>
 #include <future>
 #include <list>
@@ -34,12 +36,15 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -122,14 +127,288 @@ private:
 		std::string_view methodName) noexcept;
 };
 
+class BatchLoaderBase;
+
 // The RequestState is nullable, but if you have multiple threads processing requests and there's
 // any per-request state that you want to maintain throughout the request (e.g. optimizing or
 // batching backend requests), you can inherit from RequestState and pass it to Request::resolve to
 // correlate the asynchronous/recursive callbacks and accumulate state in it.
+//
+// The RequestState also schedules any BatchLoader which belongs to the request. The executor holds
+// a BatchScope open while it starts the resolvers for every field in a selection set, or every item
+// in a list, and the pending batches are dispatched when the last BatchScope closes.
 struct [[nodiscard("unnecessary construction")]] RequestState
 	: std::enable_shared_from_this<RequestState>
 {
 	virtual ~RequestState() = default;
+
+	class [[nodiscard("unnecessary construction")]] BatchScope
+	{
+	public:
+		explicit BatchScope(RequestState* state)
+			: _state { state }
+		{
+			if (_state)
+			{
+				_state->beginBatchScope();
+			}
+		}
+
+		BatchScope(const BatchScope&) = delete;
+		BatchScope& operator=(const BatchScope&) = delete;
+
+		~BatchScope()
+		{
+			if (_state)
+			{
+				_state->endBatchScope();
+			}
+		}
+
+	private:
+		RequestState* const _state;
+	};
+
+private:
+	friend class BatchLoaderBase;
+
+	GRAPHQLSERVICE_EXPORT void beginBatchScope();
+	GRAPHQLSERVICE_EXPORT void endBatchScope() noexcept;
+	GRAPHQLSERVICE_EXPORT void enqueueBatch(BatchLoaderBase& loader);
+
+	std::mutex _batchMutex;
+	size_t _batchScopes = 0;
+	std::vector<BatchLoaderBase*> _pendingBatches;
+};
+
+// Type-erased base class of BatchLoader, so the RequestState can dispatch any of them.
+class [[nodiscard("unnecessary construction")]] BatchLoaderBase
+{
+public:
+	virtual ~BatchLoaderBase() = default;
+
+protected:
+	explicit BatchLoaderBase(RequestState& state) noexcept
+		: _state { state }
+	{
+	}
+
+	// Add this loader to the pending batches in the RequestState. If the executor is not starting
+	// any resolvers right now, it is dispatched before this returns.
+	GRAPHQLSERVICE_EXPORT void enqueue();
+
+private:
+	friend struct RequestState;
+
+	virtual void dispatch() noexcept = 0;
+
+	RequestState& _state;
+};
+
+// Collect the keys which sibling resolvers load while the executor is starting them, and call the
+// batch function once with all of them instead of once per key, e.g. when resolving a field on
+// every item in a list. Add it as a member of your RequestState sub-class, and co_await the result
+// of load(key) in a field getter coroutine. The batch function must return one value per key, in
+// the same order. If caching is enabled, loading the same key again later in the request reuses
+// the result of the first batch which loaded it.
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class [[nodiscard("unnecessary construction")]] BatchLoader final : public BatchLoaderBase
+{
+	struct Entry
+	{
+		std::variant<std::monostate, Value, std::exception_ptr> result;
+		std::vector<coro::coroutine_handle<>> waiters;
+	};
+
+	using entry_map = std::map<Key, std::shared_ptr<Entry>, Compare>;
+
+public:
+	using BatchFunction = std::function<std::vector<Value>(std::vector<Key>&& keys)>;
+
+	explicit BatchLoader(RequestState& state, BatchFunction batchFunction, bool cache = true)
+		: BatchLoaderBase { state }
+		, _batchFunction { std::move(batchFunction) }
+		, _cache { cache }
+	{
+	}
+
+	class [[nodiscard("unnecessary construction")]] Awaiter
+	{
+	public:
+		Awaiter(BatchLoader& loader, std::shared_ptr<Entry> entry) noexcept
+			: _loader { loader }
+			, _entry { std::move(entry) }
+		{
+		}
+
+		[[nodiscard("unexpected call")]] bool await_ready() const
+		{
+			std::lock_guard lock { _loader._mutex };
+
+			return _entry->result.index() != 0;
+		}
+
+		[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
+		{
+			std::lock_guard lock { _loader._mutex };
+
+			if (_entry->result.index() != 0)
+			{
+				return false;
+			}
+
+			_entry->waiters.push_back(h);
+
+			return true;
+		}
+
+		[[nodiscard("unnecessary construction")]] Value await_resume() const
+		{
+			if (const auto exception = std::get_if<std::exception_ptr>(&_entry->result))
+			{
+				std::rethrow_exception(*exception);
+			}
+
+			return std::get<Value>(_entry->result);
+		}
+
+	private:
+		BatchLoader& _loader;
+		const std::shared_ptr<Entry> _entry;
+	};
+
+	[[nodiscard("unnecessary call")]] Awaiter load(Key key)
+	{
+		std::unique_lock lock { _mutex };
+		std::shared_ptr<Entry> entry;
+		bool firstKey = false;
+
+		if (auto itr = _cached.find(key); itr != _cached.end())
+		{
+			entry = itr->second;
+		}
+		else if (itr = _pending.find(key); itr != _pending.end())
+		{
+			entry = itr->second;
+		}
+		else
+		{
+			firstKey = _pending.empty();
+			entry = std::make_shared<Entry>();
+			_pending.emplace(std::move(key), entry);
+		}
+
+		lock.unlock();
+
+		if (firstKey)
+		{
+			enqueue();
+		}
+
+		return { *this, std::move(entry) };
+	}
+
+	// Forget the values cached from previous batches.
+	void clear()
+	{
+		std::lock_guard lock { _mutex };
+
+		_cached.clear();
+	}
+
+private:
+	void dispatch() noexcept final
+	{
+		std::unique_lock lock { _mutex };
+		entry_map pending;
+
+		pending.swap(_pending);
+		lock.unlock();
+
+		if (pending.empty())
+		{
+			return;
+		}
+
+		std::vector<Key> keys;
+
+		keys.reserve(pending.size());
+
+		for (const auto& entry : pending)
+		{
+			keys.push_back(entry.first);
+		}
+
+		try
+		{
+			auto values = _batchFunction(std::move(keys));
+
+			if (values.size() != pending.size())
+			{
+				std::ostringstream message;
+
+				message << "BatchLoader function returned: " << values.size()
+						<< " values for: " << pending.size() << " keys";
+
+				throw std::logic_error(message.str());
+			}
+
+			lock.lock();
+
+			auto itr = values.begin();
+
+			for (auto& entry : pending)
+			{
+				entry.second->result.template emplace<Value>(std::move(*itr++));
+			}
+		}
+		catch (...)
+		{
+			const auto exception = std::current_exception();
+
+			if (!lock.owns_lock())
+			{
+				lock.lock();
+			}
+
+			for (auto& entry : pending)
+			{
+				if (entry.second->result.index() == 0)
+				{
+					entry.second->result.template emplace<std::exception_ptr>(exception);
+				}
+			}
+		}
+
+		std::vector<coro::coroutine_handle<>> waiters;
+
+		for (auto& entry : pending)
+		{
+			waiters.insert(waiters.end(),
+				entry.second->waiters.begin(),
+				entry.second->waiters.end());
+			entry.second->waiters.clear();
+		}
+
+		if (_cache)
+		{
+			_cached.merge(pending);
+		}
+
+		lock.unlock();
+
+		for (auto h : waiters)
+		{
+			h.resume();
+		}
+	}
+
+	const BatchFunction _batchFunction;
+	const bool _cache;
+
+	std::mutex _mutex;
+	entry_map _pending;
+	entry_map _cached;
 };
 
 inline namespace keywords {
@@ -146,6 +425,13 @@ constexpr std::string_view strPath { "path"sv };
 constexpr std::string_view strQuery { "query"sv };
 constexpr std::string_view strMutation { "mutation"sv };
 constexpr std::string_view strSubscription { "subscription"sv };
+constexpr std::string_view strDefer { "defer"sv };
+constexpr std::string_view strStream { "stream"sv };
+constexpr std::string_view strIf { "if"sv };
+constexpr std::string_view strLabel { "label"sv };
+constexpr std::string_view strInitialCount { "initialCount"sv };
+constexpr std::string_view strItems { "items"sv };
+constexpr std::string_view strHasNext { "hasNext"sv };
 
 } // namespace keywords
 
@@ -197,6 +483,49 @@ private:
 	std::thread _worker;
 };
 
+// Schedule coroutine execution on a fixed pool of worker threads any time co_await is called from
+// a thread outside of the pool. Each worker owns a bounded lock-free queue, pending coroutines are
+// distributed round-robin between them, and idle workers steal from the other queues before they go
+// to sleep. If every queue is full, or the pool has been shut down, the coroutine resumes inline.
+struct [[nodiscard("unnecessary construction")]] await_worker_pool : coro::suspend_always
+{
+	// Defaults to one worker per hardware thread with room for 1024 pending coroutines per worker.
+	GRAPHQLSERVICE_EXPORT explicit await_worker_pool(size_t workerCount = 0,
+		size_t queueCapacity = 1024);
+	GRAPHQLSERVICE_EXPORT ~await_worker_pool();
+
+	[[nodiscard("unexpected call")]] GRAPHQLSERVICE_EXPORT bool await_ready() const;
+	GRAPHQLSERVICE_EXPORT void await_suspend(coro::coroutine_handle<> h);
+
+	// Number of worker threads in the pool.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT size_t size() const noexcept;
+
+	// Block until every pending coroutine has been resumed and all of the workers are idle.
+	GRAPHQLSERVICE_EXPORT void drain();
+
+	// Drain the pool and join all of the worker threads. Any co_await after this resumes inline.
+	GRAPHQLSERVICE_EXPORT void shutdown();
+
+private:
+	struct WorkerQueue;
+
+	void runWorker(size_t index);
+	[[nodiscard("unnecessary call")]] bool tryPush(coro::coroutine_handle<> h);
+	[[nodiscard("unnecessary call")]] bool tryPop(size_t index, coro::coroutine_handle<>& h);
+	void notifyIdle();
+
+	std::vector<std::unique_ptr<WorkerQueue>> _queues;
+	std::vector<std::thread> _workers;
+	std::atomic_size_t _nextQueue { 0 };
+	std::atomic_size_t _pending { 0 };
+	std::atomic_size_t _active { 0 };
+	std::atomic_size_t _sleeping { 0 };
+	std::atomic_bool _shutdown { false };
+	std::mutex _mutex {};
+	std::condition_variable _wakeWorker {};
+	std::condition_variable _idle {};
+};
+
 // Type-erased awaitable.
 class [[nodiscard("unnecessary construction")]] await_async final
 {
@@ -267,6 +596,86 @@ using Directives = std::vector<std::pair<std::string_view, response::Value>>;
 using FragmentDefinitionDirectiveStack = std::list<std::reference_wrapper<const Directives>>;
 using FragmentSpreadDirectiveStack = std::list<Directives>;
 
+// Payloads for @defer and @stream, which are only used by Request::resolveIncremental.
+class IncrementalPayloads;
+
+// Write the value of a field or list item to a response::Writer in document order. Sibling fields
+// and list items resolve concurrently, so a value which is ready before the ones in front of it is
+// buffered until it is attached, and after that it is written straight through. It also tracks
+// which maps and lists are still open, so a value which fails part way through can be closed.
+class [[nodiscard("unnecessary construction")]] ValueWriter final
+{
+public:
+	GRAPHQLSERVICE_EXPORT ValueWriter() noexcept;
+
+	ValueWriter(const ValueWriter&) = delete;
+	ValueWriter(ValueWriter&&) = delete;
+
+	ValueWriter& operator=(const ValueWriter&) = delete;
+	ValueWriter& operator=(ValueWriter&&) = delete;
+
+	// Write a map or a list one piece at a time, or a complete value. The key is not copied, so it
+	// must outlive the writer, e.g. a field name in the query or a static string.
+	GRAPHQLSERVICE_EXPORT void start_object();
+	GRAPHQLSERVICE_EXPORT void add_member(std::string_view key);
+	GRAPHQLSERVICE_EXPORT void end_object();
+	GRAPHQLSERVICE_EXPORT void start_array();
+	GRAPHQLSERVICE_EXPORT void end_array();
+	GRAPHQLSERVICE_EXPORT void write(response::Value&& value);
+
+	// Flush anything which was buffered, and write straight through from now on.
+	GRAPHQLSERVICE_EXPORT void attach(const response::Writer& output);
+	GRAPHQLSERVICE_EXPORT void attach(ValueWriter& parent);
+
+	// When the resolver is done, write the value it returned if it did not write anything itself,
+	// otherwise close any maps and lists it left open. Anything written after this is ignored.
+	GRAPHQLSERVICE_EXPORT void finish(response::Value&& value);
+
+	// Close any maps and lists which were left open, but don't write a value if there is none.
+	GRAPHQLSERVICE_EXPORT void close();
+
+private:
+	struct StartObject
+	{
+	};
+
+	struct AddMember
+	{
+		std::string_view key;
+	};
+
+	struct EndObject
+	{
+	};
+
+	struct StartArray
+	{
+	};
+
+	struct EndArray
+	{
+	};
+
+	using Token = std::variant<StartObject, AddMember, EndObject, StartArray, EndArray,
+		response::Value>;
+
+	void push(Token&& token);
+	void append(Token&& token);
+	void forward(Token&& token);
+	void closeOpen();
+
+	std::mutex _mutex;
+	const response::Writer* _output = nullptr;
+	ValueWriter* _parent = nullptr;
+	std::vector<Token> _buffer;
+
+	// Each open container is true for a map, or false for a list.
+	std::vector<bool> _open;
+	bool _pendingMember = false;
+	bool _written = false;
+	bool _finished = false;
+};
+
 // Pass a common bundle of parameters to all of the generated Object::getField accessors in a
 // SelectionSet
 struct [[nodiscard("unnecessary construction")]] SelectionSetParams
@@ -291,6 +700,17 @@ struct [[nodiscard("unnecessary construction")]] SelectionSetParams
 
 	// Async launch policy for sub-field resolvers.
 	const await_async launch {};
+
+	// If this is set, @defer and @stream add payloads which are delivered after the initial
+	// response, otherwise the deferred fragments and streamed list items are resolved inline.
+	const std::shared_ptr<IncrementalPayloads> incremental {};
+
+	// Optional arena for the maps and lists in the response.
+	std::pmr::memory_resource* const resource = nullptr;
+
+	// If this is set, the resolvers write the value to it as soon as it is ready, and they leave
+	// the data in the ResolverResult empty.
+	ValueWriter* writer = nullptr;
 };
 
 // Pass a common bundle of parameters to all of the generated Object::getField accessors.
@@ -321,40 +741,13 @@ public:
 	{
 	}
 
-	struct promise_type
+	struct promise_type : internal::TaskPromise<T>
 	{
 		[[nodiscard("unnecessary construction")]] AwaitableScalar<T> get_return_object() noexcept
 		{
-			return { _promise.get_future() };
+			return { internal::Task<T> { coro::coroutine_handle<promise_type>::from_promise(*this),
+				*this } };
 		}
-
-		coro::suspend_never initial_suspend() const noexcept
-		{
-			return {};
-		}
-
-		coro::suspend_never final_suspend() const noexcept
-		{
-			return {};
-		}
-
-		void return_value(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
-		{
-			_promise.set_value(value);
-		}
-
-		void return_value(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
-		{
-			_promise.set_value(std::move(value));
-		}
-
-		void unhandled_exception() noexcept
-		{
-			_promise.set_exception(std::current_exception());
-		}
-
-	private:
-		std::promise<T> _promise;
 	};
 
 	[[nodiscard("unexpected call")]] bool await_ready() const noexcept
@@ -367,6 +760,10 @@ public:
 				{
 					return true;
 				}
+				else if constexpr (std::is_same_v<value_type, internal::Task<T>>)
+				{
+					return value.await_ready();
+				}
 				else if constexpr (std::is_same_v<value_type, std::future<T>>)
 				{
 					using namespace std::literals;
@@ -382,8 +779,13 @@ public:
 			_value);
 	}
 
-	void await_suspend(coro::coroutine_handle<> h) const
+	[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
 	{
+		if (const auto task = std::get_if<internal::Task<T>>(&_value))
+		{
+			return task->await_suspend(h);
+		}
+
 		std::thread(
 			[this](coro::coroutine_handle<> h) noexcept {
 				std::get<std::future<T>>(_value).wait();
@@ -391,6 +793,8 @@ public:
 			},
 			std::move(h))
 			.detach();
+
+		return true;
 	}
 
 	[[nodiscard("unnecessary construction")]] T await_resume()
@@ -403,6 +807,10 @@ public:
 				{
 					return T { std::move(value) };
 				}
+				else if constexpr (std::is_same_v<value_type, internal::Task<T>>)
+				{
+					return value.await_resume();
+				}
 				else if constexpr (std::is_same_v<value_type, std::future<T>>)
 				{
 					return value.get();
@@ -435,7 +843,8 @@ public:
 	}
 
 private:
-	std::variant<T, std::future<T>, std::shared_ptr<const response::Value>> _value;
+	std::variant<T, internal::Task<T>, std::future<T>, std::shared_ptr<const response::Value>>
+		_value;
 };
 
 // Field accessors may return either a result of T, an awaitable of T, or a std::future<T>, so at
@@ -451,40 +860,13 @@ public:
 	{
 	}
 
-	struct promise_type
+	struct promise_type : internal::TaskPromise<T>
 	{
 		[[nodiscard("unnecessary construction")]] AwaitableObject<T> get_return_object() noexcept
 		{
-			return { _promise.get_future() };
+			return { internal::Task<T> { coro::coroutine_handle<promise_type>::from_promise(*this),
+				*this } };
 		}
-
-		coro::suspend_never initial_suspend() const noexcept
-		{
-			return {};
-		}
-
-		coro::suspend_never final_suspend() const noexcept
-		{
-			return {};
-		}
-
-		void return_value(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
-		{
-			_promise.set_value(value);
-		}
-
-		void return_value(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
-		{
-			_promise.set_value(std::move(value));
-		}
-
-		void unhandled_exception() noexcept
-		{
-			_promise.set_exception(std::current_exception());
-		}
-
-	private:
-		std::promise<T> _promise;
 	};
 
 	[[nodiscard("unexpected call")]] bool await_ready() const noexcept
@@ -497,6 +879,10 @@ public:
 				{
 					return true;
 				}
+				else if constexpr (std::is_same_v<value_type, internal::Task<T>>)
+				{
+					return value.await_ready();
+				}
 				else if constexpr (std::is_same_v<value_type, std::future<T>>)
 				{
 					using namespace std::literals;
@@ -507,8 +893,13 @@ public:
 			_value);
 	}
 
-	void await_suspend(coro::coroutine_handle<> h) const
+	[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
 	{
+		if (const auto task = std::get_if<internal::Task<T>>(&_value))
+		{
+			return task->await_suspend(h);
+		}
+
 		std::thread(
 			[this](coro::coroutine_handle<> h) noexcept {
 				std::get<std::future<T>>(_value).wait();
@@ -516,6 +907,8 @@ public:
 			},
 			std::move(h))
 			.detach();
+
+		return true;
 	}
 
 	[[nodiscard("unnecessary construction")]] T await_resume()
@@ -528,6 +921,10 @@ public:
 				{
 					return T { std::move(value) };
 				}
+				else if constexpr (std::is_same_v<value_type, internal::Task<T>>)
+				{
+					return value.await_resume();
+				}
 				else if constexpr (std::is_same_v<value_type, std::future<T>>)
 				{
 					return value.get();
@@ -537,7 +934,7 @@ public:
 	}
 
 private:
-	std::variant<T, std::future<T>> _value;
+	std::variant<T, internal::Task<T>, std::future<T>> _value;
 };
 
 // Fragments are referenced by name and have a single type condition (except for inline
@@ -563,6 +960,9 @@ private:
 // the request document by name.
 using FragmentMap = internal::string_view_map<Fragment>;
 
+// Compiled selection set from a PreparedOperation, which is only visible in GraphQLService.cpp.
+struct PreparedSelectionSet;
+
 // Resolver functors take a set of arguments encoded as members on a JSON object
 // with an optional selection set for complex types and return a JSON value for
 // a single field.
@@ -571,7 +971,7 @@ struct [[nodiscard("unnecessary construction")]] ResolverParams : SelectionSetPa
 	GRAPHQLSERVICE_EXPORT explicit ResolverParams(const SelectionSetParams& selectionSetParams,
 		const peg::ast_node& field, std::string&& fieldName, response::Value arguments,
 		Directives fieldDirectives, const peg::ast_node* selection, const FragmentMap& fragments,
-		const response::Value& variables);
+		const response::Value& variables, const PreparedSelectionSet* preparedSelection = nullptr);
 
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT schema_location getLocation() const;
 
@@ -586,6 +986,10 @@ struct [[nodiscard("unnecessary construction")]] ResolverParams : SelectionSetPa
 	// resolvers recursively through ResolverParams.
 	const FragmentMap& fragments;
 	const response::Value& variables;
+
+	// If the operation was compiled with Request::prepare, this is the compiled version of the
+	// selection set, otherwise it is nullptr.
+	const PreparedSelectionSet* preparedSelection;
 };
 
 // Propagate data and errors together without bundling them into a response::Value struct until
@@ -597,7 +1001,59 @@ struct [[nodiscard("unnecessary construction")]] ResolverResult
 };
 
 using AwaitableResolver = internal::Awaitable<ResolverResult>;
-using Resolver = std::function<AwaitableResolver(ResolverParams&&)>;
+
+// Queue of the @defer and @stream payloads for Request::resolveIncremental. Every payload in the
+// queue is started at the same time, and each of them is delivered as soon as it completes. A
+// payload adds the payloads for nested @defer or @stream directives to its own queue, and they are
+// not started until it has been delivered, so a payload is always delivered after the payload
+// which contains its path.
+class [[nodiscard("unnecessary construction")]] IncrementalPayloads
+{
+public:
+	// The frames which built the original error path are gone by the time a payload is started,
+	// so the errorPath is rebuilt from the path of the payload. The nested payloads are added to
+	// the incremental queue which is passed in with it.
+	using StartPayload = std::function<AwaitableResolver(
+		std::optional<field_path> errorPath, std::shared_ptr<IncrementalPayloads> incremental)>;
+
+	struct Payload
+	{
+		// Path to the deferred fragment's Object, or to the streamed list item.
+		error_path path;
+		std::optional<std::string> label;
+
+		// Streamed list items are delivered in an "items" list instead of "data".
+		bool items = false;
+		StartPayload start;
+	};
+
+	// Arguments of an @defer or @stream directive which is not disabled with `if: false`.
+	struct Directive
+	{
+		std::optional<std::string> label;
+		size_t initialCount = 0;
+	};
+
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT static std::optional<Directive>
+	findDirective(std::string_view name, const Directives& directives);
+
+	GRAPHQLSERVICE_EXPORT void push(Payload&& payload);
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT std::optional<Payload> pop();
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT bool empty() const;
+
+	// The payloads may refer back to this queue, so clear it if they won't all be delivered.
+	GRAPHQLSERVICE_EXPORT void clear();
+
+private:
+	mutable std::mutex _mutex;
+	std::list<Payload> _payloads;
+};
+
+class Object;
+
+// Resolvers are plain function pointers which receive the Object that implements the field, so
+// every instance of a generated type can share a single static and immutable ResolverMap.
+using Resolver = AwaitableResolver (*)(const Object& object, ResolverParams&& params);
 using ResolverMap = internal::string_view_map<Resolver>;
 
 // GraphQL types are nullable by default, but they may be wrapped with non-null or list types.
@@ -876,12 +1332,27 @@ using TypeNames = internal::string_view_set;
 class [[nodiscard("unnecessary construction")]] Object : public std::enable_shared_from_this<Object>
 {
 public:
-	GRAPHQLSERVICE_EXPORT explicit Object(TypeNames&& typeNames, ResolverMap&& resolvers) noexcept;
+	// The typeNames and resolvers are borrowed, generated types pass static tables which outlive
+	// every instance. Interface and union types pass the tables from the implementation Object,
+	// along with a pointer to that Object, which is what the resolvers will receive.
+	GRAPHQLSERVICE_EXPORT explicit Object(const TypeNames& typeNames, const ResolverMap& resolvers,
+		const Object* implementation = nullptr) noexcept;
+
+	// Temporary tables would be destroyed before the Object which borrows them.
+	explicit Object(TypeNames&& typeNames, const ResolverMap& resolvers,
+		const Object* implementation = nullptr) = delete;
+	explicit Object(const TypeNames& typeNames, ResolverMap&& resolvers,
+		const Object* implementation = nullptr) = delete;
+	explicit Object(TypeNames&& typeNames, ResolverMap&& resolvers,
+		const Object* implementation = nullptr) = delete;
 	GRAPHQLSERVICE_EXPORT virtual ~Object() = default;
 
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT AwaitableResolver resolve(
 		const SelectionSetParams& selectionSetParams, const peg::ast_node& selection,
 		const FragmentMap& fragments, const response::Value& variables) const;
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT AwaitableResolver resolve(
+		const SelectionSetParams& selectionSetParams, const PreparedSelectionSet& selection,
+		const FragmentMap& fragments, const response::Value& variables) const;
 
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT bool matchesType(
 		std::string_view typeName) const;
@@ -899,8 +1370,14 @@ protected:
 	mutable std::mutex _resolverMutex {};
 
 private:
-	TypeNames _typeNames;
-	ResolverMap _resolvers;
+	[[nodiscard("unnecessary call")]] AwaitableResolver resolveSelectionSet(
+		const SelectionSetParams& selectionSetParams, const peg::ast_node* selection,
+		const PreparedSelectionSet* preparedSelection, const FragmentMap& fragments,
+		const response::Value& variables) const;
+
+	const TypeNames& _typeNames;
+	const ResolverMap& _resolvers;
+	const Object& _implementation;
 };
 
 // Test if this Type inherits from Object.
@@ -995,6 +1472,19 @@ template <typename Type, TypeModifier Modifier, TypeModifier... Other>
 concept NullableResultOptional =
 	NullableModifier<Modifier> && !(OnlyNoneModifiers<Other...> && ObjectBaseType<Type>);
 
+// Test if this Type is one of the built-in scalar types which map directly to a response::Value.
+template <typename Type>
+concept BuiltinScalarType = std::is_same_v<Type, int> || std::is_same_v<Type, double>
+	|| std::is_same_v<Type, bool> || std::is_same_v<Type, std::string>
+	|| std::is_same_v<Type, response::IdType>;
+
+// Test if the items in a list are built-in scalars, either non-nullable or with a single nullable
+// modifier, so the list can be converted in a single pass.
+template <typename Type, TypeModifier... Other>
+concept BuiltinScalarListItems = BuiltinScalarType<Type>
+	&& (OnlyNoneModifiers<Other...>
+		|| (sizeof...(Other) == 1 && (... && NullableModifier<Other>)));
+
 // Convert the result of a resolver function with chained type modifiers that add nullable or
 // list wrappers. This is the inverse of ModifiedArgument for output types instead of input types.
 template <typename Type>
@@ -1155,50 +1645,183 @@ struct ModifiedResult
 
 		auto awaitedResult = co_await std::move(result);
 
+		using vector_type = std::decay_t<decltype(awaitedResult)>;
+
+		// With @stream, only the first initialCount items are part of this result, the rest of
+		// them are resolved and delivered one at a time in later payloads.
+		const auto stream = params.incremental
+			? IncrementalPayloads::findDirective(strStream, params.fieldDirectives)
+			: std::nullopt;
+
+		if (stream && awaitedResult.size() > stream->initialCount)
+		{
+			const auto offset = static_cast<std::ptrdiff_t>(stream->initialCount);
+			auto streamed = std::make_shared<vector_type>(
+				std::make_move_iterator(awaitedResult.begin() + offset),
+				std::make_move_iterator(awaitedResult.end()));
+			auto path = buildErrorPath(parentPath);
+
+			awaitedResult.erase(awaitedResult.begin() + offset, awaitedResult.end());
+			path.push_back(size_t { 0 });
+
+			for (size_t i = 0; i < streamed->size(); ++i)
+			{
+				std::get<size_t>(path.back()) = stream->initialCount + i;
+				params.incremental->push({ path,
+					stream->label,
+					true,
+					[streamed, i, itemParams = ResolverParams(params)](
+						std::optional<field_path> errorPath,
+						std::shared_ptr<IncrementalPayloads> incremental) mutable {
+						typename vector_type::value_type entry = std::move((*streamed)[i]);
+
+						return ModifiedResult::convert<Other...>(std::move(entry),
+							ResolverParams { SelectionSetParams {
+												 itemParams.resolverContext,
+												 itemParams.state,
+												 itemParams.operationDirectives,
+												 itemParams.fragmentDefinitionDirectives,
+												 itemParams.fragmentSpreadDirectives,
+												 itemParams.inlineFragmentDirectives,
+												 std::move(errorPath),
+												 itemParams.launch,
+												 std::move(incremental),
+												 itemParams.resource,
+											 },
+								itemParams.field,
+								std::move(itemParams.fieldName),
+								std::move(itemParams.arguments),
+								std::move(itemParams.fieldDirectives),
+								itemParams.selection,
+								itemParams.fragments,
+								itemParams.variables,
+								itemParams.preparedSelection });
+					} });
+			}
+		}
+
+		if constexpr (BuiltinScalarListItems<Type, Other...>)
+		{
+			if (params.selection == nullptr)
+			{
+				// Built-in scalar items don't need a coroutine and a copy of the ResolverParams
+				// for each item, so build the whole list in a single pass.
+				ResolverResult document { response::Value { response::Type::List,
+					params.resource } };
+
+				document.data.reserve(awaitedResult.size());
+
+				for (auto&& entry : awaitedResult)
+				{
+					if constexpr (OnlyNoneModifiers<Other...>)
+					{
+						document.data.emplace_back(response::Value { Type { std::move(entry) } });
+					}
+					else if (entry)
+					{
+						document.data.emplace_back(response::Value { Type { std::move(*entry) } });
+					}
+					else
+					{
+						document.data.emplace_back(response::Value {});
+					}
+				}
+
+				co_return document;
+			}
+		}
+
+		// With a writer, each item writes its value as soon as it and the items in front of it
+		// are resolved, instead of building the whole list.
+		const auto writer = params.writer;
+		std::unique_ptr<ValueWriter[]> itemWriters;
+
+		if (writer)
+		{
+			itemWriters = std::make_unique<ValueWriter[]>(awaitedResult.size());
+		}
+
 		children.reserve(awaitedResult.size());
 		params.errorPath = std::make_optional(
 			field_path { parentPath ? std::make_optional(std::cref(*parentPath)) : std::nullopt,
 				path_segment { size_t { 0 } } });
 
-		using vector_type = std::decay_t<decltype(awaitedResult)>;
-
-		if constexpr (!std::is_same_v<std::decay_t<typename vector_type::reference>,
-						  typename vector_type::value_type>)
 		{
-			// Special handling for std::vector<> specializations which don't return a
-			// reference to the underlying type, i.e. std::vector<bool> on many platforms.
-			// Copy the values from the std::vector<> rather than moving them.
-			for (typename vector_type::value_type entry : awaitedResult)
+			// Start every item in the list before dispatching the batches they loaded.
+			const RequestState::BatchScope batchScope { params.state.get() };
+
+			if constexpr (!std::is_same_v<std::decay_t<typename vector_type::reference>,
+							  typename vector_type::value_type>)
 			{
-				children.push_back(
-					ModifiedResult::convert<Other...>(std::move(entry), ResolverParams(params)));
-				++std::get<size_t>(params.errorPath->segment);
+				// Special handling for std::vector<> specializations which don't return a
+				// reference to the underlying type, i.e. std::vector<bool> on many platforms.
+				// Copy the values from the std::vector<> rather than moving them.
+				for (typename vector_type::value_type entry : awaitedResult)
+				{
+					if (writer)
+					{
+						params.writer = &itemWriters[children.size()];
+					}
+
+					children.push_back(ModifiedResult::convert<Other...>(std::move(entry),
+						ResolverParams(params)));
+					++std::get<size_t>(params.errorPath->segment);
+				}
 			}
-		}
-		else
-		{
-			for (auto& entry : awaitedResult)
+			else
 			{
-				children.push_back(
-					ModifiedResult::convert<Other...>(std::move(entry), ResolverParams(params)));
-				++std::get<size_t>(params.errorPath->segment);
+				for (auto& entry : awaitedResult)
+				{
+					if (writer)
+					{
+						params.writer = &itemWriters[children.size()];
+					}
+
+					children.push_back(ModifiedResult::convert<Other...>(std::move(entry),
+						ResolverParams(params)));
+					++std::get<size_t>(params.errorPath->segment);
+				}
 			}
 		}
 
-		ResolverResult document { response::Value { response::Type::List } };
+		ResolverResult document { writer
+				? response::Value {}
+				: response::Value { response::Type::List, params.resource } };
+
+		if (writer)
+		{
+			writer->start_array();
+		}
+		else
+		{
+			document.data.reserve(children.size());
+		}
 
-		document.data.reserve(children.size());
 		std::get<size_t>(params.errorPath->segment) = 0;
 
-		for (auto& child : children)
+		for (size_t i = 0; i < children.size(); ++i)
 		{
+			auto& child = children[i];
+
 			try
 			{
 				co_await params.launch;
 
+				if (writer)
+				{
+					itemWriters[i].attach(*writer);
+				}
+
 				auto value = co_await std::move(child);
 
-				document.data.emplace_back(std::move(value.data));
+				if (writer)
+				{
+					itemWriters[i].finish(std::move(value.data));
+				}
+				else
+				{
+					document.data.emplace_back(std::move(value.data));
+				}
 
 				if (!value.errors.empty())
 				{
@@ -1213,6 +1836,11 @@ struct ModifiedResult
 				{
 					document.errors.splice(document.errors.end(), errors);
 				}
+
+				if (writer)
+				{
+					itemWriters[i].close();
+				}
 			}
 			catch (const std::exception& ex)
 			{
@@ -1224,11 +1852,21 @@ struct ModifiedResult
 				document.errors.emplace_back(schema_error { message.str(),
 					params.getLocation(),
 					buildErrorPath(params.errorPath) });
+
+				if (writer)
+				{
+					itemWriters[i].close();
+				}
 			}
 
 			++std::get<size_t>(params.errorPath->segment);
 		}
 
+		if (writer)
+		{
+			writer->end_array();
+		}
+
 		co_return document;
 	}
 
@@ -1346,6 +1984,10 @@ using SubscriptionName = std::string;
 using AwaitableSubscribe = internal::Awaitable<SubscriptionKey>;
 using AwaitableUnsubscribe = internal::Awaitable<void>;
 using AwaitableDeliver = internal::Awaitable<void>;
+using AwaitableStream = internal::Awaitable<void>;
+
+// Receives the initial response and then each of the @defer and @stream payloads.
+using IncrementalCallback = std::function<void(response::Value&& payload)>;
 
 struct [[nodiscard("unnecessary construction")]] RequestResolveParams
 {
@@ -1359,6 +2001,135 @@ struct [[nodiscard("unnecessary construction")]] RequestResolveParams
 
 	// Optional sub-class of RequestState which will be passed to each resolver and field accessor.
 	std::shared_ptr<RequestState> state {};
+
+	// Optional arena for the maps and lists in the response, e.g. a response::ValueArena, which
+	// must outlive the response.
+	std::pmr::memory_resource* resource = nullptr;
+};
+
+struct [[nodiscard("unnecessary construction")]] RequestQueryParams
+{
+	// Required query text, which is parsed and validated once and then cached by the Request.
+	std::string_view query;
+	std::string_view operationName {};
+	response::Value variables { response::Type::Map };
+
+	// Optional async execution awaitable.
+	await_async launch {};
+
+	// Optional sub-class of RequestState which will be passed to each resolver and field accessor.
+	std::shared_ptr<RequestState> state {};
+
+	// Optional arena for the maps and lists in the response, e.g. a response::ValueArena, which
+	// must outlive the response.
+	std::pmr::memory_resource* resource = nullptr;
+};
+
+struct [[nodiscard("unnecessary construction")]] RequestPersistedParams
+{
+	// Required hex encoded SHA-256 hash of the query text.
+	std::string_view hash;
+
+	// Optional query text, which the client only needs to send if the Request does not recognize
+	// the hash yet. It must match the hash, and then it is registered for the next request.
+	std::string_view query {};
+	std::string_view operationName {};
+	response::Value variables { response::Type::Map };
+
+	// Optional async execution awaitable.
+	await_async launch {};
+
+	// Optional sub-class of RequestState which will be passed to each resolver and field accessor.
+	std::shared_ptr<RequestState> state {};
+
+	// Optional arena for the maps and lists in the response, e.g. a response::ValueArena, which
+	// must outlive the response.
+	std::pmr::memory_resource* resource = nullptr;
+};
+
+// Bounded LRU cache of parsed and validated query documents, keyed by a hash of the query text
+// without the insignificant whitespace, commas, and comments. The entries are split between
+// shards, each with its own mutex and LRU list, so lookups on different threads rarely contend.
+class [[nodiscard("unnecessary construction")]] DocumentCache
+{
+public:
+	static constexpr size_t c_defaultCapacity = 1024;
+	static constexpr size_t c_defaultShardCount = 16;
+
+	struct [[nodiscard("unnecessary construction")]] Statistics
+	{
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t size = 0;
+	};
+
+	GRAPHQLSERVICE_EXPORT explicit DocumentCache(
+		size_t capacity = c_defaultCapacity, size_t shardCount = c_defaultShardCount);
+	GRAPHQLSERVICE_EXPORT ~DocumentCache();
+
+	DocumentCache(const DocumentCache&) = delete;
+	DocumentCache& operator=(const DocumentCache&) = delete;
+
+	// Returns an empty std::shared_ptr if the query is not in the cache. The document was parsed
+	// from the first text inserted with the same key, so the locations of its nodes only refer to
+	// this query if sameText is set to true. The cache only keeps a hash of that text, so sameText
+	// compares the hashes.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT std::shared_ptr<const peg::ast> find(
+		std::string_view query, bool* sameText = nullptr);
+
+	// If another thread already inserted the same query, this returns the existing document.
+	GRAPHQLSERVICE_EXPORT std::shared_ptr<const peg::ast> insert(
+		std::string_view query, std::shared_ptr<const peg::ast> document);
+
+	// Change the total capacity, evicting the least recently used documents if it shrinks.
+	GRAPHQLSERVICE_EXPORT void setCapacity(size_t capacity);
+	GRAPHQLSERVICE_EXPORT void clear() noexcept;
+
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT Statistics getStatistics()
+		const noexcept;
+
+	// Remove the ignored tokens between the lexical tokens, except for a single space where it is
+	// needed to keep them apart.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT static std::string normalize(
+		std::string_view query);
+
+private:
+	struct Shard;
+
+	[[nodiscard("unnecessary call")]] Shard& getShard(size_t hash) const noexcept;
+
+	const size_t _shardCount;
+	const std::unique_ptr<Shard[]> _shards;
+
+	std::atomic_size_t _hits = 0;
+	std::atomic_size_t _misses = 0;
+	std::atomic_size_t _evictions = 0;
+	std::atomic_size_t _size = 0;
+};
+
+// Execution plan compiled by Request::prepare, which is only visible in GraphQLService.cpp.
+struct PreparedOperation;
+
+// Validated document and fragments shared by the subscriptions on the same AST, which is only
+// visible in GraphQLService.cpp.
+struct SubscriptionDocument;
+
+struct [[nodiscard("unnecessary construction")]] RequestPreparedParams
+{
+	// Required execution plan from Request::prepare.
+	std::shared_ptr<const PreparedOperation> operation;
+	response::Value variables { response::Type::Map };
+
+	// Optional async execution awaitable.
+	await_async launch {};
+
+	// Optional sub-class of RequestState which will be passed to each resolver and field accessor.
+	std::shared_ptr<RequestState> state {};
+
+	// Optional arena for the maps and lists in the response, e.g. a response::ValueArena, which
+	// must outlive the response.
+	std::pmr::memory_resource* resource = nullptr;
 };
 
 struct [[nodiscard("unnecessary construction")]] RequestSubscribeParams
@@ -1366,7 +2137,7 @@ struct [[nodiscard("unnecessary construction")]] RequestSubscribeParams
 	// Callback which receives the event data.
 	SubscriptionCallback callback;
 
-	// Required query information.
+	// Required query information, unless there is a shared document.
 	peg::ast query;
 	std::string operationName {};
 	response::Value variables { response::Type::Map };
@@ -1379,6 +2150,11 @@ struct [[nodiscard("unnecessary construction")]] RequestSubscribeParams
 
 	// Optional override for the default Subscription operation object.
 	std::shared_ptr<const Object> subscriptionObject {};
+
+	// Optional parsed document, e.g. from getDocumentCache, which is used instead of the query.
+	// Subscriptions on the same document share the AST, the validation result, and the fragment
+	// definitions, so they only keep their own variables and state.
+	std::shared_ptr<const peg::ast> document {};
 };
 
 struct [[nodiscard("unnecessary construction")]] RequestUnsubscribeParams
@@ -1413,6 +2189,18 @@ struct [[nodiscard("unnecessary construction")]] SubscriptionFilter
 // and directives in the Subscription query.
 using RequestDeliverFilter = std::optional<std::variant<SubscriptionKey, SubscriptionFilter>>;
 
+// Order in which Request::deliver invokes the subscription callbacks.
+enum class [[nodiscard("unnecessary conversion")]] DeliverOrder {
+	// Invoke the callbacks one at a time on the delivering coroutine, in the order that the
+	// subscriptions were registered. With RequestDeliverParams::deduplicate, each group is in the
+	// position of its first subscription, and the rest of the group is invoked along with it.
+	Registration,
+
+	// Invoke each callback as soon as its subscription is resolved. With an async launch
+	// awaitable, the callbacks may run on different threads at the same time.
+	Completion,
+};
+
 struct [[nodiscard("unnecessary construction")]] RequestDeliverParams
 {
 	// Deliver to subscriptions on this field.
@@ -1427,6 +2215,18 @@ struct [[nodiscard("unnecessary construction")]] RequestDeliverParams
 
 	// Optional override for the default Subscription operation object.
 	std::shared_ptr<const Object> subscriptionObject {};
+
+	// Optional limit on how many subscriptions resolve the event at the same time with the launch
+	// awaitable. The default of 1 resolves them one at a time, and 0 means there is no limit.
+	size_t maxConcurrency = 1;
+
+	// Optional order for the callbacks when more than one subscription resolves at a time.
+	DeliverOrder order = DeliverOrder::Registration;
+
+	// Optionally resolve the event once for each group of subscriptions with the same normalized
+	// document, operation name, variables, and RequestState, and share the result between their
+	// callbacks.
+	bool deduplicate = false;
 };
 
 using TypeMap = internal::string_view_map<std::shared_ptr<const Object>>;
@@ -1441,12 +2241,15 @@ struct [[nodiscard("unnecessary construction")]] OperationData
 	: std::enable_shared_from_this<OperationData>
 {
 	explicit OperationData(std::shared_ptr<RequestState> state, response::Value variables,
-		Directives directives, FragmentMap fragments);
+		Directives directives, std::shared_ptr<const FragmentMap> fragments);
 
 	std::shared_ptr<RequestState> state;
 	response::Value variables;
 	Directives directives;
-	FragmentMap fragments;
+
+	// Subscriptions on the same document share the fragments, unless any of the fragment
+	// definition directives reference variables.
+	std::shared_ptr<const FragmentMap> fragments;
 };
 
 // Registration information for subscription, cached in the Request::subscribe call.
@@ -1454,7 +2257,8 @@ struct [[nodiscard("unnecessary construction")]] SubscriptionData
 	: std::enable_shared_from_this<SubscriptionData>
 {
 	explicit SubscriptionData(std::shared_ptr<OperationData> data, SubscriptionName&& field,
-		response::Value arguments, Directives fieldDirectives, peg::ast&& query,
+		response::Value arguments, Directives fieldDirectives,
+		std::shared_ptr<const peg::ast> query, std::string_view normalizedQuery,
 		std::string&& operationName, SubscriptionCallback&& callback,
 		const peg::ast_node& selection);
 
@@ -1463,10 +2267,85 @@ struct [[nodiscard("unnecessary construction")]] SubscriptionData
 	SubscriptionName field;
 	response::Value arguments;
 	Directives fieldDirectives;
-	peg::ast query;
+	std::shared_ptr<const peg::ast> query;
+
+	// Text of the document with the ignored tokens removed, as in DocumentCache::normalize. It is
+	// owned by the shared document which the query keeps alive.
+	std::string_view normalizedQuery;
+
 	std::string operationName;
 	SubscriptionCallback callback;
 	const peg::ast_node& selection;
+
+	// Hash of the operation name and the normalized document, which Request::deliver uses to
+	// group identical subscriptions.
+	size_t fingerprint;
+};
+
+// Secondary index on the values of some of the arguments for a subscription field, which is
+// declared with Request::indexSubscriptionArguments. It is safe to use from multiple threads.
+class [[nodiscard("unnecessary construction")]] SubscriptionArgumentIndex
+{
+public:
+	explicit SubscriptionArgumentIndex(std::vector<std::string> argumentNames) noexcept;
+
+	void add(SubscriptionKey key, const SubscriptionData& registration);
+	void remove(SubscriptionKey key, const SubscriptionData& registration);
+
+	// Returns the sorted keys of the subscriptions which might match the required arguments, or
+	// std::nullopt if they do not include all of the indexed arguments.
+	[[nodiscard("unnecessary call")]] std::optional<std::vector<SubscriptionKey>> find(
+		const SubscriptionArguments& arguments) const;
+
+private:
+	const std::vector<std::string> _argumentNames;
+
+	// Subscriptions are indexed by a hash of the values for every indexed argument, and any which
+	// leave out one of the indexed arguments match every value. The keys are only sorted in find.
+	mutable std::mutex _mutex {};
+	std::unordered_multimap<size_t, SubscriptionKey> _keys;
+	std::unordered_set<SubscriptionKey> _unindexed;
+};
+
+// Concurrent registry of the active subscriptions for a Request. The subscriptions are sharded by
+// key, so adding or removing one only locks a single shard. Each shard keeps the subscriptions on
+// a field sorted by key, which is usually an insert at the end since keys increase monotonically
+// and they are never reused.
+class [[nodiscard("unnecessary construction")]] SubscriptionRegistry
+{
+public:
+	static constexpr size_t c_defaultShardCount = 16;
+
+	explicit SubscriptionRegistry(size_t shardCount = c_defaultShardCount);
+	~SubscriptionRegistry();
+
+	SubscriptionRegistry(const SubscriptionRegistry&) = delete;
+	SubscriptionRegistry& operator=(const SubscriptionRegistry&) = delete;
+
+	[[nodiscard("leaked subscription")]] SubscriptionKey add(
+		std::shared_ptr<const SubscriptionData> registration);
+
+	// Returns an empty std::shared_ptr if the key is not registered.
+	std::shared_ptr<const SubscriptionData> remove(SubscriptionKey key);
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const SubscriptionData> find(
+		SubscriptionKey key) const;
+
+	// Copy the subscriptions on a field, sorted by key. Each shard is only locked while its own
+	// subscriptions are copied, so delivering an event never holds up subscribe or unsubscribe
+	// while it resolves the subscriptions. The shards are already sorted, so they are merged
+	// instead of sorting the whole copy.
+	[[nodiscard("unnecessary call")]] std::vector<
+		std::pair<SubscriptionKey, std::shared_ptr<const SubscriptionData>>>
+	snapshot(std::string_view field) const;
+
+private:
+	struct Shard;
+
+	[[nodiscard("unnecessary call")]] Shard& getShard(SubscriptionKey key) const noexcept;
+
+	const size_t _shardCount;
+	const std::unique_ptr<Shard[]> _shards;
+	std::atomic<SubscriptionKey> _nextKey = 0;
 };
 
 // Placeholder for an empty subscription object.
@@ -1476,8 +2355,21 @@ class SubscriptionPlaceholder
 	SubscriptionPlaceholder() noexcept = default;
 };
 
+// Static cost analysis budget for Request::validate. Each field costs the weight in its @cost
+// directive, or 1 if there is none, plus the cost of its selection set multiplied by the largest
+// value passed to one of the pagination arguments listed in the @cost multipliers.
+struct [[nodiscard("unnecessary construction")]] RequestCostLimit
+{
+	// Reject any operation which costs more than this before resolving it, or 0 for no limit.
+	size_t maxCost = 0;
+
+	// Variable values are not known until the operation is resolved, so this is the multiplier
+	// for a pagination argument which is passed as a variable.
+	size_t variableMultiplier = 100;
+};
+
 // Forward declare just the class type so we can reference it in the Request::_validation member.
-class ValidateExecutableVisitor;
+class ValidateSchema;
 
 // Request scans the fragment definitions and finds the right operation definition to interpret
 // depending on the operation name (which might be empty for a single-operation document). It
@@ -1498,8 +2390,27 @@ public:
 		const peg::ast_node*>
 	findOperationDefinition(peg::ast& query, std::string_view operationName) const;
 
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT std::shared_ptr<const PreparedOperation>
+	prepare(peg::ast query, std::string_view operationName = {}) const;
+
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT response::AwaitableValue resolve(
 		RequestResolveParams params) const;
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT response::AwaitableValue resolve(
+		RequestPreparedParams params) const;
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT response::AwaitableValue resolve(
+		RequestQueryParams params) const;
+
+	// Stream the response to the writer instead of returning it. Each field or list item at any
+	// depth is written as soon as it and the ones before it are resolved, so later siblings which
+	// finish first are the only ones which need to be buffered.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT AwaitableStream resolve(
+		RequestResolveParams params, response::Writer writer) const;
+
+	// Deliver the initial response without any @defer fragments or @stream list items after the
+	// initialCount, and then deliver each of those in a separate payload. Every payload includes
+	// hasNext, which is false in the last one.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT AwaitableStream resolveIncremental(
+		RequestResolveParams params, IncrementalCallback callback) const;
 	[[nodiscard("leaked subscription")]] GRAPHQLSERVICE_EXPORT AwaitableSubscribe subscribe(
 		RequestSubscribeParams params);
 	[[nodiscard("potentially leaked subscription")]] GRAPHQLSERVICE_EXPORT AwaitableUnsubscribe
@@ -1507,20 +2418,86 @@ public:
 	[[nodiscard("potentially leaked event")]] GRAPHQLSERVICE_EXPORT AwaitableDeliver deliver(
 		RequestDeliverParams params) const;
 
+	// Parsed and validated documents for the resolve overload which takes the query text.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT DocumentCache& getDocumentCache()
+		const noexcept;
+
+	// Change the cost analysis budget for documents which have not been validated yet. This
+	// clears the document caches, but persisted queries registered ahead of time are not
+	// validated again. Call it before any requests are resolved concurrently, since a document
+	// validated on another thread with the previous limit may be cached after it is cleared.
+	GRAPHQLSERVICE_EXPORT void setCostLimit(RequestCostLimit costLimit) noexcept;
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT RequestCostLimit getCostLimit()
+		const noexcept;
+
+	// Resolve a persisted query by the hash of its text, which is registered either ahead of time
+	// with registerPersistedQuery or by a client sending the query text along with the hash.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT response::AwaitableValue
+	resolvePersisted(RequestPersistedParams params) const;
+
+	// Parse and validate the query text, and register it for resolvePersisted. This returns the
+	// hex encoded SHA-256 hash, or throws a schema_exception with any errors.
+	GRAPHQLSERVICE_EXPORT std::string registerPersistedQuery(std::string_view query);
+
+	// Register every .graphql file in a directory, e.g. at startup, and return how many there were.
+	GRAPHQLSERVICE_EXPORT size_t registerPersistedQueries(const std::filesystem::path& directory);
+
+	// Returns an empty std::shared_ptr if the hash was never registered, or if it was registered by
+	// a client and has since been evicted from the cache of persisted queries.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT std::shared_ptr<const peg::ast>
+	findPersistedQuery(std::string_view hash) const;
+
+	// Persisted queries registered by clients sending the query text with the hash. The ones
+	// registered with registerPersistedQuery are kept separately and never evicted.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT DocumentCache& getPersistedQueryCache()
+		const noexcept;
+
+	// Index the subscriptions on a field by the values of some of their arguments, e.g. a chat
+	// room ID, so deliver with a SubscriptionArguments filter which includes all of them only
+	// checks the subscriptions with matching values. This replaces any previous index on the field.
+	GRAPHQLSERVICE_EXPORT void indexSubscriptionArguments(
+		std::string_view field, std::vector<std::string> argumentNames);
+
 private:
-	[[nodiscard("leaked subscription")]] SubscriptionKey addSubscription(
-		RequestSubscribeParams&& params);
+	[[nodiscard("unnecessary call")]] static std::pair<std::string_view, const peg::ast_node*>
+	findValidatedOperationDefinition(const peg::ast& query, std::string_view operationName);
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const peg::ast> loadDocument(
+		std::string_view query) const;
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const peg::ast> parseDocument(
+		std::string_view query, bool validated = false) const;
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const peg::ast> loadPersistedQuery(
+		std::string_view hash, std::string_view query) const;
+	[[nodiscard("unnecessary call")]] response::AwaitableValue resolveValidated(
+		const peg::ast& query, std::string_view operationName, response::Value variables,
+		await_async launch, std::shared_ptr<RequestState> state,
+		std::pmr::memory_resource* resource, const response::Writer* writer = nullptr,
+		const IncrementalCallback* callback = nullptr) const;
+
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const SubscriptionDocument>
+	loadSubscriptionDocument(RequestSubscribeParams& params);
+	[[nodiscard("leaked subscription")]] std::pair<SubscriptionKey,
+		std::shared_ptr<const SubscriptionData>>
+	addSubscription(RequestSubscribeParams&& params);
 	void removeSubscription(SubscriptionKey key);
 	[[nodiscard("unnecessary call")]] std::vector<std::shared_ptr<const SubscriptionData>>
 	collectRegistrations(std::string_view field, RequestDeliverFilter&& filter) const noexcept;
 
 	const TypeMap _operations;
-	mutable std::mutex _validationMutex {};
-	const std::unique_ptr<ValidateExecutableVisitor> _validation;
-	mutable std::mutex _subscriptionMutex {};
-	internal::sorted_map<SubscriptionKey, std::shared_ptr<const SubscriptionData>> _subscriptions;
-	internal::sorted_map<SubscriptionName, internal::sorted_set<SubscriptionKey>> _listeners;
-	SubscriptionKey _nextKey = 0;
+	const std::shared_ptr<const ValidateSchema> _validation;
+	std::atomic<size_t> _maxCost = 0;
+	std::atomic<size_t> _variableMultiplier = RequestCostLimit {}.variableMultiplier;
+	mutable DocumentCache _documents;
+	mutable std::shared_mutex _persistedMutex {};
+	std::unordered_map<std::string, std::shared_ptr<const peg::ast>> _persistedQueries;
+	mutable DocumentCache _persistedDocuments;
+	SubscriptionRegistry _subscriptions;
+	mutable std::shared_mutex _argumentIndexMutex {};
+	std::map<SubscriptionName, std::shared_ptr<SubscriptionArgumentIndex>, std::less<>>
+		_argumentIndexes;
+	std::mutex _subscriptionDocumentsMutex {};
+	std::unordered_map<const peg::ast_node*, std::weak_ptr<const SubscriptionDocument>>
+		_subscriptionDocuments;
+	size_t _subscriptionDocumentsPruneSize = 0;
 };
 
 } // namespace service
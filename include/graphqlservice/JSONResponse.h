@@ -20,10 +20,23 @@
 
 #include "graphqlservice/GraphQLResponse.h"
 
+#include <functional>
+#include <string>
+
 namespace graphql::response {
 
 [[nodiscard("unnecessary conversion")]] JSONRESPONSE_EXPORT std::string toJSON(Value&& response);
 
+// Append the JSON text to an existing buffer, e.g. to reuse its capacity for the next response.
+JSONRESPONSE_EXPORT void toJSON(Value&& response, std::string& output);
+
+// Receives the JSON text in chunks of about chunkSize bytes as it is written, followed by whatever
+// is left in the buffer once the outermost value is complete.
+using JSONSink = std::function<void(std::string_view chunk)>;
+
+[[nodiscard("unnecessary construction")]] JSONRESPONSE_EXPORT Writer makeJSONWriter(
+	JSONSink sink, size_t chunkSize = 4096);
+
 [[nodiscard("unnecessary conversion")]] JSONRESPONSE_EXPORT Value parseJSON(
 	const std::string& json);
 
@@ -16,145 +16,507 @@
 #endif
 // clang-format on
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <future>
+#include <mutex>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <variant>
 
 namespace graphql::internal {
 
-template <typename T>
-class [[nodiscard("unnecessary construction")]] Awaitable;
-
-template <>
-class [[nodiscard("unnecessary construction")]] Awaitable<void>
+// Shared by the promise_type of every coroutine which returns a Task<T>. The coroutine starts
+// running immediately, and the result is stored inline in the coroutine frame instead of a
+// separately allocated std::promise/std::future shared state. Whoever awaits the result registers
+// itself as the continuation, and the coroutine transfers control directly to it when it finishes.
+class [[nodiscard("unnecessary construction")]] TaskPromiseBase
 {
 public:
-	Awaitable(std::future<void> value)
-		: _value { std::move(value) }
+	coro::suspend_never initial_suspend() const noexcept
 	{
+		return {};
 	}
 
-	void get()
+	struct [[nodiscard("unnecessary construction")]] final_awaiter
+	{
+		[[nodiscard("unexpected call")]] constexpr bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		template <typename Promise>
+		[[nodiscard("unexpected call")]] coro::coroutine_handle<> await_suspend(
+			coro::coroutine_handle<Promise> h) const noexcept
+		{
+			return h.promise().complete(h);
+		}
+
+		constexpr void await_resume() const noexcept
+		{
+		}
+	};
+
+	final_awaiter final_suspend() const noexcept
 	{
-		_value.get();
+		return {};
 	}
 
-	struct promise_type
+	[[nodiscard("unexpected call")]] bool done() const noexcept
 	{
-		[[nodiscard("unnecessary construction")]] Awaitable get_return_object() noexcept
+		return _state.load(std::memory_order_acquire) == s_completed;
+	}
+
+	// Register a continuation to resume when the coroutine finishes. Returns false if it already
+	// finished, in which case the caller should continue without suspending.
+	[[nodiscard("unexpected call")]] bool await(coro::coroutine_handle<> h) noexcept
+	{
+		auto expected = s_running;
+
+		return _state.compare_exchange_strong(expected,
+			reinterpret_cast<std::uintptr_t>(h.address()),
+			std::memory_order_acq_rel,
+			std::memory_order_acquire);
+	}
+
+	// Give up on the result. Returns true if the coroutine already finished and the caller should
+	// destroy it, otherwise the coroutine will destroy itself when it finishes.
+	[[nodiscard("unexpected call")]] bool detach() noexcept
+	{
+		return _state.exchange(s_detached, std::memory_order_acq_rel) == s_completed;
+	}
+
+	// Block the calling thread until the coroutine finishes.
+	void wait() noexcept
+	{
+		if (done())
 		{
-			return { _promise.get_future() };
+			return;
 		}
 
-		coro::suspend_never initial_suspend() const noexcept
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool signaled = false;
+
+		signal(*this, mutex, cv, signaled);
+
+		std::unique_lock lock { mutex };
+
+		cv.wait(lock, [&signaled]() noexcept {
+			return signaled;
+		});
+	}
+
+private:
+	// Coroutine frame addresses are always aligned, so they can never collide with these.
+	static constexpr std::uintptr_t s_running = 0;
+	static constexpr std::uintptr_t s_completed = 1;
+	static constexpr std::uintptr_t s_detached = 2;
+
+	[[nodiscard("unexpected call")]] coro::coroutine_handle<> complete(
+		coro::coroutine_handle<> h) noexcept
+	{
+		const auto previous = _state.exchange(s_completed, std::memory_order_acq_rel);
+
+		if (previous == s_detached)
 		{
-			return {};
+			h.destroy();
 		}
+		else if (previous != s_running)
+		{
+			return coro::coroutine_handle<>::from_address(reinterpret_cast<void*>(previous));
+		}
+
+		return coro::noop_coroutine();
+	}
+
+	// Fire and forget coroutine used by wait() to get notified when the coroutine finishes.
+	struct signal_on_completion
+	{
+		struct promise_type
+		{
+			signal_on_completion get_return_object() const noexcept
+			{
+				return {};
+			}
+
+			coro::suspend_never initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			coro::suspend_never final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void return_void() const noexcept
+			{
+			}
+
+			void unhandled_exception() const noexcept
+			{
+				std::terminate();
+			}
+		};
+	};
 
-		coro::suspend_never final_suspend() const noexcept
+	struct [[nodiscard("unnecessary construction")]] completion_awaiter
+	{
+		[[nodiscard("unexpected call")]] bool await_ready() const noexcept
 		{
-			return {};
+			return promise.done();
 		}
 
-		void return_void() noexcept
+		[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const noexcept
 		{
-			_promise.set_value();
+			return promise.await(h);
 		}
 
-		void unhandled_exception() noexcept
+		constexpr void await_resume() const noexcept
 		{
-			_promise.set_exception(std::current_exception());
 		}
 
-	private:
-		std::promise<void> _promise;
+		TaskPromiseBase& promise;
 	};
 
-	[[nodiscard("unexpected call")]] constexpr bool await_ready() const noexcept
+	static signal_on_completion signal(TaskPromiseBase& promise, std::mutex& mutex,
+		std::condition_variable& cv, bool& signaled)
 	{
-		return true;
+		co_await completion_awaiter { promise };
+
+		std::lock_guard lock { mutex };
+
+		signaled = true;
+		cv.notify_one();
+	}
+
+	std::atomic_uintptr_t _state { s_running };
+};
+
+template <typename T>
+class [[nodiscard("unnecessary construction")]] TaskPromise : public TaskPromiseBase
+{
+public:
+	void return_value(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+	{
+		_result.template emplace<T>(value);
 	}
 
-	void await_suspend(coro::coroutine_handle<> h) const
+	void return_value(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
 	{
-		h.resume();
+		_result.template emplace<T>(std::move(value));
 	}
 
-	void await_resume()
+	void unhandled_exception() noexcept
 	{
-		_value.get();
+		_result.template emplace<std::exception_ptr>(std::current_exception());
+	}
+
+	[[nodiscard("unnecessary construction")]] T result()
+	{
+		if (auto exception = std::get_if<std::exception_ptr>(&_result))
+		{
+			std::rethrow_exception(*exception);
+		}
+
+		return std::move(std::get<T>(_result));
 	}
 
 private:
-	std::future<void> _value;
+	std::variant<std::monostate, T, std::exception_ptr> _result;
 };
 
-template <typename T>
-class [[nodiscard("unnecessary construction")]] Awaitable
+template <>
+class [[nodiscard("unnecessary construction")]] TaskPromise<void> : public TaskPromiseBase
 {
 public:
-	Awaitable(std::future<T> value)
-		: _value { std::move(value) }
+	void return_void() noexcept
 	{
 	}
 
-	[[nodiscard("unnecessary construction")]] T get()
+	void unhandled_exception() noexcept
 	{
-		return _value.get();
+		_exception = std::current_exception();
 	}
 
-	struct promise_type
+	void result()
 	{
-		[[nodiscard("unnecessary construction")]] Awaitable get_return_object() noexcept
+		if (_exception)
 		{
-			return { _promise.get_future() };
+			std::rethrow_exception(_exception);
 		}
+	}
+
+private:
+	std::exception_ptr _exception;
+};
+
+// Owns the coroutine frame for a TaskPromise<T>. Destroying the Task before the coroutine finishes
+// detaches it, and the coroutine frame is destroyed as soon as it finishes.
+template <typename T>
+class [[nodiscard("unnecessary construction")]] Task
+{
+public:
+	Task(coro::coroutine_handle<> handle, TaskPromise<T>& promise) noexcept
+		: _handle { handle }
+		, _promise { &promise }
+	{
+	}
+
+	Task(Task&& other) noexcept
+		: _handle { std::exchange(other._handle, {}) }
+		, _promise { std::exchange(other._promise, nullptr) }
+	{
+	}
+
+	Task(const Task&) = delete;
+
+	~Task()
+	{
+		release();
+	}
 
-		coro::suspend_never initial_suspend() const noexcept
+	Task& operator=(Task&& rhs) noexcept
+	{
+		if (this != &rhs)
 		{
-			return {};
+			release();
+			_handle = std::exchange(rhs._handle, {});
+			_promise = std::exchange(rhs._promise, nullptr);
 		}
 
-		coro::suspend_never final_suspend() const noexcept
+		return *this;
+	}
+
+	Task& operator=(const Task&) = delete;
+
+	[[nodiscard("unexpected call")]] bool await_ready() const noexcept
+	{
+		return _promise->done();
+	}
+
+	[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const noexcept
+	{
+		return _promise->await(h);
+	}
+
+	T await_resume()
+	{
+		return _promise->result();
+	}
+
+	T get()
+	{
+		_promise->wait();
+
+		return _promise->result();
+	}
+
+private:
+	void release() noexcept
+	{
+		if (_handle && _promise->detach())
 		{
-			return {};
+			_handle.destroy();
 		}
+	}
+
+	coro::coroutine_handle<> _handle;
+	TaskPromise<T>* _promise;
+};
+
+template <typename T>
+class [[nodiscard("unnecessary construction")]] Awaitable;
+
+template <>
+class [[nodiscard("unnecessary construction")]] Awaitable<void>
+{
+public:
+	Awaitable(Task<void> value) noexcept
+		: _value { std::move(value) }
+	{
+	}
+
+	// Adapt a std::future<void> for compatibility with code which still returns one.
+	Awaitable(std::future<void> value)
+		: _value { std::move(value) }
+	{
+	}
+
+	void get()
+	{
+		std::visit(
+			[](auto& value) {
+				value.get();
+			},
+			_value);
+	}
 
-		void return_value(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+	struct promise_type : TaskPromise<void>
+	{
+		[[nodiscard("unnecessary construction")]] Awaitable get_return_object() noexcept
 		{
-			_promise.set_value(value);
+			return { Task<void> { coro::coroutine_handle<promise_type>::from_promise(*this),
+				*this } };
 		}
+	};
+
+	[[nodiscard("unexpected call")]] bool await_ready() const noexcept
+	{
+		return std::visit(
+			[](const auto& value) noexcept {
+				using value_type = std::decay_t<decltype(value)>;
+
+				if constexpr (std::is_same_v<value_type, Task<void>>)
+				{
+					return value.await_ready();
+				}
+				else if constexpr (std::is_same_v<value_type, std::future<void>>)
+				{
+					using namespace std::literals;
+
+					return value.wait_for(0s) != std::future_status::timeout;
+				}
+			},
+			_value);
+	}
 
-		void return_value(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
+	[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
+	{
+		if (const auto task = std::get_if<Task<void>>(&_value))
 		{
-			_promise.set_value(std::move(value));
+			return task->await_suspend(h);
 		}
 
-		void unhandled_exception() noexcept
+		std::thread(
+			[this](coro::coroutine_handle<> h) noexcept {
+				std::get<std::future<void>>(_value).wait();
+				h.resume();
+			},
+			std::move(h))
+			.detach();
+
+		return true;
+	}
+
+	void await_resume()
+	{
+		std::visit(
+			[](auto& value) {
+				using value_type = std::decay_t<decltype(value)>;
+
+				if constexpr (std::is_same_v<value_type, Task<void>>)
+				{
+					value.await_resume();
+				}
+				else if constexpr (std::is_same_v<value_type, std::future<void>>)
+				{
+					value.get();
+				}
+			},
+			_value);
+	}
+
+private:
+	std::variant<Task<void>, std::future<void>> _value;
+};
+
+template <typename T>
+class [[nodiscard("unnecessary construction")]] Awaitable
+{
+public:
+	Awaitable(Task<T> value) noexcept
+		: _value { std::move(value) }
+	{
+	}
+
+	// Adapt a std::future<T> for compatibility with code which still returns one.
+	Awaitable(std::future<T> value)
+		: _value { std::move(value) }
+	{
+	}
+
+	[[nodiscard("unnecessary construction")]] T get()
+	{
+		return std::visit(
+			[](auto& value) -> T {
+				return value.get();
+			},
+			_value);
+	}
+
+	struct promise_type : TaskPromise<T>
+	{
+		[[nodiscard("unnecessary construction")]] Awaitable get_return_object() noexcept
 		{
-			_promise.set_exception(std::current_exception());
+			return { Task<T> { coro::coroutine_handle<promise_type>::from_promise(*this),
+				*this } };
 		}
-
-	private:
-		std::promise<T> _promise;
 	};
 
-	[[nodiscard("unexpected call")]] constexpr bool await_ready() const noexcept
+	[[nodiscard("unexpected call")]] bool await_ready() const noexcept
 	{
-		return true;
+		return std::visit(
+			[](const auto& value) noexcept {
+				using value_type = std::decay_t<decltype(value)>;
+
+				if constexpr (std::is_same_v<value_type, Task<T>>)
+				{
+					return value.await_ready();
+				}
+				else if constexpr (std::is_same_v<value_type, std::future<T>>)
+				{
+					using namespace std::literals;
+
+					return value.wait_for(0s) != std::future_status::timeout;
+				}
+			},
+			_value);
 	}
 
-	void await_suspend(coro::coroutine_handle<> h) const
+	[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
 	{
-		h.resume();
+		if (const auto task = std::get_if<Task<T>>(&_value))
+		{
+			return task->await_suspend(h);
+		}
+
+		std::thread(
+			[this](coro::coroutine_handle<> h) noexcept {
+				std::get<std::future<T>>(_value).wait();
+				h.resume();
+			},
+			std::move(h))
+			.detach();
+
+		return true;
 	}
 
 	[[nodiscard("unnecessary construction")]] T await_resume()
 	{
-		return _value.get();
+		return std::visit(
+			[](auto& value) -> T {
+				using value_type = std::decay_t<decltype(value)>;
+
+				if constexpr (std::is_same_v<value_type, Task<T>>)
+				{
+					return value.await_resume();
+				}
+				else if constexpr (std::is_same_v<value_type, std::future<T>>)
+				{
+					return value.get();
+				}
+			},
+			_value);
 	}
 
 private:
-	std::future<T> _value;
+	std::variant<Task<T>, std::future<T>> _value;
 };
 
 } // namespace graphql::internal
@@ -339,6 +339,15 @@ private:
 	const std::weak_ptr<const BaseType> _ofType;
 };
 
+// Static cost analysis metadata from the @cost directive on a field definition. The weight is
+// added once for the field, and the cost of its selection set is multiplied by the value of the
+// named pagination arguments.
+struct [[nodiscard("unnecessary construction")]] FieldCost
+{
+	std::size_t weight = 1;
+	std::vector<std::string_view> multipliers {};
+};
+
 class [[nodiscard("unnecessary construction")]] Field : public std::enable_shared_from_this<Field>
 {
 private:
@@ -352,7 +361,7 @@ public:
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT static std::shared_ptr<Field> Make(
 		std::string_view name, std::string_view description,
 		std::optional<std::string_view> deprecationReason, std::weak_ptr<const BaseType> type,
-		std::vector<std::shared_ptr<const InputValue>>&& args = {});
+		std::vector<std::shared_ptr<const InputValue>>&& args = {}, FieldCost&& cost = {});
 
 	// Accessors
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT std::string_view name() const noexcept;
@@ -365,6 +374,8 @@ public:
 	type() const noexcept;
 	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT const std::optional<std::string_view>&
 	deprecationReason() const noexcept;
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT const FieldCost& cost()
+		const noexcept;
 
 private:
 	const std::string_view _name;
@@ -372,6 +383,7 @@ private:
 	const std::optional<std::string_view> _deprecationReason;
 	const std::weak_ptr<const BaseType> _type;
 	const std::vector<std::shared_ptr<const InputValue>> _args;
+	const FieldCost _cost;
 };
 
 class [[nodiscard("unnecessary construction")]] InputValue
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#ifndef GRAPHQLSHA256_H
+#define GRAPHQLSHA256_H
+
+// clang-format off
+#ifdef GRAPHQL_DLLEXPORTS
+	#ifdef IMPL_GRAPHQLSERVICE_DLL
+		#define GRAPHQLSERVICE_EXPORT __declspec(dllexport)
+	#else // !IMPL_GRAPHQLSERVICE_DLL
+		#define GRAPHQLSERVICE_EXPORT __declspec(dllimport)
+	#endif // !IMPL_GRAPHQLSERVICE_DLL
+#else // !GRAPHQL_DLLEXPORTS
+	#define GRAPHQLSERVICE_EXPORT
+#endif // !GRAPHQL_DLLEXPORTS
+// clang-format on
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace graphql::internal {
+
+// Persisted queries are identified by the SHA-256 hash of the query text.
+class Sha256
+{
+public:
+	using Digest = std::array<std::uint8_t, 32>;
+
+	// Compute the SHA-256 digest of a string.
+	[[nodiscard("unnecessary call")]] GRAPHQLSERVICE_EXPORT static Digest hash(
+		std::string_view data) noexcept;
+
+	// Convert a digest to a lowercase hexadecimal string.
+	[[nodiscard("unnecessary conversion")]] GRAPHQLSERVICE_EXPORT static std::string toHex(
+		const Digest& digest);
+
+	// Compute the SHA-256 digest of a string and convert it to a lowercase hexadecimal string.
+	[[nodiscard("unnecessary call")]] static std::string hashHex(std::string_view data)
+	{
+		return toHex(hash(data));
+	}
+};
+
+} // namespace graphql::internal
+
+#endif // GRAPHQLSHA256_H
@@ -27,24 +27,28 @@ Droid::Droid(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Droid::getTypeNames() const noexcept
+const service::TypeNames& Droid::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Character)gql"sv,
 		R"gql(Droid)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Droid::getResolvers() const noexcept
+const service::ResolverMap& Droid::getResolvers() noexcept
 {
-	return {
-		{ R"gql(id)gql"sv, [this](service::ResolverParams&& params) { return resolveId(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(friends)gql"sv, [this](service::ResolverParams&& params) { return resolveFriends(std::move(params)); } },
-		{ R"gql(appearsIn)gql"sv, [this](service::ResolverParams&& params) { return resolveAppearsIn(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(primaryFunction)gql"sv, [this](service::ResolverParams&& params) { return resolvePrimaryFunction(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(id)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolveId(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolveName(std::move(params)); } },
+		{ R"gql(friends)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolveFriends(std::move(params)); } },
+		{ R"gql(appearsIn)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolveAppearsIn(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(primaryFunction)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Droid&>(object).resolvePrimaryFunction(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Droid::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -61,7 +65,7 @@ service::AwaitableResolver Droid::resolveId(service::ResolverParams&& params) co
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getId(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -72,7 +76,7 @@ service::AwaitableResolver Droid::resolveName(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -83,7 +87,7 @@ service::AwaitableResolver Droid::resolveFriends(service::ResolverParams&& param
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getFriends(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -94,7 +98,7 @@ service::AwaitableResolver Droid::resolveAppearsIn(service::ResolverParams&& par
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getAppearsIn(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -105,7 +109,7 @@ service::AwaitableResolver Droid::resolvePrimaryFunction(service::ResolverParams
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getPrimaryFunction(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
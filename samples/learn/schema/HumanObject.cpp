@@ -27,24 +27,28 @@ Human::Human(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Human::getTypeNames() const noexcept
+const service::TypeNames& Human::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Character)gql"sv,
 		R"gql(Human)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Human::getResolvers() const noexcept
+const service::ResolverMap& Human::getResolvers() noexcept
 {
-	return {
-		{ R"gql(id)gql"sv, [this](service::ResolverParams&& params) { return resolveId(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(friends)gql"sv, [this](service::ResolverParams&& params) { return resolveFriends(std::move(params)); } },
-		{ R"gql(appearsIn)gql"sv, [this](service::ResolverParams&& params) { return resolveAppearsIn(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(homePlanet)gql"sv, [this](service::ResolverParams&& params) { return resolveHomePlanet(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(id)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveId(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveName(std::move(params)); } },
+		{ R"gql(friends)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveFriends(std::move(params)); } },
+		{ R"gql(appearsIn)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveAppearsIn(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(homePlanet)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveHomePlanet(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Human::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -61,7 +65,7 @@ service::AwaitableResolver Human::resolveId(service::ResolverParams&& params) co
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getId(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -72,7 +76,7 @@ service::AwaitableResolver Human::resolveName(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -83,7 +87,7 @@ service::AwaitableResolver Human::resolveFriends(service::ResolverParams&& param
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getFriends(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -94,7 +98,7 @@ service::AwaitableResolver Human::resolveAppearsIn(service::ResolverParams&& par
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getAppearsIn(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -105,7 +109,7 @@ service::AwaitableResolver Human::resolveHomePlanet(service::ResolverParams&& pa
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getHomePlanet(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
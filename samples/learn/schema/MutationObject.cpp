@@ -27,19 +27,23 @@ Mutation::Mutation(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Mutation::getTypeNames() const noexcept
+const service::TypeNames& Mutation::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Mutation)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Mutation::getResolvers() const noexcept
+const service::ResolverMap& Mutation::getResolvers() noexcept
 {
-	return {
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(createReview)gql"sv, [this](service::ResolverParams&& params) { return resolveCreateReview(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Mutation&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(createReview)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Mutation&>(object).resolveCreateReview(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Mutation::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -58,7 +62,7 @@ service::AwaitableResolver Mutation::resolveCreateReview(service::ResolverParams
 	auto argReview = service::ModifiedArgument<learn::ReviewInput>::require("review", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->applyCreateReview(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argEp), std::move(argReview));
 	resolverLock.unlock();
 
@@ -26,20 +26,24 @@ Review::Review(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Review::getTypeNames() const noexcept
+const service::TypeNames& Review::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Review)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Review::getResolvers() const noexcept
+const service::ResolverMap& Review::getResolvers() noexcept
 {
-	return {
-		{ R"gql(stars)gql"sv, [this](service::ResolverParams&& params) { return resolveStars(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(commentary)gql"sv, [this](service::ResolverParams&& params) { return resolveCommentary(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(stars)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Review&>(object).resolveStars(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Review&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(commentary)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Review&>(object).resolveCommentary(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Review::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -56,7 +60,7 @@ service::AwaitableResolver Review::resolveStars(service::ResolverParams&& params
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getStars(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -67,7 +71,7 @@ service::AwaitableResolver Review::resolveCommentary(service::ResolverParams&& p
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getCommentary(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -50,14 +50,65 @@ constexpr net::string_view c_host { "127.0.0.1" };
 constexpr unsigned short c_port = 8080;
 constexpr beast::string_view c_target { "/graphql" };
 
+// Automatic persisted queries send the hash of the query text in the extensions:
+// https://www.apollographql.com/docs/apollo-server/performance/apq/
+std::string_view findPersistedQueryHash(const response::Value& payload)
+{
+	const auto extensionsItr = payload.find("extensions"sv);
+
+	if (extensionsItr == payload.end() || extensionsItr->second.type() != response::Type::Map)
+	{
+		return {};
+	}
+
+	const auto persistedQueryItr = extensionsItr->second.find("persistedQuery"sv);
+
+	if (persistedQueryItr == extensionsItr->second.end()
+		|| persistedQueryItr->second.type() != response::Type::Map)
+	{
+		return {};
+	}
+
+	const auto hashItr = persistedQueryItr->second.find("sha256Hash"sv);
+
+	if (hashItr == persistedQueryItr->second.end()
+		|| hashItr->second.type() != response::Type::String)
+	{
+		return {};
+	}
+
+	return hashItr->second.get<response::StringType>();
+}
+
 // Based on:
 // https://www.boost.org/doc/libs/1_82_0/libs/beast/example/http/server/awaitable/http_server_awaitable.cpp
-int main()
+int main(int argc, char** argv)
 {
 	auto service = star_wars::GetService();
 
 	std::cout << "Created the service..." << std::endl;
 
+	if (argc > 1)
+	{
+		try
+		{
+			const auto count = service->registerPersistedQueries(argv[1]);
+
+			std::cout << "Registered " << count << " persisted queries..." << std::endl;
+		}
+		catch (service::schema_exception& scx)
+		{
+			std::cerr << "Invalid persisted query: " << response::toJSON(scx.getErrors())
+					  << std::endl;
+			return 1;
+		}
+		catch (const std::exception& ex)
+		{
+			std::cerr << ex.what() << std::endl;
+			return 1;
+		}
+	}
+
 	const auto address = net::ip::make_address(c_host);
 
 	// The io_context is required for all I/O.
@@ -130,23 +181,19 @@ int main()
 										}
 
 										const auto queryItr = payload.find("query"sv);
+										const auto queryText = (queryItr != payload.end()
+																   && queryItr->second.type()
+																	   == response::Type::String)
+											? std::string_view { queryItr->second
+																	 .get<response::StringType>() }
+											: std::string_view {};
+										const auto hash = findPersistedQueryHash(payload);
 
-										if (queryItr == payload.end()
-											|| queryItr->second.type() != response::Type::String)
+										if (queryText.empty() && hash.empty())
 										{
 											throw std::runtime_error("Invalid request!");
 										}
 
-										peg::ast query;
-
-										query = peg::parseString(
-											queryItr->second.get<response::StringType>());
-
-										if (!query.root)
-										{
-											throw std::runtime_error("Unknown error!");
-										}
-
 										const auto operationNameItr =
 											payload.find("operationName"sv);
 										const auto operationName =
@@ -170,11 +217,34 @@ int main()
 										msg.set(http::field::server, BOOST_BEAST_VERSION_STRING);
 										msg.set(http::field::content_type, "application/json");
 										msg.keep_alive(req.keep_alive());
-										msg.body() = response::toJSON(
-											service
-												->resolve(
-													{ query, operationName, std::move(variables) })
-												.get());
+										if (hash.empty())
+										{
+											auto query = peg::parseString(queryText);
+
+											if (!query.root)
+											{
+												throw std::runtime_error("Unknown error!");
+											}
+
+											msg.body() = response::toJSON(
+												service
+													->resolve({ query,
+														operationName,
+														std::move(variables) })
+													.get());
+										}
+										else
+										{
+											// The client only sends the query text if it's not
+											// registered yet, otherwise it just sends the hash.
+											msg.body() = response::toJSON(
+												service
+													->resolvePersisted({ hash,
+														queryText,
+														operationName,
+														std::move(variables) })
+													.get());
+										}
 										msg.prepare_payload();
 									}
 								}
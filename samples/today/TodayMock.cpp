@@ -845,9 +845,9 @@ std::shared_ptr<object::Node> Subscription::getNodeChange(const response::IdType
 	throw std::runtime_error("Unexpected call to getNodeChange");
 }
 
-size_t NextAppointmentChange::_notifySubscribeCount = 0;
-size_t NextAppointmentChange::_subscriptionCount = 0;
-size_t NextAppointmentChange::_notifyUnsubscribeCount = 0;
+std::atomic_size_t NextAppointmentChange::_notifySubscribeCount = 0;
+std::atomic_size_t NextAppointmentChange::_subscriptionCount = 0;
+std::atomic_size_t NextAppointmentChange::_notifyUnsubscribeCount = 0;
 
 NextAppointmentChange::NextAppointmentChange(nextAppointmentChange&& changeNextAppointment)
 	: _changeNextAppointment(std::move(changeNextAppointment))
@@ -327,9 +327,9 @@ public:
 private:
 	nextAppointmentChange _changeNextAppointment;
 
-	static size_t _notifySubscribeCount;
-	static size_t _subscriptionCount;
-	static size_t _notifyUnsubscribeCount;
+	static std::atomic_size_t _notifySubscribeCount;
+	static std::atomic_size_t _subscriptionCount;
+	static std::atomic_size_t _notifyUnsubscribeCount;
 };
 
 class NodeChange
@@ -3,20 +3,131 @@
 
 #include "TodayMock.h"
 
+#include "graphqlservice/BinaryResponse.h"
 #include "graphqlservice/JSONResponse.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <new>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <utility>
 
 using namespace graphql;
 
 using namespace std::literals;
 
+// Count the global heap allocations, to compare resolving a response with and without a
+// response::ValueArena. If the libraries are DLLs on Windows, they do not use this operator new.
+std::atomic<size_t> g_allocationCount = 0;
+std::atomic<size_t> g_allocationBytes = 0;
+
+// Each allocation starts with a header which remembers the size, so the unsized operator delete
+// can also keep track of how many bytes are still allocated, e.g. by the active subscriptions.
+std::atomic<size_t> g_allocationLiveBytes = 0;
+
+constexpr size_t c_allocationHeader = alignof(std::max_align_t);
+
+void* trackAllocation(void* block, std::size_t size, std::size_t header) noexcept
+{
+	++g_allocationCount;
+	g_allocationBytes += size;
+	g_allocationLiveBytes += size;
+
+	const auto ptr = static_cast<std::byte*>(block) + header;
+
+	std::memcpy(ptr - sizeof(size), &size, sizeof(size));
+
+	return ptr;
+}
+
+void* releaseAllocation(void* ptr, std::size_t header) noexcept
+{
+	std::size_t size;
+
+	std::memcpy(&size, static_cast<std::byte*>(ptr) - sizeof(size), sizeof(size));
+	g_allocationLiveBytes -= size;
+
+	return static_cast<std::byte*>(ptr) - header;
+}
+
+void* operator new(std::size_t size)
+{
+	if (auto block = std::malloc(c_allocationHeader + (size == 0 ? 1 : size)))
+	{
+		return trackAllocation(block, size, c_allocationHeader);
+	}
+
+	throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr)
+	{
+		std::free(releaseAllocation(ptr, c_allocationHeader));
+	}
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+// std::pmr::new_delete_resource allocates with the aligned overloads.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	// Both of these are powers of 2, so the header keeps the rest of the block aligned.
+	const auto align = static_cast<std::size_t>(alignment);
+	const auto header = std::max(align, c_allocationHeader);
+	const auto alignedSize = (header + (size == 0 ? 1 : size) + align - 1) / align * align;
+
+#ifdef _MSC_VER
+	if (auto block = _aligned_malloc(alignedSize, align))
+#else // !_MSC_VER
+	if (auto block = std::aligned_alloc(align, alignedSize))
+#endif // !_MSC_VER
+	{
+		return trackAllocation(block, size, header);
+	}
+
+	throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	const auto block =
+		releaseAllocation(ptr, std::max(static_cast<std::size_t>(alignment), c_allocationHeader));
+
+#ifdef _MSC_VER
+	_aligned_free(block);
+#else // !_MSC_VER
+	std::free(block);
+#endif // !_MSC_VER
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
 void outputOverview(
 	size_t iterations, const std::chrono::steady_clock::duration& totalDuration) noexcept
 {
@@ -59,6 +170,166 @@ void outputSegment(
 			  << " average" << std::endl;
 }
 
+void outputFanOut(std::string_view name, size_t events,
+	const std::chrono::steady_clock::duration& totalDuration,
+	std::vector<std::chrono::steady_clock::duration>& latencies) noexcept
+{
+	std::sort(latencies.begin(), latencies.end());
+
+	const auto count = latencies.size();
+	const auto eventsPerSecond =
+		((static_cast<double>(events)
+			 * static_cast<double>(
+				 std::chrono::duration_cast<std::chrono::steady_clock::duration>(1s).count()))
+			/ static_cast<double>(totalDuration.count()));
+
+	const auto percentile = [&latencies, count](size_t permille) noexcept {
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			latencies[count * permille / 1000])
+			.count();
+	};
+
+	std::cout << name << ": " << eventsPerSecond << " events/second, latency (microseconds): "
+			  << percentile(500) << " median, " << percentile(990) << " p99, " << percentile(999)
+			  << " p99.9, "
+			  << std::chrono::duration_cast<std::chrono::microseconds>(latencies.back()).count()
+			  << " maximum" << std::endl;
+}
+
+// Each fragment spreads the next one twice in different selection sets, so validating every spread
+// separately would take exponential time in the depth of the fragments.
+std::string buildNestedFragmentsQuery(size_t depth)
+{
+	std::ostringstream oss;
+
+	oss << "query { nested { ...nested0 } }";
+
+	for (size_t i = 0; i < depth; ++i)
+	{
+		oss << " fragment nested" << i << " on NestedType { depth first: nested { ...nested"
+			<< (i + 1) << " } second: nested { ...nested" << (i + 1) << " } }";
+	}
+
+	oss << " fragment nested" << depth << " on NestedType { depth }";
+
+	return oss.str();
+}
+
+// A large list of objects with string, numeric and nested members, to compare serializing with
+// response::toJSON and with the response::Writer returned by response::makeJSONWriter.
+response::Value buildSyntheticResponse(size_t count)
+{
+	response::Value nodes(response::Type::List);
+
+	nodes.reserve(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		response::Value node(response::Type::Map);
+		response::Value tags(response::Type::List);
+		const auto index = static_cast<int>(i);
+
+		tags.emplace_back(response::Value(std::string { "alpha" }));
+		tags.emplace_back(response::Value(std::string { "beta \"quoted\"" }));
+
+		[[maybe_unused]] auto added = node.emplace_back("id",
+			response::Value(response::IdType { std::uint8_t(i), std::uint8_t(i >> 8), 0xFF }));
+		added = node.emplace_back("index", response::Value(index));
+		added = node.emplace_back("subject",
+			response::Value("Appointment subject number "s + std::to_string(i)));
+		added = node.emplace_back("when", response::Value(std::string { "2026-10-16T12:00:00Z" }));
+		added = node.emplace_back("isNow", response::Value(i % 2 == 0));
+		added = node.emplace_back("score", response::Value(static_cast<double>(i) / 7.0));
+		added = node.emplace_back("notes", response::Value(std::string { "line 1\nline 2" }));
+		added = node.emplace_back("owner", response::Value());
+		added = node.emplace_back("tags", std::move(tags));
+		added = node.emplace_back("priority", response::Value(index % 5));
+
+		nodes.emplace_back(std::move(node));
+	}
+
+	response::Value document(response::Type::Map);
+
+	[[maybe_unused]] auto added = document.emplace_back("nodes", std::move(nodes));
+
+	return document;
+}
+
+// Indent compact JSON with a tab for each level and put every member and element on its own line,
+// to measure how fast the parser skips whitespace.
+std::string prettyPrintJSON(std::string_view json)
+{
+	std::string pretty;
+	size_t depth = 0;
+	bool inString = false;
+	bool escaped = false;
+
+	pretty.reserve(json.size() * 2);
+
+	const auto newLine = [&pretty, &depth]() {
+		pretty.push_back('\n');
+		pretty.append(depth, '\t');
+	};
+
+	for (size_t i = 0; i < json.size(); ++i)
+	{
+		const char c = json[i];
+
+		if (inString)
+		{
+			pretty.push_back(c);
+			inString = escaped || c != '"';
+			escaped = !escaped && c == '\\';
+			continue;
+		}
+
+		switch (c)
+		{
+			case '{':
+			case '[':
+				pretty.push_back(c);
+
+				if (i + 1 < json.size() && json[i + 1] != '}' && json[i + 1] != ']')
+				{
+					++depth;
+					newLine();
+				}
+				break;
+
+			case '}':
+			case ']':
+				if (json[i - 1] != '{' && json[i - 1] != '[')
+				{
+					--depth;
+					newLine();
+				}
+
+				pretty.push_back(c);
+				break;
+
+			case ',':
+				pretty.push_back(c);
+				newLine();
+				break;
+
+			case ':':
+				pretty.append(": ");
+				break;
+
+			case '"':
+				inString = true;
+				pretty.push_back(c);
+				break;
+
+			default:
+				pretty.push_back(c);
+				break;
+		}
+	}
+
+	return pretty;
+}
+
 int main(int argc, char** argv)
 {
 	const size_t iterations = [](const char* arg) noexcept -> size_t {
@@ -84,6 +355,7 @@ int main(int argc, char** argv)
 	std::vector<std::chrono::steady_clock::duration> durationValidate(iterations);
 	std::vector<std::chrono::steady_clock::duration> durationResolve(iterations);
 	std::vector<std::chrono::steady_clock::duration> durationToJson(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationPrepared(iterations);
 	const auto startTime = std::chrono::steady_clock::now();
 
 	try
@@ -139,12 +411,542 @@ int main(int argc, char** argv)
 	const auto endTime = std::chrono::steady_clock::now();
 	const auto totalDuration = endTime - startTime;
 
+	try
+	{
+		// Compile the same query once and measure how long it takes to resolve the plan, which
+		// should be compared with the Resolve segment.
+		const auto prepared = service->prepare(peg::parseString(R"gql(query {
+			appointments {
+				pageInfo { hasNextPage }
+				edges {
+					node {
+						id
+						when
+						subject
+						isNow
+					}
+				}
+			}
+		})gql"sv));
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			const auto startResolve = std::chrono::steady_clock::now();
+			auto response = service->resolve({ prepared }).get();
+			const auto endResolve = std::chrono::steady_clock::now();
+
+			if (response::toJSON(std::move(response)).empty())
+			{
+				std::cerr << "Failed to convert to JSON!" << std::endl;
+				break;
+			}
+
+			durationPrepared[i] = endResolve - startResolve;
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	size_t allocationsDefault = 0;
+	size_t allocationsArena = 0;
+
+	try
+	{
+		// Count the allocations for resolving and then destroying the response, with and without
+		// an arena for the maps and lists.
+		auto query = peg::parseString(R"gql(query {
+			appointments {
+				pageInfo { hasNextPage }
+				edges {
+					node {
+						id
+						when
+						subject
+						isNow
+					}
+				}
+			}
+		})gql"sv);
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			auto startCount = g_allocationCount.load();
+
+			{
+				[[maybe_unused]] auto response = service->resolve({ query }).get();
+			}
+
+			allocationsDefault += g_allocationCount.load() - startCount;
+			startCount = g_allocationCount.load();
+
+			{
+				response::ValueArena arena;
+				[[maybe_unused]] auto response =
+					service
+						->resolve({ query,
+							{},
+							response::Value { response::Type::Map },
+							{},
+							{},
+							&arena })
+						.get();
+			}
+
+			allocationsArena += g_allocationCount.load() - startCount;
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticToJson(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticToJsonBuffer(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticWriter(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticToCBOR(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticToMessagePack(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticParseJSON(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticParseCBOR(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationSyntheticParseMessagePack(iterations);
+	size_t syntheticJsonSize = 0;
+	size_t syntheticCborSize = 0;
+	size_t syntheticMessagePackSize = 0;
+
+	try
+	{
+		constexpr size_t c_syntheticNodes = 10000;
+		const auto synthetic = buildSyntheticResponse(c_syntheticNodes);
+		std::string jsonBuffer;
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			auto response = response::Value { synthetic };
+			const auto startToJson = std::chrono::steady_clock::now();
+			const auto json = response::toJSON(std::move(response));
+
+			durationSyntheticToJson[i] = std::chrono::steady_clock::now() - startToJson;
+
+			// Append to a buffer which keeps its capacity from the previous iteration.
+			response = response::Value { synthetic };
+			jsonBuffer.clear();
+
+			const auto startToJsonBuffer = std::chrono::steady_clock::now();
+
+			response::toJSON(std::move(response), jsonBuffer);
+			durationSyntheticToJsonBuffer[i] = std::chrono::steady_clock::now() - startToJsonBuffer;
+
+			if (json != jsonBuffer)
+			{
+				std::cerr << "Appended JSON does not match!" << std::endl;
+				break;
+			}
+
+			std::string written;
+			auto writer = response::makeJSONWriter([&written](std::string_view chunk) {
+				written.append(chunk);
+			});
+
+			response = response::Value { synthetic };
+
+			const auto startWriter = std::chrono::steady_clock::now();
+
+			writer.write(std::move(response));
+			durationSyntheticWriter[i] = std::chrono::steady_clock::now() - startWriter;
+
+			if (json != written)
+			{
+				std::cerr << "Serialized JSON does not match!" << std::endl;
+				break;
+			}
+
+			// Compare the size and speed of the binary encodings with JSON.
+			response = response::Value { synthetic };
+
+			const auto startToCBOR = std::chrono::steady_clock::now();
+			const auto cbor = response::toCBOR(std::move(response));
+
+			durationSyntheticToCBOR[i] = std::chrono::steady_clock::now() - startToCBOR;
+			response = response::Value { synthetic };
+
+			const auto startToMessagePack = std::chrono::steady_clock::now();
+			const auto msgpack = response::toMessagePack(std::move(response));
+
+			durationSyntheticToMessagePack[i] =
+				std::chrono::steady_clock::now() - startToMessagePack;
+
+			const auto startParseJSON = std::chrono::steady_clock::now();
+			[[maybe_unused]] const auto parsedJson = response::parseJSON(json);
+			const auto startParseCBOR = std::chrono::steady_clock::now();
+			[[maybe_unused]] const auto parsedCbor = response::parseCBOR(cbor);
+			const auto startParseMessagePack = std::chrono::steady_clock::now();
+			[[maybe_unused]] const auto parsedMessagePack = response::parseMessagePack(msgpack);
+			const auto endParse = std::chrono::steady_clock::now();
+
+			durationSyntheticParseJSON[i] = startParseCBOR - startParseJSON;
+			durationSyntheticParseCBOR[i] = startParseMessagePack - startParseCBOR;
+			durationSyntheticParseMessagePack[i] = endParse - startParseMessagePack;
+
+			syntheticJsonSize = json.size();
+			syntheticCborSize = cbor.size();
+			syntheticMessagePackSize = msgpack.size();
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	constexpr std::array c_parseMegabytes { size_t { 1 }, size_t { 10 }, size_t { 100 } };
+	std::vector<std::pair<std::string, std::vector<std::chrono::steady_clock::duration>>>
+		durationParseJSON;
+
+	try
+	{
+		// Parse JSON arrays of about 1 MB, 10 MB, and 100 MB built from copies of the synthetic
+		// response, both compact and pretty-printed. Each size runs at most 100 MB worth of
+		// iterations, but always parses the document at least once. Build with
+		// GRAPHQL_USE_SIMDJSON=ON and OFF to compare simdjson with RapidJSON.
+		const auto element = response::toJSON(buildSyntheticResponse(1000));
+
+		for (const auto megabytes : c_parseMegabytes)
+		{
+			const auto targetSize = megabytes * 1024 * 1024;
+			std::string compact { "[" };
+
+			compact.reserve(targetSize + element.size() + 1);
+
+			while (compact.size() < targetSize)
+			{
+				if (compact.size() > 1)
+				{
+					compact.push_back(',');
+				}
+
+				compact.append(element);
+			}
+
+			compact.push_back(']');
+
+			const auto pretty = prettyPrintJSON(compact);
+			const auto parseIterations =
+				std::max(size_t { 1 }, std::min(iterations, 100 / megabytes));
+
+			const std::array<std::pair<std::string_view, const std::string*>, 2> formats { {
+				{ "compact"sv, &compact },
+				{ "pretty"sv, &pretty },
+			} };
+
+			for (const auto& [format, json] : formats)
+			{
+				auto name = "ParseJSON "s + std::to_string(megabytes) + " MB "s;
+
+				name.append(format);
+
+				auto& durations =
+					durationParseJSON.emplace_back(std::move(name), parseIterations).second;
+
+				for (auto& duration : durations)
+				{
+					const auto startParse = std::chrono::steady_clock::now();
+					const auto parsed = response::parseJSON(*json);
+
+					duration = std::chrono::steady_clock::now() - startParse;
+
+					if (parsed.type() != response::Type::List || parsed.size() == 0)
+					{
+						std::cerr << "Failed to parse the JSON!" << std::endl;
+						break;
+					}
+				}
+			}
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	constexpr std::array c_fragmentDepths { size_t { 8 }, size_t { 16 }, size_t { 32 } };
+	std::array<std::vector<std::chrono::steady_clock::duration>, c_fragmentDepths.size()>
+		durationFragments;
+
+	try
+	{
+		// Validation should scale linearly with the depth of the nested fragments.
+		for (size_t i = 0; i < c_fragmentDepths.size(); ++i)
+		{
+			const auto queryText = buildNestedFragmentsQuery(c_fragmentDepths[i]);
+
+			durationFragments[i].resize(iterations);
+
+			for (size_t j = 0; j < iterations; ++j)
+			{
+				auto query = peg::parseString(queryText);
+				const auto startValidate = std::chrono::steady_clock::now();
+
+				if (!service->validate(query).empty())
+				{
+					std::cerr << "Failed to validate the nested fragments!" << std::endl;
+					break;
+				}
+
+				durationFragments[i][j] = std::chrono::steady_clock::now() - startValidate;
+			}
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	// Deliver a few events to a large number of subscriptions, one at a time and then concurrently
+	// on a worker pool. The latency is measured from the start of each event until each callback.
+	constexpr size_t c_fanOutSubscriptions = 100'000;
+	constexpr size_t c_fanOutEvents = 5;
+	const auto workerPool = std::make_shared<service::await_worker_pool>();
+	const std::array fanOutModes {
+		std::make_tuple("Fan-out Serial"sv,
+			service::await_async {},
+			size_t { 1 },
+			service::DeliverOrder::Registration),
+		std::make_tuple("Fan-out Ordered"sv,
+			service::await_async { workerPool },
+			workerPool->size() * 4,
+			service::DeliverOrder::Registration),
+		std::make_tuple("Fan-out Unordered"sv,
+			service::await_async { workerPool },
+			workerPool->size() * 4,
+			service::DeliverOrder::Completion),
+	};
+	std::array<std::chrono::steady_clock::duration, fanOutModes.size()> durationFanOut {};
+	std::array<std::vector<std::chrono::steady_clock::duration>, fanOutModes.size()>
+		latencyFanOut;
+	std::vector<std::chrono::steady_clock::duration> durationChurnSubscribe(iterations);
+	std::vector<std::chrono::steady_clock::duration> durationChurnUnsubscribe(iterations);
+	size_t subscribeBytesParsed = 0;
+	size_t subscribeBytesShared = 0;
+	size_t subscribeLiveBytesParsed = 0;
+	size_t subscribeLiveBytesShared = 0;
+
+	try
+	{
+		std::chrono::steady_clock::time_point startEvent;
+		std::vector<std::chrono::steady_clock::duration>* latencies = nullptr;
+		std::atomic_size_t delivered = 0;
+		std::vector<service::SubscriptionKey> keys(c_fanOutSubscriptions);
+		const service::SubscriptionCallback callback =
+			[&startEvent, &latencies, &delivered](response::Value&&) {
+				const auto index = delivered++;
+
+				(*latencies)[index] = std::chrono::steady_clock::now() - startEvent;
+			};
+
+		// Each of these subscriptions parses and validates its own copy of the query.
+		const auto startParsedBytes = g_allocationBytes.load();
+		const auto startParsedLiveBytes = g_allocationLiveBytes.load();
+
+		for (auto& key : keys)
+		{
+			key = service
+					  ->subscribe({ callback, peg::parseString(R"gql(subscription {
+							nextAppointmentChange {
+								id
+								when
+								subject
+								isNow
+							}
+						})gql"sv) })
+					  .get();
+		}
+
+		subscribeBytesParsed = g_allocationBytes.load() - startParsedBytes;
+		subscribeLiveBytesParsed = g_allocationLiveBytes.load() - startParsedLiveBytes;
+
+		for (size_t i = 0; i < fanOutModes.size(); ++i)
+		{
+			const auto& [name, launch, maxConcurrency, order] = fanOutModes[i];
+
+			latencyFanOut[i].resize(c_fanOutEvents * c_fanOutSubscriptions);
+			latencies = &latencyFanOut[i];
+			delivered = 0;
+
+			const auto startFanOut = std::chrono::steady_clock::now();
+
+			for (size_t j = 0; j < c_fanOutEvents; ++j)
+			{
+				startEvent = std::chrono::steady_clock::now();
+				service
+					->deliver({ "nextAppointmentChange"sv,
+						{}, // filter
+						launch,
+						{}, // subscriptionObject
+						maxConcurrency,
+						order })
+					.get();
+			}
+
+			durationFanOut[i] = std::chrono::steady_clock::now() - startFanOut;
+
+			if (delivered != latencyFanOut[i].size())
+			{
+				std::cerr << "Failed to deliver every event!" << std::endl;
+				return 1;
+			}
+		}
+
+		// Replace some of the subscriptions while the rest of them stay registered. The query is
+		// validated ahead of time, so this mostly measures adding to and removing from the
+		// subscription registry.
+		auto churnQuery = peg::parseString(R"gql(subscription {
+			nextAppointmentChange {
+				id
+			}
+		})gql"sv);
+
+		if (!service->validate(churnQuery).empty())
+		{
+			std::cerr << "Failed to validate the churn subscription!" << std::endl;
+			return 1;
+		}
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			auto& key = keys[(i * 7919) % keys.size()];
+			const auto startUnsubscribe = std::chrono::steady_clock::now();
+
+			service->unsubscribe({ key }).get();
+
+			const auto startSubscribe = std::chrono::steady_clock::now();
+
+			key = service->subscribe({ callback, churnQuery }).get();
+
+			const auto endSubscribe = std::chrono::steady_clock::now();
+
+			durationChurnUnsubscribe[i] = startSubscribe - startUnsubscribe;
+			durationChurnSubscribe[i] = endSubscribe - startSubscribe;
+		}
+
+		for (auto key : keys)
+		{
+			service->unsubscribe({ key }).get();
+		}
+
+		// Subscribe again with a single document shared by all of the subscriptions, e.g. from a
+		// DocumentCache.
+		const auto sharedDocument = std::make_shared<const peg::ast>(peg::parseString(
+			R"gql(subscription {
+				nextAppointmentChange {
+					id
+					when
+					subject
+					isNow
+				}
+			})gql"sv));
+		const auto startSharedBytes = g_allocationBytes.load();
+		const auto startSharedLiveBytes = g_allocationLiveBytes.load();
+
+		for (auto& key : keys)
+		{
+			key = service
+					  ->subscribe({ callback,
+						  {}, // query
+						  {}, // operationName
+						  response::Value { response::Type::Map },
+						  {}, // launch
+						  {}, // state
+						  {}, // subscriptionObject
+						  sharedDocument })
+					  .get();
+		}
+
+		subscribeBytesShared = g_allocationBytes.load() - startSharedBytes;
+		subscribeLiveBytesShared = g_allocationLiveBytes.load() - startSharedLiveBytes;
+
+		for (auto key : keys)
+		{
+			service->unsubscribe({ key }).get();
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
 	outputOverview(iterations, totalDuration);
 
 	outputSegment("Parse"sv, durationParse);
 	outputSegment("Validate"sv, durationValidate);
 	outputSegment("Resolve"sv, durationResolve);
 	outputSegment("ToJSON"sv, durationToJson);
+	outputSegment("Prepared"sv, durationPrepared);
+
+	std::cout << "Resolve allocations: "
+			  << (static_cast<double>(allocationsDefault) / static_cast<double>(iterations))
+			  << " average, "
+			  << (static_cast<double>(allocationsArena) / static_cast<double>(iterations))
+			  << " average with response::ValueArena" << std::endl;
+
+	outputSegment("Synthetic ToJSON"sv, durationSyntheticToJson);
+	outputSegment("Synthetic ToJSON Buffer"sv, durationSyntheticToJsonBuffer);
+	outputSegment("Synthetic Writer"sv, durationSyntheticWriter);
+	outputSegment("Synthetic ToCBOR"sv, durationSyntheticToCBOR);
+	outputSegment("Synthetic ToMessagePack"sv, durationSyntheticToMessagePack);
+	outputSegment("Synthetic ParseJSON"sv, durationSyntheticParseJSON);
+	outputSegment("Synthetic ParseCBOR"sv, durationSyntheticParseCBOR);
+	outputSegment("Synthetic ParseMessagePack"sv, durationSyntheticParseMessagePack);
+
+	std::cout << "Synthetic size (bytes): " << syntheticJsonSize << " JSON, " << syntheticCborSize
+			  << " CBOR, " << syntheticMessagePackSize << " MessagePack" << std::endl;
+
+	for (auto& [name, durations] : durationParseJSON)
+	{
+		outputSegment(name, durations);
+	}
+
+	for (size_t i = 0; i < c_fragmentDepths.size(); ++i)
+	{
+		const auto name = "Validate Fragments Depth "s + std::to_string(c_fragmentDepths[i]);
+
+		outputSegment(name, durationFragments[i]);
+	}
+
+	outputSegment("Churn Subscribe"sv, durationChurnSubscribe);
+	outputSegment("Churn Unsubscribe"sv, durationChurnUnsubscribe);
+
+	std::cout << "Subscribe allocations (bytes): "
+			  << (static_cast<double>(subscribeBytesParsed)
+					 / static_cast<double>(c_fanOutSubscriptions))
+			  << " average with a parsed query, "
+			  << (static_cast<double>(subscribeBytesShared)
+					 / static_cast<double>(c_fanOutSubscriptions))
+			  << " average with a shared document" << std::endl;
+
+	// Each subscription with its own parsed query keeps a copy of the AST and the fragments, and it
+	// also pays for a SubscriptionDocument which nothing else shares, so it retains a little more
+	// than before subscriptions could share a document.
+	std::cout << "Subscription memory (bytes): "
+			  << (static_cast<double>(subscribeLiveBytesParsed)
+					 / static_cast<double>(c_fanOutSubscriptions))
+			  << " retained per subscription with a parsed query, "
+			  << (static_cast<double>(subscribeLiveBytesShared)
+					 / static_cast<double>(c_fanOutSubscriptions))
+			  << " retained per subscription with a shared document" << std::endl;
+
+	for (size_t i = 0; i < fanOutModes.size(); ++i)
+	{
+		outputFanOut(std::get<0>(fanOutModes[i]),
+			c_fanOutEvents,
+			durationFanOut[i],
+			latencyFanOut[i]);
+	}
 
 	return 0;
 }
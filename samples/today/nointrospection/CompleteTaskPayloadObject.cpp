@@ -27,20 +27,24 @@ CompleteTaskPayload::CompleteTaskPayload(std::unique_ptr<const Concept> pimpl) n
 {
 }
 
-service::TypeNames CompleteTaskPayload::getTypeNames() const noexcept
+const service::TypeNames& CompleteTaskPayload::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(CompleteTaskPayload)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap CompleteTaskPayload::getResolvers() const noexcept
+const service::ResolverMap& CompleteTaskPayload::getResolvers() noexcept
 {
-	return {
-		{ R"gql(task)gql"sv, [this](service::ResolverParams&& params) { return resolveTask(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(clientMutationId)gql"sv, [this](service::ResolverParams&& params) { return resolveClientMutationId(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(task)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const CompleteTaskPayload&>(object).resolveTask(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const CompleteTaskPayload&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(clientMutationId)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const CompleteTaskPayload&>(object).resolveClientMutationId(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void CompleteTaskPayload::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -57,7 +61,7 @@ service::AwaitableResolver CompleteTaskPayload::resolveTask(service::ResolverPar
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getTask(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -68,7 +72,7 @@ service::AwaitableResolver CompleteTaskPayload::resolveClientMutationId(service:
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getClientMutationId(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
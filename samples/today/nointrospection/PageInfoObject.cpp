@@ -26,20 +26,24 @@ PageInfo::PageInfo(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames PageInfo::getTypeNames() const noexcept
+const service::TypeNames& PageInfo::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(PageInfo)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap PageInfo::getResolvers() const noexcept
+const service::ResolverMap& PageInfo::getResolvers() noexcept
 {
-	return {
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(hasNextPage)gql"sv, [this](service::ResolverParams&& params) { return resolveHasNextPage(std::move(params)); } },
-		{ R"gql(hasPreviousPage)gql"sv, [this](service::ResolverParams&& params) { return resolveHasPreviousPage(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const PageInfo&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(hasNextPage)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const PageInfo&>(object).resolveHasNextPage(std::move(params)); } },
+		{ R"gql(hasPreviousPage)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const PageInfo&>(object).resolveHasPreviousPage(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void PageInfo::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -56,7 +60,7 @@ service::AwaitableResolver PageInfo::resolveHasNextPage(service::ResolverParams&
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getHasNextPage(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -67,7 +71,7 @@ service::AwaitableResolver PageInfo::resolveHasPreviousPage(service::ResolverPar
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getHasPreviousPage(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -28,20 +28,24 @@ Subscription::Subscription(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Subscription::getTypeNames() const noexcept
+const service::TypeNames& Subscription::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Subscription)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Subscription::getResolvers() const noexcept
+const service::ResolverMap& Subscription::getResolvers() noexcept
 {
-	return {
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(nodeChange)gql"sv, [this](service::ResolverParams&& params) { return resolveNodeChange(std::move(params)); } },
-		{ R"gql(nextAppointmentChange)gql"sv, [this](service::ResolverParams&& params) { return resolveNextAppointmentChange(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(nodeChange)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolveNodeChange(std::move(params)); } },
+		{ R"gql(nextAppointmentChange)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolveNextAppointmentChange(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Subscription::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -58,7 +62,7 @@ service::AwaitableResolver Subscription::resolveNextAppointmentChange(service::R
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNextAppointmentChange(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -70,7 +74,7 @@ service::AwaitableResolver Subscription::resolveNodeChange(service::ResolverPara
 	auto argId = service::ModifiedArgument<response::IdType>::require("id", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNodeChange(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argId));
 	resolverLock.unlock();
 
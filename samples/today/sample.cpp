@@ -9,9 +9,12 @@
 #include <iostream>
 #include <iterator>
 #include <stdexcept>
+#include <string_view>
 
 using namespace graphql;
 
+using namespace std::literals;
+
 int main(int argc, char** argv)
 {
 	const auto mockService = today::mock_service();
@@ -19,6 +22,16 @@ int main(int argc, char** argv)
 
 	std::cout << "Created the service..." << std::endl;
 
+	// Pass --incremental to print the initial response and each of the @defer and @stream
+	// payloads on separate lines.
+	const bool incremental = (argc > 1 && argv[1] == "--incremental"sv);
+
+	if (incremental)
+	{
+		--argc;
+		++argv;
+	}
+
 	try
 	{
 		peg::ast ast;
@@ -44,8 +57,21 @@ int main(int argc, char** argv)
 
 		std::cout << "Executing query..." << std::endl;
 
-		std::cout << response::toJSON(service->resolve({ ast, ((argc > 2) ? argv[2] : "") }).get())
-				  << std::endl;
+		if (incremental)
+		{
+			service
+				->resolveIncremental({ ast, ((argc > 2) ? argv[2] : "") },
+					[](response::Value&& payload) {
+						std::cout << response::toJSON(std::move(payload)) << std::endl;
+					})
+				.get();
+		}
+		else
+		{
+			std::cout << response::toJSON(
+				service->resolve({ ast, ((argc > 2) ? argv[2] : "") }).get())
+					  << std::endl;
+		}
 	}
 	catch (const std::runtime_error& ex)
 	{
@@ -26,19 +26,23 @@ Expensive::Expensive(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Expensive::getTypeNames() const noexcept
+const service::TypeNames& Expensive::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Expensive)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Expensive::getResolvers() const noexcept
+const service::ResolverMap& Expensive::getResolvers() noexcept
 {
-	return {
-		{ R"gql(order)gql"sv, [this](service::ResolverParams&& params) { return resolveOrder(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(order)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Expensive&>(object).resolveOrder(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Expensive&>(object).resolve_typename(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Expensive::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -55,7 +59,7 @@ service::AwaitableResolver Expensive::resolveOrder(service::ResolverParams&& par
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getOrder(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -26,23 +26,27 @@ Folder::Folder(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Folder::getTypeNames() const noexcept
+const service::TypeNames& Folder::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Node)gql"sv,
 		R"gql(UnionType)gql"sv,
 		R"gql(Folder)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Folder::getResolvers() const noexcept
+const service::ResolverMap& Folder::getResolvers() noexcept
 {
-	return {
-		{ R"gql(id)gql"sv, [this](service::ResolverParams&& params) { return resolveId(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(unreadCount)gql"sv, [this](service::ResolverParams&& params) { return resolveUnreadCount(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(id)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Folder&>(object).resolveId(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Folder&>(object).resolveName(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Folder&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(unreadCount)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Folder&>(object).resolveUnreadCount(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Folder::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -59,7 +63,7 @@ service::AwaitableResolver Folder::resolveId(service::ResolverParams&& params) c
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getId(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -70,7 +74,7 @@ service::AwaitableResolver Folder::resolveName(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -81,7 +85,7 @@ service::AwaitableResolver Folder::resolveUnreadCount(service::ResolverParams&&
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getUnreadCount(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -27,20 +27,24 @@ Mutation::Mutation(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Mutation::getTypeNames() const noexcept
+const service::TypeNames& Mutation::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Mutation)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Mutation::getResolvers() const noexcept
+const service::ResolverMap& Mutation::getResolvers() noexcept
 {
-	return {
-		{ R"gql(setFloat)gql"sv, [this](service::ResolverParams&& params) { return resolveSetFloat(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(completeTask)gql"sv, [this](service::ResolverParams&& params) { return resolveCompleteTask(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(setFloat)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Mutation&>(object).resolveSetFloat(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Mutation&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(completeTask)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Mutation&>(object).resolveCompleteTask(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Mutation::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -58,7 +62,7 @@ service::AwaitableResolver Mutation::resolveCompleteTask(service::ResolverParams
 	auto argInput = service::ModifiedArgument<today::CompleteTaskInput>::require("input", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->applyCompleteTask(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argInput));
 	resolverLock.unlock();
 
@@ -70,7 +74,7 @@ service::AwaitableResolver Mutation::resolveSetFloat(service::ResolverParams&& p
 	auto argValue = service::ModifiedArgument<double>::require("value", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->applySetFloat(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argValue));
 	resolverLock.unlock();
 
@@ -27,20 +27,24 @@ NestedType::NestedType(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames NestedType::getTypeNames() const noexcept
+const service::TypeNames& NestedType::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(NestedType)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap NestedType::getResolvers() const noexcept
+const service::ResolverMap& NestedType::getResolvers() noexcept
 {
-	return {
-		{ R"gql(depth)gql"sv, [this](service::ResolverParams&& params) { return resolveDepth(std::move(params)); } },
-		{ R"gql(nested)gql"sv, [this](service::ResolverParams&& params) { return resolveNested(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(depth)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const NestedType&>(object).resolveDepth(std::move(params)); } },
+		{ R"gql(nested)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const NestedType&>(object).resolveNested(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const NestedType&>(object).resolve_typename(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void NestedType::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -57,7 +61,7 @@ service::AwaitableResolver NestedType::resolveDepth(service::ResolverParams&& pa
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getDepth(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -68,7 +72,7 @@ service::AwaitableResolver NestedType::resolveNested(service::ResolverParams&& p
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNested(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
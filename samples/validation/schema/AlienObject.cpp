@@ -26,22 +26,26 @@ Alien::Alien(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Alien::getTypeNames() const noexcept
+const service::TypeNames& Alien::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Sentient)gql"sv,
 		R"gql(HumanOrAlien)gql"sv,
 		R"gql(Alien)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Alien::getResolvers() const noexcept
+const service::ResolverMap& Alien::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(homePlanet)gql"sv, [this](service::ResolverParams&& params) { return resolveHomePlanet(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Alien&>(object).resolveName(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Alien&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(homePlanet)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Alien&>(object).resolveHomePlanet(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Alien::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -58,7 +62,7 @@ service::AwaitableResolver Alien::resolveName(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -69,7 +73,7 @@ service::AwaitableResolver Alien::resolveHomePlanet(service::ResolverParams&& pa
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getHomePlanet(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -26,26 +26,30 @@ Arguments::Arguments(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Arguments::getTypeNames() const noexcept
+const service::TypeNames& Arguments::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Arguments)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Arguments::getResolvers() const noexcept
+const service::ResolverMap& Arguments::getResolvers() noexcept
 {
-	return {
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(intArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveIntArgField(std::move(params)); } },
-		{ R"gql(multipleReqs)gql"sv, [this](service::ResolverParams&& params) { return resolveMultipleReqs(std::move(params)); } },
-		{ R"gql(floatArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveFloatArgField(std::move(params)); } },
-		{ R"gql(booleanArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveBooleanArgField(std::move(params)); } },
-		{ R"gql(booleanListArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveBooleanListArgField(std::move(params)); } },
-		{ R"gql(nonNullBooleanArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveNonNullBooleanArgField(std::move(params)); } },
-		{ R"gql(nonNullBooleanListField)gql"sv, [this](service::ResolverParams&& params) { return resolveNonNullBooleanListField(std::move(params)); } },
-		{ R"gql(optionalNonNullBooleanArgField)gql"sv, [this](service::ResolverParams&& params) { return resolveOptionalNonNullBooleanArgField(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(intArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveIntArgField(std::move(params)); } },
+		{ R"gql(multipleReqs)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveMultipleReqs(std::move(params)); } },
+		{ R"gql(floatArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveFloatArgField(std::move(params)); } },
+		{ R"gql(booleanArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveBooleanArgField(std::move(params)); } },
+		{ R"gql(booleanListArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveBooleanListArgField(std::move(params)); } },
+		{ R"gql(nonNullBooleanArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveNonNullBooleanArgField(std::move(params)); } },
+		{ R"gql(nonNullBooleanListField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveNonNullBooleanListField(std::move(params)); } },
+		{ R"gql(optionalNonNullBooleanArgField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Arguments&>(object).resolveOptionalNonNullBooleanArgField(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Arguments::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -64,7 +68,7 @@ service::AwaitableResolver Arguments::resolveMultipleReqs(service::ResolverParam
 	auto argY = service::ModifiedArgument<int>::require("y", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getMultipleReqs(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argX), std::move(argY));
 	resolverLock.unlock();
 
@@ -76,7 +80,7 @@ service::AwaitableResolver Arguments::resolveBooleanArgField(service::ResolverPa
 	auto argBooleanArg = service::ModifiedArgument<bool>::require<service::TypeModifier::Nullable>("booleanArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getBooleanArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argBooleanArg));
 	resolverLock.unlock();
 
@@ -88,7 +92,7 @@ service::AwaitableResolver Arguments::resolveFloatArgField(service::ResolverPara
 	auto argFloatArg = service::ModifiedArgument<double>::require<service::TypeModifier::Nullable>("floatArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getFloatArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argFloatArg));
 	resolverLock.unlock();
 
@@ -100,7 +104,7 @@ service::AwaitableResolver Arguments::resolveIntArgField(service::ResolverParams
 	auto argIntArg = service::ModifiedArgument<int>::require<service::TypeModifier::Nullable>("intArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getIntArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argIntArg));
 	resolverLock.unlock();
 
@@ -112,7 +116,7 @@ service::AwaitableResolver Arguments::resolveNonNullBooleanArgField(service::Res
 	auto argNonNullBooleanArg = service::ModifiedArgument<bool>::require("nonNullBooleanArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNonNullBooleanArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argNonNullBooleanArg));
 	resolverLock.unlock();
 
@@ -124,7 +128,7 @@ service::AwaitableResolver Arguments::resolveNonNullBooleanListField(service::Re
 	auto argNonNullBooleanListArg = service::ModifiedArgument<bool>::require<service::TypeModifier::Nullable, service::TypeModifier::List>("nonNullBooleanListArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNonNullBooleanListField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argNonNullBooleanListArg));
 	resolverLock.unlock();
 
@@ -136,7 +140,7 @@ service::AwaitableResolver Arguments::resolveBooleanListArgField(service::Resolv
 	auto argBooleanListArg = service::ModifiedArgument<bool>::require<service::TypeModifier::List, service::TypeModifier::Nullable>("booleanListArg", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getBooleanListArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argBooleanListArg));
 	resolverLock.unlock();
 
@@ -162,7 +166,7 @@ service::AwaitableResolver Arguments::resolveOptionalNonNullBooleanArgField(serv
 		: service::ModifiedArgument<bool>::require("optionalBooleanArg", defaultArguments));
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getOptionalNonNullBooleanArgField(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argOptionalBooleanArg));
 	resolverLock.unlock();
 
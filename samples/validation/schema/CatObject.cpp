@@ -26,24 +26,28 @@ Cat::Cat(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Cat::getTypeNames() const noexcept
+const service::TypeNames& Cat::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Pet)gql"sv,
 		R"gql(CatOrDog)gql"sv,
 		R"gql(Cat)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Cat::getResolvers() const noexcept
+const service::ResolverMap& Cat::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(nickname)gql"sv, [this](service::ResolverParams&& params) { return resolveNickname(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(meowVolume)gql"sv, [this](service::ResolverParams&& params) { return resolveMeowVolume(std::move(params)); } },
-		{ R"gql(doesKnowCommand)gql"sv, [this](service::ResolverParams&& params) { return resolveDoesKnowCommand(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Cat&>(object).resolveName(std::move(params)); } },
+		{ R"gql(nickname)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Cat&>(object).resolveNickname(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Cat&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(meowVolume)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Cat&>(object).resolveMeowVolume(std::move(params)); } },
+		{ R"gql(doesKnowCommand)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Cat&>(object).resolveDoesKnowCommand(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Cat::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -60,7 +64,7 @@ service::AwaitableResolver Cat::resolveName(service::ResolverParams&& params) co
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -71,7 +75,7 @@ service::AwaitableResolver Cat::resolveNickname(service::ResolverParams&& params
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNickname(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -83,7 +87,7 @@ service::AwaitableResolver Cat::resolveDoesKnowCommand(service::ResolverParams&&
 	auto argCatCommand = service::ModifiedArgument<CatCommand>::require("catCommand", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getDoesKnowCommand(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argCatCommand));
 	resolverLock.unlock();
 
@@ -94,7 +98,7 @@ service::AwaitableResolver Cat::resolveMeowVolume(service::ResolverParams&& para
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getMeowVolume(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -27,27 +27,31 @@ Dog::Dog(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Dog::getTypeNames() const noexcept
+const service::TypeNames& Dog::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Pet)gql"sv,
 		R"gql(CatOrDog)gql"sv,
 		R"gql(DogOrHuman)gql"sv,
 		R"gql(Dog)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Dog::getResolvers() const noexcept
+const service::ResolverMap& Dog::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(owner)gql"sv, [this](service::ResolverParams&& params) { return resolveOwner(std::move(params)); } },
-		{ R"gql(nickname)gql"sv, [this](service::ResolverParams&& params) { return resolveNickname(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(barkVolume)gql"sv, [this](service::ResolverParams&& params) { return resolveBarkVolume(std::move(params)); } },
-		{ R"gql(isHousetrained)gql"sv, [this](service::ResolverParams&& params) { return resolveIsHousetrained(std::move(params)); } },
-		{ R"gql(doesKnowCommand)gql"sv, [this](service::ResolverParams&& params) { return resolveDoesKnowCommand(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveName(std::move(params)); } },
+		{ R"gql(owner)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveOwner(std::move(params)); } },
+		{ R"gql(nickname)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveNickname(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(barkVolume)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveBarkVolume(std::move(params)); } },
+		{ R"gql(isHousetrained)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveIsHousetrained(std::move(params)); } },
+		{ R"gql(doesKnowCommand)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Dog&>(object).resolveDoesKnowCommand(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Dog::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -64,7 +68,7 @@ service::AwaitableResolver Dog::resolveName(service::ResolverParams&& params) co
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -75,7 +79,7 @@ service::AwaitableResolver Dog::resolveNickname(service::ResolverParams&& params
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNickname(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -86,7 +90,7 @@ service::AwaitableResolver Dog::resolveBarkVolume(service::ResolverParams&& para
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getBarkVolume(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -98,7 +102,7 @@ service::AwaitableResolver Dog::resolveDoesKnowCommand(service::ResolverParams&&
 	auto argDogCommand = service::ModifiedArgument<DogCommand>::require("dogCommand", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getDoesKnowCommand(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argDogCommand));
 	resolverLock.unlock();
 
@@ -110,7 +114,7 @@ service::AwaitableResolver Dog::resolveIsHousetrained(service::ResolverParams&&
 	auto argAtOtherHomes = service::ModifiedArgument<bool>::require<service::TypeModifier::Nullable>("atOtherHomes", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getIsHousetrained(service::FieldParams { std::move(selectionSetParams), std::move(directives) }, std::move(argAtOtherHomes));
 	resolverLock.unlock();
 
@@ -121,7 +125,7 @@ service::AwaitableResolver Dog::resolveOwner(service::ResolverParams&& params) c
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getOwner(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -143,7 +147,7 @@ void AddDogDetails(const std::shared_ptr<schema::ObjectType>& typeDog, const std
 	typeDog->AddFields({
 		schema::Field::Make(R"gql(name)gql"sv, R"md()md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(String)gql"sv))),
 		schema::Field::Make(R"gql(nickname)gql"sv, R"md()md"sv, std::nullopt, schema->LookupType(R"gql(String)gql"sv)),
-		schema::Field::Make(R"gql(barkVolume)gql"sv, R"md()md"sv, std::nullopt, schema->LookupType(R"gql(Int)gql"sv)),
+		schema::Field::Make(R"gql(barkVolume)gql"sv, R"md()md"sv, std::nullopt, schema->LookupType(R"gql(Int)gql"sv), {}, { 5, { } }),
 		schema::Field::Make(R"gql(doesKnowCommand)gql"sv, R"md()md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Boolean)gql"sv)), {
 			schema::InputValue::Make(R"gql(dogCommand)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(DogCommand)gql"sv)), R"gql()gql"sv)
 		}),
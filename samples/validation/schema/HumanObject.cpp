@@ -27,23 +27,27 @@ Human::Human(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Human::getTypeNames() const noexcept
+const service::TypeNames& Human::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Sentient)gql"sv,
 		R"gql(DogOrHuman)gql"sv,
 		R"gql(HumanOrAlien)gql"sv,
 		R"gql(Human)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Human::getResolvers() const noexcept
+const service::ResolverMap& Human::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(pets)gql"sv, [this](service::ResolverParams&& params) { return resolvePets(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolveName(std::move(params)); } },
+		{ R"gql(pets)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolvePets(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Human&>(object).resolve_typename(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Human::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -60,7 +64,7 @@ service::AwaitableResolver Human::resolveName(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getName(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -71,7 +75,7 @@ service::AwaitableResolver Human::resolvePets(service::ResolverParams&& params)
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getPets(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -26,20 +26,24 @@ Message::Message(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Message::getTypeNames() const noexcept
+const service::TypeNames& Message::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Message)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Message::getResolvers() const noexcept
+const service::ResolverMap& Message::getResolvers() noexcept
 {
-	return {
-		{ R"gql(body)gql"sv, [this](service::ResolverParams&& params) { return resolveBody(std::move(params)); } },
-		{ R"gql(sender)gql"sv, [this](service::ResolverParams&& params) { return resolveSender(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(body)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Message&>(object).resolveBody(std::move(params)); } },
+		{ R"gql(sender)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Message&>(object).resolveSender(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Message&>(object).resolve_typename(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Message::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -56,7 +60,7 @@ service::AwaitableResolver Message::resolveBody(service::ResolverParams&& params
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getBody(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -67,7 +71,7 @@ service::AwaitableResolver Message::resolveSender(service::ResolverParams&& para
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getSender(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
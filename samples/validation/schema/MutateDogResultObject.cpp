@@ -26,19 +26,23 @@ MutateDogResult::MutateDogResult(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames MutateDogResult::getTypeNames() const noexcept
+const service::TypeNames& MutateDogResult::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(MutateDogResult)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap MutateDogResult::getResolvers() const noexcept
+const service::ResolverMap& MutateDogResult::getResolvers() noexcept
 {
-	return {
-		{ R"gql(id)gql"sv, [this](service::ResolverParams&& params) { return resolveId(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(id)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const MutateDogResult&>(object).resolveId(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const MutateDogResult&>(object).resolve_typename(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void MutateDogResult::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -55,7 +59,7 @@ service::AwaitableResolver MutateDogResult::resolveId(service::ResolverParams&&
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getId(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -109,6 +109,18 @@ concept getBooleanList = requires (TImpl impl, std::optional<std::vector<bool>>
 	{ service::AwaitableScalar<std::optional<bool>> { impl.getBooleanList(std::move(booleanListArgArg)) } };
 };
 
+template <class TImpl>
+concept getDogsWithParams = requires (TImpl impl, service::FieldParams params, std::optional<int> firstArg, std::optional<int> lastArg)
+{
+	{ service::AwaitableObject<std::vector<std::shared_ptr<Dog>>> { impl.getDogs(std::move(params), std::move(firstArg), std::move(lastArg)) } };
+};
+
+template <class TImpl>
+concept getDogs = requires (TImpl impl, std::optional<int> firstArg, std::optional<int> lastArg)
+{
+	{ service::AwaitableObject<std::vector<std::shared_ptr<Dog>>> { impl.getDogs(std::move(firstArg), std::move(lastArg)) } };
+};
+
 template <class TImpl>
 concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
 {
@@ -135,6 +147,7 @@ private:
 	[[nodiscard("unnecessary call")]] service::AwaitableResolver resolveResource(service::ResolverParams&& params) const;
 	[[nodiscard("unnecessary call")]] service::AwaitableResolver resolveFindDog(service::ResolverParams&& params) const;
 	[[nodiscard("unnecessary call")]] service::AwaitableResolver resolveBooleanList(service::ResolverParams&& params) const;
+	[[nodiscard("unnecessary call")]] service::AwaitableResolver resolveDogs(service::ResolverParams&& params) const;
 
 	[[nodiscard("unnecessary call")]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
 
@@ -153,6 +166,7 @@ private:
 		[[nodiscard("unnecessary call")]] virtual service::AwaitableObject<std::shared_ptr<Resource>> getResource(service::FieldParams&& params) const = 0;
 		[[nodiscard("unnecessary call")]] virtual service::AwaitableObject<std::shared_ptr<Dog>> getFindDog(service::FieldParams&& params, std::unique_ptr<ComplexInput>&& complexArg) const = 0;
 		[[nodiscard("unnecessary call")]] virtual service::AwaitableScalar<std::optional<bool>> getBooleanList(service::FieldParams&& params, std::optional<std::vector<bool>>&& booleanListArgArg) const = 0;
+		[[nodiscard("unnecessary call")]] virtual service::AwaitableObject<std::vector<std::shared_ptr<Dog>>> getDogs(service::FieldParams&& params, std::optional<int>&& firstArg, std::optional<int>&& lastArg) const = 0;
 	};
 
 	template <class T>
@@ -292,6 +306,22 @@ private:
 			}
 		}
 
+		[[nodiscard("unnecessary call")]] service::AwaitableObject<std::vector<std::shared_ptr<Dog>>> getDogs(service::FieldParams&& params, std::optional<int>&& firstArg, std::optional<int>&& lastArg) const override
+		{
+			if constexpr (methods::QueryHas::getDogsWithParams<T>)
+			{
+				return { _pimpl->getDogs(std::move(params), std::move(firstArg), std::move(lastArg)) };
+			}
+			else if constexpr (methods::QueryHas::getDogs<T>)
+			{
+				return { _pimpl->getDogs(std::move(firstArg), std::move(lastArg)) };
+			}
+			else
+			{
+				throw service::unimplemented_method(R"ex(Query::getDogs)ex");
+			}
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const override
 		{
 			if constexpr (methods::QueryHas::beginSelectionSet<T>)
@@ -314,8 +344,8 @@ private:
 
 	explicit Query(std::unique_ptr<const Concept> pimpl) noexcept;
 
-	[[nodiscard("unnecessary call")]] service::TypeNames getTypeNames() const noexcept;
-	[[nodiscard("unnecessary call")]] service::ResolverMap getResolvers() const noexcept;
+	[[nodiscard("unnecessary call")]] static const service::TypeNames& getTypeNames() noexcept;
+	[[nodiscard("unnecessary call")]] static const service::ResolverMap& getResolvers() noexcept;
 
 	void beginSelectionSet(const service::SelectionSetParams& params) const override;
 	void endSelectionSet(const service::SelectionSetParams& params) const override;
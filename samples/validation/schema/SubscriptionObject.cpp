@@ -27,20 +27,24 @@ Subscription::Subscription(std::unique_ptr<const Concept> pimpl) noexcept
 {
 }
 
-service::TypeNames Subscription::getTypeNames() const noexcept
+const service::TypeNames& Subscription::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(Subscription)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Subscription::getResolvers() const noexcept
+const service::ResolverMap& Subscription::getResolvers() noexcept
 {
-	return {
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(newMessage)gql"sv, [this](service::ResolverParams&& params) { return resolveNewMessage(std::move(params)); } },
-		{ R"gql(disallowedSecondRootField)gql"sv, [this](service::ResolverParams&& params) { return resolveDisallowedSecondRootField(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(newMessage)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolveNewMessage(std::move(params)); } },
+		{ R"gql(disallowedSecondRootField)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Subscription&>(object).resolveDisallowedSecondRootField(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 void Subscription::beginSelectionSet(const service::SelectionSetParams& params) const
@@ -57,7 +61,7 @@ service::AwaitableResolver Subscription::resolveNewMessage(service::ResolverPara
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getNewMessage(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -68,7 +72,7 @@ service::AwaitableResolver Subscription::resolveDisallowedSecondRootField(servic
 {
 	std::unique_lock resolverLock(_resolverMutex);
 	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 	auto result = _pimpl->getDisallowedSecondRootField(service::FieldParams { std::move(selectionSetParams), std::move(directives) });
 	resolverLock.unlock();
 
@@ -305,6 +305,13 @@ void AddTypesToSchema(const std::shared_ptr<schema::Schema>& schema)
 	AddMessageDetails(typeMessage, schema);
 	AddArgumentsDetails(typeArguments, schema);
 
+	schema->AddDirective(schema::Directive::Make(R"gql(cost)gql"sv, R"md()md"sv, {
+		introspection::DirectiveLocation::FIELD_DEFINITION
+	}, {
+		schema::InputValue::Make(R"gql(weight)gql"sv, R"md()md"sv, schema->LookupType(R"gql(Int)gql"sv), R"gql()gql"sv),
+		schema::InputValue::Make(R"gql(multipliers)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(String)gql"sv))), R"gql()gql"sv)
+	}, false));
+
 	schema->AddQueryType(typeQuery);
 	schema->AddMutationType(typeMutation);
 	schema->AddSubscriptionType(typeSubscription);
@@ -0,0 +1,979 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "graphqlservice/BinaryResponse.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace graphql::response {
+namespace {
+
+template <class Output>
+void appendBigEndian(Output& output, std::uint64_t value, size_t bytes)
+{
+	for (auto shift = bytes * 8; shift > 0; shift -= 8)
+	{
+		output.push_back(static_cast<std::uint8_t>(value >> (shift - 8)));
+	}
+}
+
+void appendBytes(BinaryData& output, const std::uint8_t* data, size_t length)
+{
+	output.insert(output.end(), data, data + length);
+}
+
+// The largest header which either encoding uses for a map or a list, which is 1 byte for the type
+// followed by a 4 byte count.
+constexpr size_t c_maxHeaderSize = 5;
+
+struct HeaderBuffer
+{
+	void push_back(std::uint8_t value) noexcept
+	{
+		bytes[size++] = value;
+	}
+
+	std::array<std::uint8_t, c_maxHeaderSize> bytes {};
+	size_t size = 0;
+};
+
+struct CBOREncoding
+{
+	enum MajorType : std::uint8_t
+	{
+		UnsignedInt = 0,
+		NegativeInt = 1,
+		ByteString = 2,
+		TextString = 3,
+		Array = 4,
+		Map = 5,
+		Tag = 6,
+		Simple = 7,
+	};
+
+	template <class Output>
+	static void writeHead(Output& output, MajorType major, std::uint64_t argument)
+	{
+		const auto type = static_cast<std::uint8_t>(major << 5);
+
+		if (argument < 24)
+		{
+			output.push_back(static_cast<std::uint8_t>(type | argument));
+		}
+		else if (argument <= std::numeric_limits<std::uint8_t>::max())
+		{
+			output.push_back(type | 24);
+			appendBigEndian(output, argument, 1);
+		}
+		else if (argument <= std::numeric_limits<std::uint16_t>::max())
+		{
+			output.push_back(type | 25);
+			appendBigEndian(output, argument, 2);
+		}
+		else if (argument <= std::numeric_limits<std::uint32_t>::max())
+		{
+			output.push_back(type | 26);
+			appendBigEndian(output, argument, 4);
+		}
+		else
+		{
+			output.push_back(type | 27);
+			appendBigEndian(output, argument, 8);
+		}
+	}
+
+	static void writeContainer(HeaderBuffer& header, bool map, size_t count)
+	{
+		writeHead(header, map ? Map : Array, count);
+	}
+
+	static void writeNull(BinaryData& output)
+	{
+		output.push_back(0xF6);
+	}
+
+	static void writeBool(BinaryData& output, bool value)
+	{
+		output.push_back(value ? 0xF5 : 0xF4);
+	}
+
+	static void writeInt(BinaryData& output, int value)
+	{
+		if (value >= 0)
+		{
+			writeHead(output, UnsignedInt, static_cast<std::uint64_t>(value));
+		}
+		else
+		{
+			writeHead(output, NegativeInt, static_cast<std::uint64_t>(-1 - std::int64_t { value }));
+		}
+	}
+
+	static void writeFloat(BinaryData& output, double value)
+	{
+		output.push_back(0xFB);
+		appendBigEndian(output, std::bit_cast<std::uint64_t>(value), 8);
+	}
+
+	static void writeString(BinaryData& output, std::string_view value)
+	{
+		writeHead(output, TextString, value.size());
+		appendBytes(output, reinterpret_cast<const std::uint8_t*>(value.data()), value.size());
+	}
+
+	static void writeBytes(BinaryData& output, const IdType::ByteData& value)
+	{
+		writeHead(output, ByteString, value.size());
+		appendBytes(output, value.data(), value.size());
+	}
+};
+
+struct MessagePackEncoding
+{
+	static void writeContainer(HeaderBuffer& header, bool map, size_t count)
+	{
+		if (count < 16)
+		{
+			header.push_back(static_cast<std::uint8_t>((map ? 0x80 : 0x90) | count));
+		}
+		else if (count <= std::numeric_limits<std::uint16_t>::max())
+		{
+			header.push_back(map ? 0xDE : 0xDC);
+			appendBigEndian(header, count, 2);
+		}
+		else
+		{
+			header.push_back(map ? 0xDF : 0xDD);
+			appendBigEndian(header, count, 4);
+		}
+	}
+
+	static void writeNull(BinaryData& output)
+	{
+		output.push_back(0xC0);
+	}
+
+	static void writeBool(BinaryData& output, bool value)
+	{
+		output.push_back(value ? 0xC3 : 0xC2);
+	}
+
+	static void writeInt(BinaryData& output, int value)
+	{
+		if (value >= 0)
+		{
+			if (value <= 0x7F)
+			{
+				output.push_back(static_cast<std::uint8_t>(value));
+			}
+			else if (value <= std::numeric_limits<std::uint8_t>::max())
+			{
+				output.push_back(0xCC);
+				appendBigEndian(output, static_cast<std::uint64_t>(value), 1);
+			}
+			else if (value <= std::numeric_limits<std::uint16_t>::max())
+			{
+				output.push_back(0xCD);
+				appendBigEndian(output, static_cast<std::uint64_t>(value), 2);
+			}
+			else
+			{
+				output.push_back(0xCE);
+				appendBigEndian(output, static_cast<std::uint64_t>(value), 4);
+			}
+		}
+		else
+		{
+			const auto bits = static_cast<std::uint32_t>(value);
+
+			if (value >= -32)
+			{
+				output.push_back(static_cast<std::uint8_t>(bits));
+			}
+			else if (value >= std::numeric_limits<std::int8_t>::min())
+			{
+				output.push_back(0xD0);
+				appendBigEndian(output, bits, 1);
+			}
+			else if (value >= std::numeric_limits<std::int16_t>::min())
+			{
+				output.push_back(0xD1);
+				appendBigEndian(output, bits, 2);
+			}
+			else
+			{
+				output.push_back(0xD2);
+				appendBigEndian(output, bits, 4);
+			}
+		}
+	}
+
+	static void writeFloat(BinaryData& output, double value)
+	{
+		output.push_back(0xCB);
+		appendBigEndian(output, std::bit_cast<std::uint64_t>(value), 8);
+	}
+
+	static void writeString(BinaryData& output, std::string_view value)
+	{
+		const auto length = value.size();
+
+		if (length < 32)
+		{
+			output.push_back(static_cast<std::uint8_t>(0xA0 | length));
+		}
+		else if (length <= std::numeric_limits<std::uint8_t>::max())
+		{
+			output.push_back(0xD9);
+			appendBigEndian(output, length, 1);
+		}
+		else if (length <= std::numeric_limits<std::uint16_t>::max())
+		{
+			output.push_back(0xDA);
+			appendBigEndian(output, length, 2);
+		}
+		else if (length <= std::numeric_limits<std::uint32_t>::max())
+		{
+			output.push_back(0xDB);
+			appendBigEndian(output, length, 4);
+		}
+		else
+		{
+			throw std::length_error("String is too long for MessagePack");
+		}
+
+		appendBytes(output, reinterpret_cast<const std::uint8_t*>(value.data()), length);
+	}
+
+	static void writeBytes(BinaryData& output, const IdType::ByteData& value)
+	{
+		const auto length = value.size();
+
+		if (length <= std::numeric_limits<std::uint8_t>::max())
+		{
+			output.push_back(0xC4);
+			appendBigEndian(output, length, 1);
+		}
+		else if (length <= std::numeric_limits<std::uint16_t>::max())
+		{
+			output.push_back(0xC5);
+			appendBigEndian(output, length, 2);
+		}
+		else if (length <= std::numeric_limits<std::uint32_t>::max())
+		{
+			output.push_back(0xC6);
+			appendBigEndian(output, length, 4);
+		}
+		else
+		{
+			throw std::length_error("ID is too long for MessagePack");
+		}
+
+		appendBytes(output, value.data(), length);
+	}
+};
+
+// Both encodings need the number of members or elements before the contents of a map or list, but
+// response::Writer only tells us when it ends. Each map or list starts with room for the largest
+// header, which is shrunk to fit the count in end_object or end_arrary.
+template <class Encoding>
+class BinaryWriter
+{
+public:
+	explicit BinaryWriter(BinaryData& output) noexcept
+		: _output { output }
+	{
+	}
+
+	void start_object()
+	{
+		startContainer(true);
+	}
+
+	void add_member(std::string_view key)
+	{
+		++_containers.back().count;
+		Encoding::writeString(_output, key);
+	}
+
+	void end_object()
+	{
+		endContainer();
+	}
+
+	void start_array()
+	{
+		startContainer(false);
+	}
+
+	void end_arrary()
+	{
+		endContainer();
+	}
+
+	void write_null()
+	{
+		addElement();
+		Encoding::writeNull(_output);
+	}
+
+	void write_string(const std::string& value)
+	{
+		addElement();
+		Encoding::writeString(_output, value);
+	}
+
+	void write_id(IdType&& value)
+	{
+		addElement();
+
+		if (value.isBase64())
+		{
+			Encoding::writeBytes(_output, value.release<IdType::ByteData>());
+		}
+		else
+		{
+			Encoding::writeString(_output, value.release<IdType::OpaqueString>());
+		}
+	}
+
+	void write_bool(bool value)
+	{
+		addElement();
+		Encoding::writeBool(_output, value);
+	}
+
+	void write_int(int value)
+	{
+		addElement();
+		Encoding::writeInt(_output, value);
+	}
+
+	void write_float(double value)
+	{
+		addElement();
+		Encoding::writeFloat(_output, value);
+	}
+
+private:
+	struct Container
+	{
+		size_t offset;
+		bool map;
+		size_t count = 0;
+	};
+
+	// Map values are counted in add_member, list elements are counted as they are written.
+	void addElement()
+	{
+		if (!_containers.empty() && !_containers.back().map)
+		{
+			++_containers.back().count;
+		}
+	}
+
+	void startContainer(bool map)
+	{
+		addElement();
+		_containers.push_back({ _output.size(), map });
+		_output.resize(_output.size() + c_maxHeaderSize);
+	}
+
+	void endContainer()
+	{
+		const auto container = _containers.back();
+
+		_containers.pop_back();
+
+		if (container.count > std::numeric_limits<std::uint32_t>::max())
+		{
+			throw std::length_error("Too many members or elements");
+		}
+
+		HeaderBuffer header;
+
+		Encoding::writeContainer(header, container.map, container.count);
+
+		const auto itr = _output.begin() + static_cast<std::ptrdiff_t>(container.offset);
+
+		std::copy_n(header.bytes.cbegin(), header.size, itr);
+		_output.erase(itr + static_cast<std::ptrdiff_t>(header.size),
+			itr + static_cast<std::ptrdiff_t>(c_maxHeaderSize));
+	}
+
+	BinaryData& _output;
+	std::vector<Container> _containers;
+};
+
+class BinaryReader
+{
+protected:
+	// Each map or list is at least 1 byte, so limit the depth to keep a small malicious document
+	// from overflowing the stack.
+	static constexpr size_t c_maxDepth = 512;
+
+	BinaryReader(const BinaryData& data, std::string_view format) noexcept
+		: _data { data }
+		, _format { format }
+	{
+	}
+
+	[[noreturn]] void invalid() const
+	{
+		throw std::runtime_error("Invalid "s + std::string { _format } + " at offset "s
+			+ std::to_string(_position));
+	}
+
+	void checkDepth(size_t depth) const
+	{
+		if (depth > c_maxDepth)
+		{
+			invalid();
+		}
+	}
+
+	void checkComplete() const
+	{
+		if (_position != _data.size())
+		{
+			invalid();
+		}
+	}
+
+	std::uint8_t readByte()
+	{
+		if (_position >= _data.size())
+		{
+			invalid();
+		}
+
+		return _data[_position++];
+	}
+
+	std::uint64_t readBigEndian(size_t bytes)
+	{
+		std::uint64_t value = 0;
+
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			value = (value << 8) | readByte();
+		}
+
+		return value;
+	}
+
+	const std::uint8_t* readBytes(std::uint64_t length)
+	{
+		if (length > _data.size() - _position)
+		{
+			invalid();
+		}
+
+		const auto bytes = _data.data() + _position;
+
+		_position += static_cast<size_t>(length);
+
+		return bytes;
+	}
+
+	// Every member or element takes at least 1 byte, so don't reserve more than that.
+	size_t clampCount(std::uint64_t count) const noexcept
+	{
+		return static_cast<size_t>(
+			std::min(count, static_cast<std::uint64_t>(_data.size() - _position)));
+	}
+
+	Value readString(std::uint64_t length)
+	{
+		const auto bytes = readBytes(length);
+
+		return Value { std::string { reinterpret_cast<const char*>(bytes),
+						   static_cast<size_t>(length) } }
+			.from_json();
+	}
+
+	Value readId(std::uint64_t length)
+	{
+		const auto bytes = readBytes(length);
+
+		return Value { IdType { IdType::ByteData { bytes, bytes + length } } };
+	}
+
+	// https://spec.graphql.org/October2021/#sec-Int
+	static Value makeInt(std::int64_t value)
+	{
+		if (value < std::numeric_limits<IntType>::min()
+			|| value > std::numeric_limits<IntType>::max())
+		{
+			return Value { static_cast<FloatType>(value) };
+		}
+
+		return Value { static_cast<IntType>(value) };
+	}
+
+	static Value makeUnsigned(std::uint64_t value)
+	{
+		if (value > static_cast<std::uint64_t>(std::numeric_limits<IntType>::max()))
+		{
+			return Value { static_cast<FloatType>(value) };
+		}
+
+		return Value { static_cast<IntType>(value) };
+	}
+
+	static void addMember(Value& map, Value&& key, Value&& value)
+	{
+		if (key.type() != Type::String)
+		{
+			throw std::runtime_error("Map keys must be strings");
+		}
+
+		// Like parseJSON, ignore any duplicate members after the first one.
+		[[maybe_unused]] const auto added =
+			map.emplace_back(key.release<StringType>(), std::move(value));
+	}
+
+	const BinaryData& _data;
+	const std::string_view _format;
+	size_t _position = 0;
+};
+
+class CBORReader : BinaryReader
+{
+public:
+	explicit CBORReader(const BinaryData& cbor) noexcept
+		: BinaryReader { cbor, "CBOR"sv }
+	{
+	}
+
+	Value parse()
+	{
+		auto result = readValue(0);
+
+		checkComplete();
+
+		return result;
+	}
+
+private:
+	static constexpr std::uint8_t c_indefinite = 31;
+	static constexpr std::uint8_t c_break = 0xFF;
+
+	std::uint64_t readArgument(std::uint8_t info)
+	{
+		if (info < 24)
+		{
+			return info;
+		}
+		else if (info <= 27)
+		{
+			return readBigEndian(size_t { 1 } << (info - 24));
+		}
+
+		invalid();
+	}
+
+	bool readBreak()
+	{
+		if (_position < _data.size() && _data[_position] == c_break)
+		{
+			++_position;
+			return true;
+		}
+
+		return false;
+	}
+
+	Value readValue(size_t depth)
+	{
+		auto initial = readByte();
+
+		// There are no tags for any of the GraphQL types, so just use the tagged value. Skip them in
+		// a loop, since a long run of tags would overflow the stack if each of them recursed.
+		while ((initial >> 5) == CBOREncoding::Tag)
+		{
+			static_cast<void>(readArgument(initial & 0x1F));
+			initial = readByte();
+		}
+
+		const auto major = static_cast<CBOREncoding::MajorType>(initial >> 5);
+		const auto info = static_cast<std::uint8_t>(initial & 0x1F);
+
+		if (major == CBOREncoding::Simple)
+		{
+			return readSimple(info);
+		}
+		else if (info == c_indefinite)
+		{
+			return readIndefinite(major, depth);
+		}
+
+		const auto argument = readArgument(info);
+
+		switch (major)
+		{
+			case CBOREncoding::UnsignedInt:
+				return makeUnsigned(argument);
+
+			case CBOREncoding::NegativeInt:
+				if (argument > static_cast<std::uint64_t>(std::numeric_limits<IntType>::max()))
+				{
+					return Value { -1.0 - static_cast<FloatType>(argument) };
+				}
+
+				return makeInt(-1 - static_cast<std::int64_t>(argument));
+
+			case CBOREncoding::ByteString:
+				return readId(argument);
+
+			case CBOREncoding::TextString:
+				return readString(argument);
+
+			case CBOREncoding::Array:
+			{
+				Value list { Type::List };
+
+				checkDepth(depth + 1);
+				list.reserve(clampCount(argument));
+
+				for (std::uint64_t i = 0; i < argument; ++i)
+				{
+					list.emplace_back(readValue(depth + 1));
+				}
+
+				return list;
+			}
+
+			case CBOREncoding::Map:
+			{
+				Value map { Type::Map };
+
+				checkDepth(depth + 1);
+				map.reserve(clampCount(argument));
+
+				for (std::uint64_t i = 0; i < argument; ++i)
+				{
+					auto key = readValue(depth + 1);
+
+					addMember(map, std::move(key), readValue(depth + 1));
+				}
+
+				return map;
+			}
+
+			default:
+				invalid();
+		}
+	}
+
+	Value readIndefinite(CBOREncoding::MajorType major, size_t depth)
+	{
+		switch (major)
+		{
+			case CBOREncoding::ByteString:
+			case CBOREncoding::TextString:
+			{
+				// The chunks must be definite length strings of the same major type.
+				IdType::ByteData bytes;
+
+				while (!readBreak())
+				{
+					const auto initial = readByte();
+
+					if ((initial >> 5) != major || (initial & 0x1F) == c_indefinite)
+					{
+						invalid();
+					}
+
+					const auto length = readArgument(initial & 0x1F);
+					const auto chunk = readBytes(length);
+
+					bytes.insert(bytes.end(), chunk, chunk + length);
+				}
+
+				if (major == CBOREncoding::ByteString)
+				{
+					return Value { IdType { std::move(bytes) } };
+				}
+
+				return Value { std::string { bytes.cbegin(), bytes.cend() } }.from_json();
+			}
+
+			case CBOREncoding::Array:
+			{
+				Value list { Type::List };
+
+				checkDepth(depth + 1);
+
+				while (!readBreak())
+				{
+					list.emplace_back(readValue(depth + 1));
+				}
+
+				return list;
+			}
+
+			case CBOREncoding::Map:
+			{
+				Value map { Type::Map };
+
+				checkDepth(depth + 1);
+
+				while (!readBreak())
+				{
+					auto key = readValue(depth + 1);
+
+					addMember(map, std::move(key), readValue(depth + 1));
+				}
+
+				return map;
+			}
+
+			default:
+				invalid();
+		}
+	}
+
+	Value readSimple(std::uint8_t info)
+	{
+		switch (info)
+		{
+			case 20:
+				return Value { false };
+
+			case 21:
+				return Value { true };
+
+			case 22: // null
+			case 23: // undefined
+				return {};
+
+			case 25:
+			{
+				// https://www.rfc-editor.org/rfc/rfc8949.html#name-half-precision
+				const auto half = static_cast<std::uint16_t>(readBigEndian(2));
+				const auto exponent = (half >> 10) & 0x1F;
+				const auto mantissa = half & 0x3FF;
+				double value = 0.0;
+
+				if (exponent == 0)
+				{
+					value = std::ldexp(mantissa, -24);
+				}
+				else if (exponent != 31)
+				{
+					value = std::ldexp(mantissa + 1024, exponent - 25);
+				}
+				else
+				{
+					value = (mantissa == 0) ? std::numeric_limits<double>::infinity()
+											: std::numeric_limits<double>::quiet_NaN();
+				}
+
+				return Value { (half & 0x8000) ? -value : value };
+			}
+
+			case 26:
+				return Value { static_cast<FloatType>(
+					std::bit_cast<float>(static_cast<std::uint32_t>(readBigEndian(4)))) };
+
+			case 27:
+				return Value { std::bit_cast<double>(readBigEndian(8)) };
+
+			default:
+				invalid();
+		}
+	}
+};
+
+class MessagePackReader : BinaryReader
+{
+public:
+	explicit MessagePackReader(const BinaryData& msgpack) noexcept
+		: BinaryReader { msgpack, "MessagePack"sv }
+	{
+	}
+
+	Value parse()
+	{
+		auto result = readValue(0);
+
+		checkComplete();
+
+		return result;
+	}
+
+private:
+	Value readList(std::uint64_t count, size_t depth)
+	{
+		Value list { Type::List };
+
+		checkDepth(depth + 1);
+		list.reserve(clampCount(count));
+
+		for (std::uint64_t i = 0; i < count; ++i)
+		{
+			list.emplace_back(readValue(depth + 1));
+		}
+
+		return list;
+	}
+
+	Value readMap(std::uint64_t count, size_t depth)
+	{
+		Value map { Type::Map };
+
+		checkDepth(depth + 1);
+		map.reserve(clampCount(count));
+
+		for (std::uint64_t i = 0; i < count; ++i)
+		{
+			auto key = readValue(depth + 1);
+
+			addMember(map, std::move(key), readValue(depth + 1));
+		}
+
+		return map;
+	}
+
+	// Sign extend the big-endian two's complement value.
+	std::int64_t readSigned(size_t bytes)
+	{
+		const auto shift = 64 - bytes * 8;
+
+		return static_cast<std::int64_t>(readBigEndian(bytes) << shift) >> shift;
+	}
+
+	Value readValue(size_t depth)
+	{
+		const auto type = readByte();
+
+		if (type <= 0x7F)
+		{
+			return Value { static_cast<IntType>(type) };
+		}
+		else if (type >= 0xE0)
+		{
+			return Value { static_cast<IntType>(static_cast<std::int8_t>(type)) };
+		}
+
+		switch (type & 0xF0)
+		{
+			case 0x80:
+				return readMap(type & 0x0F, depth);
+
+			case 0x90:
+				return readList(type & 0x0F, depth);
+
+			case 0xA0:
+			case 0xB0:
+				return readString(type & 0x1F);
+
+			default:
+				break;
+		}
+
+		switch (type)
+		{
+			case 0xC0:
+				return {};
+
+			case 0xC2:
+				return Value { false };
+
+			case 0xC3:
+				return Value { true };
+
+			case 0xC4:
+			case 0xC5:
+			case 0xC6:
+				return readId(readBigEndian(size_t { 1 } << (type - 0xC4)));
+
+			case 0xCA:
+				return Value { static_cast<FloatType>(
+					std::bit_cast<float>(static_cast<std::uint32_t>(readBigEndian(4)))) };
+
+			case 0xCB:
+				return Value { std::bit_cast<double>(readBigEndian(8)) };
+
+			case 0xCC:
+			case 0xCD:
+			case 0xCE:
+			case 0xCF:
+				return makeUnsigned(readBigEndian(size_t { 1 } << (type - 0xCC)));
+
+			case 0xD0:
+			case 0xD1:
+			case 0xD2:
+			case 0xD3:
+				return makeInt(readSigned(size_t { 1 } << (type - 0xD0)));
+
+			case 0xD9:
+			case 0xDA:
+			case 0xDB:
+				return readString(readBigEndian(size_t { 1 } << (type - 0xD9)));
+
+			case 0xDC:
+			case 0xDD:
+				return readList(readBigEndian(size_t { 2 } << (type - 0xDC)), depth);
+
+			case 0xDE:
+			case 0xDF:
+				return readMap(readBigEndian(size_t { 2 } << (type - 0xDE)), depth);
+
+			default:
+				// There are no extension types for any of the GraphQL types.
+				invalid();
+		}
+	}
+};
+
+} // namespace
+
+BinaryData toCBOR(Value&& response)
+{
+	BinaryData cbor;
+
+	makeCBORWriter(cbor).write(std::move(response));
+
+	return cbor;
+}
+
+Writer makeCBORWriter(BinaryData& output)
+{
+	return Writer { std::make_unique<BinaryWriter<CBOREncoding>>(output) };
+}
+
+Value parseCBOR(const BinaryData& cbor)
+{
+	return CBORReader { cbor }.parse();
+}
+
+BinaryData toMessagePack(Value&& response)
+{
+	BinaryData msgpack;
+
+	makeMessagePackWriter(msgpack).write(std::move(response));
+
+	return msgpack;
+}
+
+Writer makeMessagePackWriter(BinaryData& output)
+{
+	return Writer { std::make_unique<BinaryWriter<MessagePackEncoding>>(output) };
+}
+
+Value parseMessagePack(const BinaryData& msgpack)
+{
+	return MessagePackReader { msgpack }.parse();
+}
+
+} // namespace graphql::response
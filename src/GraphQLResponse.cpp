@@ -6,9 +6,9 @@
 #include "graphqlservice/internal/Base64.h"
 
 #include <algorithm>
+#include <bit>
+#include <functional>
 #include <iterator>
-#include <map>
-#include <optional>
 #include <stdexcept>
 #include <variant>
 
@@ -506,6 +506,55 @@ bool Value::MapData::operator==(const MapData& rhs) const
 	return map == rhs.map;
 }
 
+MapType::const_iterator Value::MapData::find(std::string_view name) const noexcept
+{
+	if (members.empty())
+	{
+		return std::find_if(map.cbegin(), map.cend(), [name](const auto& entry) noexcept {
+			return entry.first == name;
+		});
+	}
+
+	const auto mask = members.size() - 1;
+
+	for (auto slot = std::hash<std::string_view> {}(name) & mask; members[slot] != 0;
+		 slot = (slot + 1) & mask)
+	{
+		const auto itr = map.cbegin() + (members[slot] - 1);
+
+		if (itr->first == name)
+		{
+			return itr;
+		}
+	}
+
+	return map.cend();
+}
+
+void Value::MapData::indexMember(size_t offset) noexcept
+{
+	const auto mask = members.size() - 1;
+	auto slot = std::hash<std::string_view> {}(map[offset].first) & mask;
+
+	while (members[slot] != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	members[slot] = offset + 1;
+}
+
+void Value::MapData::rebuildIndex(size_t count)
+{
+	// Keep the load factor at or below 1/2 so the probe sequences stay short.
+	members.assign(std::bit_ceil(std::max(count, map.size()) * 2), 0);
+
+	for (size_t offset = 0; offset < map.size(); ++offset)
+	{
+		indexMember(offset);
+	}
+}
+
 bool Value::StringData::operator==(const StringData& rhs) const
 {
 	return (from_json || from_input) == (rhs.from_json || rhs.from_input) && string == rhs.string;
@@ -895,17 +944,22 @@ IdType Value::release<IdType>()
 	throw std::logic_error("Invalid call to Value::release for IdType");
 }
 
-Value::Value(Type type /* = Type::Null */)
+Value::Value(Type type /* = Type::Null */, std::pmr::memory_resource* resource /* = nullptr */)
 	: _data { NullData {} }
 {
+	if (!resource)
+	{
+		resource = std::pmr::get_default_resource();
+	}
+
 	switch (type)
 	{
 		case Type::Map:
-			_data = MapData {};
+			_data = MapData { MapType(resource), std::pmr::vector<size_t>(resource) };
 			break;
 
 		case Type::List:
-			_data = ListType {};
+			_data = ListType(resource);
 			break;
 
 		case Type::String:
@@ -1003,21 +1057,11 @@ Value::Value(const Value& other)
 				copy.map.push_back({ entry.first, Value { entry.second } });
 			}
 
-			std::map<std::string_view, size_t> members;
-
-			for (const auto& entry : copy.map)
+			if (copy.map.size() > MapData::c_linearSearchLimit)
 			{
-				members[entry.first] = members.size();
+				copy.rebuildIndex(copy.map.size());
 			}
 
-			copy.members.reserve(members.size());
-			std::transform(members.cbegin(),
-				members.cend(),
-				std::back_inserter(copy.members),
-				[](const auto& entry) noexcept {
-					return entry.second;
-				});
-
 			_data = { std::move(copy) };
 			break;
 		}
@@ -1283,8 +1327,12 @@ void Value::reserve(size_t count)
 		{
 			auto& mapData = std::get<MapData>(_data);
 
-			mapData.members.reserve(count);
 			mapData.map.reserve(count);
+
+			if (count > MapData::c_linearSearchLimit && mapData.members.size() < count * 2)
+			{
+				mapData.rebuildIndex(count);
+			}
 			break;
 		}
 
@@ -1331,22 +1379,23 @@ bool Value::emplace_back(std::string&& name, Value&& value)
 	}
 
 	auto& mapData = std::get<MapData>(_data);
-	const auto [itr, itrEnd] = std::equal_range(mapData.members.cbegin(),
-		mapData.members.cend(),
-		std::nullopt,
-		[&mapData, &name](std::optional<size_t> lhs, std::optional<size_t> rhs) noexcept {
-			std::string_view lhsName { lhs == std::nullopt ? name : mapData.map[*lhs].first };
-			std::string_view rhsName { rhs == std::nullopt ? name : mapData.map[*rhs].first };
-			return lhsName < rhsName;
-		});
 
-	if (itr != itrEnd)
+	if (mapData.find(name) != mapData.map.cend())
 	{
 		return false;
 	}
 
 	mapData.map.emplace_back(std::make_pair(std::move(name), std::move(value)));
-	mapData.members.insert(itr, mapData.members.size());
+
+	if (mapData.map.size() * 2 <= mapData.members.size())
+	{
+		mapData.indexMember(mapData.map.size() - 1);
+	}
+	else if (mapData.map.size() > MapData::c_linearSearchLimit)
+	{
+		// Doubling the table each time it fills up keeps insertion amortized O(1).
+		mapData.rebuildIndex(mapData.map.size());
+	}
 
 	return true;
 }
@@ -1360,22 +1409,7 @@ MapType::const_iterator Value::find(std::string_view name) const
 		throw std::logic_error("Invalid call to Value::find for MapType");
 	}
 
-	const auto& mapData = std::get<MapData>(typeData);
-	const auto [itr, itrEnd] = std::equal_range(mapData.members.cbegin(),
-		mapData.members.cend(),
-		std::nullopt,
-		[&mapData, name](std::optional<size_t> lhs, std::optional<size_t> rhs) noexcept {
-			std::string_view lhsName { lhs == std::nullopt ? name : mapData.map[*lhs].first };
-			std::string_view rhsName { rhs == std::nullopt ? name : mapData.map[*rhs].first };
-			return lhsName < rhsName;
-		});
-
-	if (itr == itrEnd)
-	{
-		return mapData.map.cend();
-	}
-
-	return mapData.map.cbegin() + *itr;
+	return std::get<MapData>(typeData).find(name);
 }
 
 MapType::const_iterator Value::begin() const
@@ -1441,6 +1475,33 @@ const Value& Value::operator[](size_t index) const
 	return std::get<ListType>(typeData).at(index);
 }
 
+ValueArena::ValueArena(size_t initialSize /* = c_defaultInitialSize */)
+	: _resource { initialSize }
+{
+}
+
+ValueArena::~ValueArena()
+{
+	// Release all of the memory at once, the same as the monotonic_buffer_resource destructor.
+}
+
+void* ValueArena::do_allocate(size_t bytes, size_t alignment)
+{
+	std::lock_guard lock { _mutex };
+
+	return _resource.allocate(bytes, alignment);
+}
+
+void ValueArena::do_deallocate(void*, size_t, size_t)
+{
+	// Nothing is freed until the arena is destroyed.
+}
+
+bool ValueArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
 void Writer::write(Value response) const
 {
 	switch (response.type())
@@ -1478,7 +1539,6 @@ void Writer::write(Value response) const
 
 		case Type::String:
 		case Type::EnumValue:
-		case Type::ID:
 		{
 			auto value = response.release<StringType>();
 
@@ -1486,6 +1546,12 @@ void Writer::write(Value response) const
 			break;
 		}
 
+		case Type::ID:
+		{
+			_concept->write_id(response.release<IdType>());
+			break;
+		}
+
 		case Type::Null:
 		{
 			_concept->write_null();
@@ -1524,4 +1590,29 @@ void Writer::write(Value response) const
 	}
 }
 
+void Writer::start_object() const
+{
+	_concept->start_object();
+}
+
+void Writer::add_member(std::string_view key) const
+{
+	_concept->add_member(key);
+}
+
+void Writer::end_object() const
+{
+	_concept->end_object();
+}
+
+void Writer::start_array() const
+{
+	_concept->start_array();
+}
+
+void Writer::end_array() const
+{
+	_concept->end_arrary();
+}
+
 } // namespace graphql::response
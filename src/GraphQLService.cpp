@@ -3,13 +3,20 @@
 
 #include "graphqlservice/GraphQLService.h"
 
+#include "graphqlservice/internal/Base64.h"
 #include "graphqlservice/internal/Grammar.h"
+#include "graphqlservice/internal/Sha256.h"
 
 #include "Validation.h"
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <span>
+#include <unordered_map>
 
 namespace graphql::service {
 
@@ -179,6 +186,51 @@ std::string unimplemented_method::getMessage(std::string_view methodName) noexce
 	return oss.str();
 }
 
+void RequestState::beginBatchScope()
+{
+	std::lock_guard lock { _batchMutex };
+
+	++_batchScopes;
+}
+
+void RequestState::endBatchScope() noexcept
+{
+	std::unique_lock lock { _batchMutex };
+
+	// Whoever closes the last scope dispatches the pending batches. It holds another scope open
+	// while the loaders resume their waiters, so any keys which those resolvers load in turn are
+	// batched together in the next pass instead of dispatching one at a time.
+	while (--_batchScopes == 0 && !_pendingBatches.empty())
+	{
+		auto pending = std::move(_pendingBatches);
+
+		_pendingBatches.clear();
+		++_batchScopes;
+		lock.unlock();
+
+		for (auto loader : pending)
+		{
+			loader->dispatch();
+		}
+
+		lock.lock();
+	}
+}
+
+void RequestState::enqueueBatch(BatchLoaderBase& loader)
+{
+	std::lock_guard lock { _batchMutex };
+
+	_pendingBatches.push_back(&loader);
+}
+
+void BatchLoaderBase::enqueue()
+{
+	const RequestState::BatchScope batchScope { &_state };
+
+	_state.enqueueBatch(*this);
+}
+
 void await_worker_thread::await_suspend(coro::coroutine_handle<> h) const
 {
 	std::thread(
@@ -247,6 +299,298 @@ void await_worker_queue::resumePending()
 	}
 }
 
+namespace {
+
+// Remember which await_worker_pool owns the current thread, so a co_await from one of its own
+// workers keeps running inline instead of waiting behind itself in the same pool.
+thread_local const await_worker_pool* currentWorkerPool = nullptr;
+
+} // namespace
+
+// Bounded multi-producer/multi-consumer ring buffer based on Dmitry Vyukov's algorithm. The owning
+// worker and any thieves pop from the same end with a CAS, so stealing never takes a lock.
+struct await_worker_pool::WorkerQueue
+{
+	explicit WorkerQueue(size_t capacity)
+		: _cells { std::make_unique<Cell[]>(capacity) }
+		, _mask { capacity - 1 }
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	[[nodiscard("unnecessary call")]] bool push(coro::coroutine_handle<> h) noexcept
+	{
+		auto position = _tail.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto& cell = _cells[position & _mask];
+			const auto sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff =
+				static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+			if (diff == 0)
+			{
+				if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell.handle = std::move(h);
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The queue is full.
+				return false;
+			}
+			else
+			{
+				position = _tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	[[nodiscard("unnecessary call")]] bool pop(coro::coroutine_handle<>& h) noexcept
+	{
+		auto position = _head.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto& cell = _cells[position & _mask];
+			const auto sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto diff =
+				static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+			if (diff == 0)
+			{
+				if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					h = std::move(cell.handle);
+					cell.sequence.store(position + _mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The queue is empty.
+				return false;
+			}
+			else
+			{
+				position = _head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic_size_t sequence { 0 };
+		coro::coroutine_handle<> handle {};
+	};
+
+	const std::unique_ptr<Cell[]> _cells;
+	const size_t _mask;
+	alignas(64) std::atomic_size_t _head { 0 };
+	alignas(64) std::atomic_size_t _tail { 0 };
+};
+
+await_worker_pool::await_worker_pool(size_t workerCount, size_t queueCapacity)
+{
+	if (workerCount == 0)
+	{
+		workerCount = std::max(size_t { 1 }, size_t { std::thread::hardware_concurrency() });
+	}
+
+	// The ring buffer indexing relies on the capacity being a power of 2.
+	size_t capacity = 2;
+
+	while (capacity < queueCapacity)
+	{
+		capacity <<= 1;
+	}
+
+	_queues.reserve(workerCount);
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		_queues.push_back(std::make_unique<WorkerQueue>(capacity));
+	}
+
+	_workers.reserve(workerCount);
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		_workers.emplace_back([this, i]() {
+			runWorker(i);
+		});
+	}
+}
+
+await_worker_pool::~await_worker_pool()
+{
+	shutdown();
+}
+
+bool await_worker_pool::await_ready() const
+{
+	return currentWorkerPool == this;
+}
+
+void await_worker_pool::await_suspend(coro::coroutine_handle<> h)
+{
+	if (!tryPush(h))
+	{
+		h.resume();
+	}
+}
+
+size_t await_worker_pool::size() const noexcept
+{
+	return _workers.size();
+}
+
+void await_worker_pool::drain()
+{
+	if (currentWorkerPool == this)
+	{
+		throw std::logic_error("Cannot drain await_worker_pool from one of its own workers");
+	}
+
+	std::unique_lock lock { _mutex };
+
+	_idle.wait(lock, [this]() noexcept {
+		return _pending == 0 && _active == 0;
+	});
+}
+
+void await_worker_pool::shutdown()
+{
+	if (currentWorkerPool == this)
+	{
+		throw std::logic_error("Cannot shutdown await_worker_pool from one of its own workers");
+	}
+
+	drain();
+
+	std::unique_lock lock { _mutex };
+
+	_shutdown = true;
+	lock.unlock();
+	_wakeWorker.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+void await_worker_pool::runWorker(size_t index)
+{
+	currentWorkerPool = this;
+
+	for (;;)
+	{
+		coro::coroutine_handle<> h;
+
+		if (tryPop(index, h))
+		{
+			h.resume();
+
+			if (_active.fetch_sub(1) == 1 && _pending == 0)
+			{
+				notifyIdle();
+			}
+
+			continue;
+		}
+
+		std::unique_lock lock { _mutex };
+
+		if (_shutdown && _pending == 0)
+		{
+			break;
+		}
+
+		// Pushing a new coroutine checks for sleeping workers after incrementing _pending, so one
+		// of them will either see the new _pending count here or receive the notification.
+		++_sleeping;
+		_wakeWorker.wait(lock, [this]() noexcept {
+			return _shutdown || _pending != 0;
+		});
+		--_sleeping;
+	}
+
+	currentWorkerPool = nullptr;
+}
+
+bool await_worker_pool::tryPush(coro::coroutine_handle<> h)
+{
+	++_pending;
+
+	if (!_shutdown)
+	{
+		const size_t count = _queues.size();
+		const size_t start = _nextQueue.fetch_add(1, std::memory_order_relaxed);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (_queues[(start + i) % count]->push(h))
+			{
+				if (_sleeping != 0)
+				{
+					std::unique_lock lock { _mutex };
+
+					lock.unlock();
+					_wakeWorker.notify_one();
+				}
+
+				return true;
+			}
+		}
+	}
+
+	// Every queue is full or the pool is shutting down, so the caller should resume inline.
+	if (_pending.fetch_sub(1) == 1 && _active == 0)
+	{
+		notifyIdle();
+	}
+
+	return false;
+}
+
+bool await_worker_pool::tryPop(size_t index, coro::coroutine_handle<>& h)
+{
+	const size_t count = _queues.size();
+
+	// Check the worker's own queue first, then try to steal from each of the others in turn.
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (_queues[(index + i) % count]->pop(h))
+		{
+			++_active;
+			--_pending;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void await_worker_pool::notifyIdle()
+{
+	std::unique_lock lock { _mutex };
+
+	lock.unlock();
+	_idle.notify_all();
+}
+
 // Default to immediate synchronous execution.
 await_async::await_async()
 	: _pimpl { std::static_pointer_cast<const Concept>(
@@ -614,7 +958,7 @@ const Directives& Fragment::getDirectives() const
 ResolverParams::ResolverParams(const SelectionSetParams& selectionSetParams,
 	const peg::ast_node& field, std::string&& fieldName, response::Value arguments,
 	Directives fieldDirectives, const peg::ast_node* selection, const FragmentMap& fragments,
-	const response::Value& variables)
+	const response::Value& variables, const PreparedSelectionSet* preparedSelection)
 	: SelectionSetParams(selectionSetParams)
 	, field(field)
 	, fieldName(std::move(fieldName))
@@ -623,6 +967,7 @@ ResolverParams::ResolverParams(const SelectionSetParams& selectionSetParams,
 	, selection(selection)
 	, fragments(fragments)
 	, variables(variables)
+	, preparedSelection(preparedSelection)
 {
 }
 
@@ -633,87 +978,381 @@ schema_location ResolverParams::getLocation() const
 	return { position.line, position.column };
 }
 
-template <>
-int Argument<int>::convert(const response::Value& value)
+std::optional<IncrementalPayloads::Directive> IncrementalPayloads::findDirective(
+	std::string_view name, const Directives& directives)
 {
-	if (value.type() != response::Type::Int)
+	const auto itr = std::find_if(directives.cbegin(),
+		directives.cend(),
+		[name](const auto& directive) noexcept {
+			return directive.first == name;
+		});
+
+	if (itr == directives.cend() || itr->second.type() != response::Type::Map)
 	{
-		throw schema_exception { { "not an integer" } };
+		return std::nullopt;
 	}
 
-	return value.get<int>();
-}
+	const auto& arguments = itr->second;
+	const auto end = arguments.get<response::MapType>().cend();
+	const auto itrIf = arguments.find(strIf);
 
-template <>
-double Argument<double>::convert(const response::Value& value)
-{
-	if (value.type() != response::Type::Float && value.type() != response::Type::Int)
+	if (itrIf != end && itrIf->second.type() == response::Type::Boolean
+		&& !itrIf->second.get<bool>())
 	{
-		throw schema_exception { { "not a float" } };
+		return std::nullopt;
 	}
 
-	return value.get<double>();
-}
+	Directive result;
+	const auto itrLabel = arguments.find(strLabel);
 
-template <>
-std::string Argument<std::string>::convert(const response::Value& value)
-{
-	if (value.type() != response::Type::String)
+	if (itrLabel != end && itrLabel->second.type() == response::Type::String)
 	{
-		throw schema_exception { { "not a string" } };
+		result.label = itrLabel->second.get<std::string>();
 	}
 
-	return value.get<std::string>();
-}
+	const auto itrInitialCount = arguments.find(strInitialCount);
 
-template <>
-bool Argument<bool>::convert(const response::Value& value)
-{
-	if (value.type() != response::Type::Boolean)
+	if (itrInitialCount != end && itrInitialCount->second.type() == response::Type::Int)
 	{
-		throw schema_exception { { "not a boolean" } };
+		const auto initialCount = itrInitialCount->second.get<int>();
+
+		// Validation rejects a negative literal, but it may still come from a variable.
+		if (initialCount < 0)
+		{
+			std::ostringstream message;
+
+			message << "Negative argument directive: " << name << " name: " << strInitialCount;
+
+			throw schema_exception { { message.str() } };
+		}
+
+		result.initialCount = static_cast<size_t>(initialCount);
 	}
 
-	return value.get<bool>();
+	return result;
 }
 
-template <>
-response::Value Argument<response::Value>::convert(const response::Value& value)
+void IncrementalPayloads::push(Payload&& payload)
 {
-	return response::Value(value);
+	std::lock_guard lock { _mutex };
+
+	_payloads.push_back(std::move(payload));
 }
 
-template <>
-response::IdType Argument<response::IdType>::convert(const response::Value& value)
+std::optional<IncrementalPayloads::Payload> IncrementalPayloads::pop()
 {
-	if (!value.maybe_id())
+	std::lock_guard lock { _mutex };
+
+	if (_payloads.empty())
 	{
-		throw schema_exception { { "not an ID" } };
+		return std::nullopt;
 	}
 
-	return response::Value { value }.release<response::IdType>();
+	auto payload = std::make_optional(std::move(_payloads.front()));
+
+	_payloads.pop_front();
+
+	return payload;
 }
 
-void blockSubFields(const ResolverParams& params)
+bool IncrementalPayloads::empty() const
 {
-	// https://spec.graphql.org/October2021/#sec-Leaf-Field-Selections
-	if (params.selection != nullptr)
-	{
-		auto position = params.selection->begin();
-		std::ostringstream error;
+	std::lock_guard lock { _mutex };
 
-		error << "Field may not have sub-fields name: " << params.fieldName;
+	return _payloads.empty();
+}
 
-		throw schema_exception { { schema_error { error.str(),
-			{ position.line, position.column },
-			buildErrorPath(params.errorPath) } } };
+void IncrementalPayloads::clear()
+{
+	std::list<Payload> payloads;
+
+	{
+		std::lock_guard lock { _mutex };
+
+		payloads = std::move(_payloads);
+		_payloads.clear();
 	}
 }
 
-template <>
-AwaitableResolver Result<int>::convert(AwaitableScalar<int> result, ResolverParams&& params)
+ValueWriter::ValueWriter() noexcept
 {
-	blockSubFields(params);
+}
+
+void ValueWriter::start_object()
+{
+	push(StartObject {});
+}
+
+void ValueWriter::add_member(std::string_view key)
+{
+	push(AddMember { key });
+}
+
+void ValueWriter::end_object()
+{
+	push(EndObject {});
+}
+
+void ValueWriter::start_array()
+{
+	push(StartArray {});
+}
+
+void ValueWriter::end_array()
+{
+	push(EndArray {});
+}
+
+void ValueWriter::write(response::Value&& value)
+{
+	push(std::move(value));
+}
+
+void ValueWriter::attach(const response::Writer& output)
+{
+	std::lock_guard lock { _mutex };
+
+	_output = &output;
+
+	for (auto& token : _buffer)
+	{
+		forward(std::move(token));
+	}
+
+	_buffer.clear();
+}
+
+void ValueWriter::attach(ValueWriter& parent)
+{
+	std::lock_guard lock { _mutex };
+
+	_parent = &parent;
+
+	for (auto& token : _buffer)
+	{
+		forward(std::move(token));
+	}
+
+	_buffer.clear();
+}
+
+void ValueWriter::finish(response::Value&& value)
+{
+	std::lock_guard lock { _mutex };
+
+	if (!_written)
+	{
+		append(std::move(value));
+	}
+	else
+	{
+		closeOpen();
+	}
+
+	_finished = true;
+}
+
+void ValueWriter::close()
+{
+	std::lock_guard lock { _mutex };
+
+	closeOpen();
+	_finished = true;
+}
+
+void ValueWriter::push(Token&& token)
+{
+	std::lock_guard lock { _mutex };
+
+	append(std::move(token));
+}
+
+void ValueWriter::append(Token&& token)
+{
+	if (_finished)
+	{
+		return;
+	}
+
+	_written = true;
+
+	if (std::holds_alternative<AddMember>(token))
+	{
+		_pendingMember = true;
+	}
+	else
+	{
+		_pendingMember = false;
+
+		if (std::holds_alternative<StartObject>(token) || std::holds_alternative<StartArray>(token))
+		{
+			_open.push_back(std::holds_alternative<StartObject>(token));
+		}
+		else if ((std::holds_alternative<EndObject>(token)
+					 || std::holds_alternative<EndArray>(token))
+			&& !_open.empty())
+		{
+			_open.pop_back();
+		}
+	}
+
+	if (_output || _parent)
+	{
+		forward(std::move(token));
+	}
+	else
+	{
+		_buffer.push_back(std::move(token));
+	}
+}
+
+void ValueWriter::forward(Token&& token)
+{
+	if (_parent)
+	{
+		_parent->push(std::move(token));
+		return;
+	}
+
+	std::visit(
+		[this](auto&& value) {
+			using value_type = std::decay_t<decltype(value)>;
+
+			if constexpr (std::is_same_v<value_type, StartObject>)
+			{
+				_output->start_object();
+			}
+			else if constexpr (std::is_same_v<value_type, AddMember>)
+			{
+				_output->add_member(value.key);
+			}
+			else if constexpr (std::is_same_v<value_type, EndObject>)
+			{
+				_output->end_object();
+			}
+			else if constexpr (std::is_same_v<value_type, StartArray>)
+			{
+				_output->start_array();
+			}
+			else if constexpr (std::is_same_v<value_type, EndArray>)
+			{
+				_output->end_array();
+			}
+			else
+			{
+				_output->write(std::move(value));
+			}
+		},
+		std::move(token));
+}
+
+void ValueWriter::closeOpen()
+{
+	if (!_written || _finished)
+	{
+		return;
+	}
+
+	// A member which was added without a value gets a null value before the map is closed.
+	if (_pendingMember)
+	{
+		append(response::Value {});
+	}
+
+	while (!_open.empty())
+	{
+		if (_open.back())
+		{
+			append(EndObject {});
+		}
+		else
+		{
+			append(EndArray {});
+		}
+	}
+}
+
+template <>
+int Argument<int>::convert(const response::Value& value)
+{
+	if (value.type() != response::Type::Int)
+	{
+		throw schema_exception { { "not an integer" } };
+	}
+
+	return value.get<int>();
+}
+
+template <>
+double Argument<double>::convert(const response::Value& value)
+{
+	if (value.type() != response::Type::Float && value.type() != response::Type::Int)
+	{
+		throw schema_exception { { "not a float" } };
+	}
+
+	return value.get<double>();
+}
+
+template <>
+std::string Argument<std::string>::convert(const response::Value& value)
+{
+	if (value.type() != response::Type::String)
+	{
+		throw schema_exception { { "not a string" } };
+	}
+
+	return value.get<std::string>();
+}
+
+template <>
+bool Argument<bool>::convert(const response::Value& value)
+{
+	if (value.type() != response::Type::Boolean)
+	{
+		throw schema_exception { { "not a boolean" } };
+	}
+
+	return value.get<bool>();
+}
+
+template <>
+response::Value Argument<response::Value>::convert(const response::Value& value)
+{
+	return response::Value(value);
+}
+
+template <>
+response::IdType Argument<response::IdType>::convert(const response::Value& value)
+{
+	if (!value.maybe_id())
+	{
+		throw schema_exception { { "not an ID" } };
+	}
+
+	return response::Value { value }.release<response::IdType>();
+}
+
+void blockSubFields(const ResolverParams& params)
+{
+	// https://spec.graphql.org/October2021/#sec-Leaf-Field-Selections
+	if (params.selection != nullptr)
+	{
+		auto position = params.selection->begin();
+		std::ostringstream error;
+
+		error << "Field may not have sub-fields name: " << params.fieldName;
+
+		throw schema_exception { { schema_error { error.str(),
+			{ position.line, position.column },
+			buildErrorPath(params.errorPath) } } };
+	}
+}
+
+template <>
+AwaitableResolver Result<int>::convert(AwaitableScalar<int> result, ResolverParams&& params)
+{
+	blockSubFields(params);
 
 	return ModifiedResult<int>::resolve(std::move(result),
 		std::move(params),
@@ -819,6 +1458,16 @@ AwaitableResolver Result<Object>::convert(
 		co_return ResolverResult {};
 	}
 
+	if (params.preparedSelection)
+	{
+		auto document = co_await awaitedResult->resolve(params,
+			*params.preparedSelection,
+			params.fragments,
+			params.variables);
+
+		co_return std::move(document);
+	}
+
 	auto document = co_await awaitedResult->resolve(params,
 		*params.selection,
 		params.fragments,
@@ -878,62 +1527,292 @@ void Result<response::Value>::validateScalar(const response::Value&)
 	// Any response::Value is valid for a custom scalar type.
 }
 
-// SelectionVisitor visits the AST and resolves a field or fragment, unless it's skipped by
-// a directive or type condition.
-class SelectionVisitor
+namespace {
+
+// Check if a value, list of arguments, or list of directives references any variables.
+bool referencesVariables(const peg::ast_node& node)
 {
-public:
-	explicit SelectionVisitor(const SelectionSetParams& selectionSetParams,
-		const FragmentMap& fragments, const response::Value& variables, const TypeNames& typeNames,
-		const ResolverMap& resolvers, size_t count);
+	return node.is_type<peg::variable_value>()
+		|| std::any_of(node.children.cbegin(), node.children.cend(), [](const auto& child) {
+			   return referencesVariables(*child);
+		   });
+}
 
-	void visit(const peg::ast_node& selection);
+response::Value visitArguments(const peg::ast_node& arguments, const response::Value& variables)
+{
+	response::Value result(response::Type::Map);
+	ValueVisitor visitor(variables);
 
-	struct VisitorValue
+	for (auto& argument : arguments.children)
 	{
-		std::string_view name;
-		std::optional<schema_location> location;
-		AwaitableResolver result;
-	};
+		visitor.visit(*argument->children.back());
 
-	std::vector<VisitorValue> getValues();
+		result.emplace_back(argument->children.front()->string(), visitor.getValue());
+	}
 
-private:
-	void visitField(const peg::ast_node& field);
-	void visitFragmentSpread(const peg::ast_node& fragmentSpread);
-	void visitInlineFragment(const peg::ast_node& inlineFragment);
+	return result;
+}
 
-	const ResolverContext _resolverContext;
-	const std::shared_ptr<RequestState>& _state;
-	const Directives& _operationDirectives;
-	const std::optional<std::reference_wrapper<const field_path>> _path;
-	const await_async _launch;
-	const FragmentMap& _fragments;
-	const response::Value& _variables;
-	const TypeNames& _typeNames;
-	const ResolverMap& _resolvers;
+const response::Value& noVariables()
+{
+	static const response::Value s_noVariables(response::Type::Map);
 
-	std::shared_ptr<FragmentDefinitionDirectiveStack> _fragmentDefinitionDirectives;
-	std::shared_ptr<FragmentSpreadDirectiveStack> _fragmentSpreadDirectives;
-	std::shared_ptr<FragmentSpreadDirectiveStack> _inlineFragmentDirectives;
-	internal::string_view_set _names;
-	std::vector<VisitorValue> _values;
+	return s_noVariables;
+}
+
+} // namespace
+
+// Arguments and directives which do not reference any variables are evaluated once by
+// Request::prepare. The rest hold onto the AST node and are evaluated again for each request.
+struct PreparedArguments
+{
+	explicit PreparedArguments(const peg::ast_node* arguments);
+
+	[[nodiscard("unnecessary call")]] response::Value evaluate(
+		const response::Value& variables) const;
+
+	const peg::ast_node* node = nullptr;
+	response::Value constant { response::Type::Map };
 };
 
-SelectionVisitor::SelectionVisitor(const SelectionSetParams& selectionSetParams,
-	const FragmentMap& fragments, const response::Value& variables, const TypeNames& typeNames,
-	const ResolverMap& resolvers, size_t count)
-	: _resolverContext(selectionSetParams.resolverContext)
-	, _state(selectionSetParams.state)
-	, _operationDirectives(selectionSetParams.operationDirectives)
-	, _path(selectionSetParams.errorPath
-			  ? std::make_optional(std::cref(*selectionSetParams.errorPath))
-			  : std::nullopt)
-	, _launch(selectionSetParams.launch)
-	, _fragments(fragments)
+PreparedArguments::PreparedArguments(const peg::ast_node* arguments)
+{
+	if (arguments == nullptr)
+	{
+		return;
+	}
+
+	if (referencesVariables(*arguments))
+	{
+		node = arguments;
+	}
+	else
+	{
+		constant = visitArguments(*arguments, noVariables());
+	}
+}
+
+response::Value PreparedArguments::evaluate(const response::Value& variables) const
+{
+	return node ? visitArguments(*node, variables) : response::Value(constant);
+}
+
+struct PreparedDirectives
+{
+	explicit PreparedDirectives(const peg::ast_node* directives);
+
+	// Returns std::nullopt if the selection is skipped by @skip or @include.
+	[[nodiscard("unnecessary call")]] std::optional<Directives> evaluate(
+		const response::Value& variables) const;
+
+	// Operations cannot be skipped, so this returns the directives without checking @skip or
+	// @include, the same way OperationDefinitionVisitor does.
+	[[nodiscard("unnecessary call")]] Directives getDirectives(
+		const response::Value& variables) const;
+
+	const peg::ast_node* node = nullptr;
+	Directives constant;
+	bool skip = false;
+};
+
+PreparedDirectives::PreparedDirectives(const peg::ast_node* directives)
+{
+	if (directives == nullptr)
+	{
+		return;
+	}
+
+	if (referencesVariables(*directives))
+	{
+		node = directives;
+	}
+	else
+	{
+		DirectiveVisitor directiveVisitor(noVariables());
+
+		directiveVisitor.visit(*directives);
+		skip = directiveVisitor.shouldSkip();
+		constant = directiveVisitor.getDirectives();
+	}
+}
+
+std::optional<Directives> PreparedDirectives::evaluate(const response::Value& variables) const
+{
+	if (node)
+	{
+		DirectiveVisitor directiveVisitor(variables);
+
+		directiveVisitor.visit(*node);
+
+		if (directiveVisitor.shouldSkip())
+		{
+			return std::nullopt;
+		}
+
+		return std::make_optional(directiveVisitor.getDirectives());
+	}
+
+	if (skip)
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(Directives { constant });
+}
+
+Directives PreparedDirectives::getDirectives(const response::Value& variables) const
+{
+	if (!node)
+	{
+		return constant;
+	}
+
+	DirectiveVisitor directiveVisitor(variables);
+
+	directiveVisitor.visit(*node);
+
+	return directiveVisitor.getDirectives();
+}
+
+// The resolver is still looked up by name in SelectionVisitor::visitField, since the plan does not
+// know which Object, and so which ResolverMap, each selection set will run against. Selection sets
+// on an interface or union type run against a different ResolverMap for each object type.
+struct PreparedField
+{
+	const peg::ast_node& field;
+	std::string_view name;
+	std::string_view alias;
+	PreparedDirectives directives;
+	PreparedArguments arguments;
+	std::unique_ptr<PreparedSelectionSet> selection;
+};
+
+// Fragment definitions are compiled once and shared by every spread which references them.
+struct PreparedFragment
+{
+	std::string_view name;
+	std::string_view type;
+	PreparedDirectives directives;
+	std::unique_ptr<PreparedSelectionSet> selection;
+};
+
+struct PreparedFragmentSpread
+{
+	const PreparedFragment& fragment;
+	PreparedDirectives directives;
+};
+
+struct PreparedInlineFragment
+{
+	std::string_view typeCondition;
+	PreparedDirectives directives;
+	std::unique_ptr<PreparedSelectionSet> selection;
+};
+
+using PreparedSelection =
+	std::variant<PreparedField, PreparedFragmentSpread, PreparedInlineFragment>;
+
+struct PreparedSelectionSet
+{
+	const peg::ast_node& node;
+	std::vector<PreparedSelection> selections;
+};
+
+// SelectionVisitor visits the AST and resolves a field or fragment, unless it's skipped by
+// a directive or type condition.
+class SelectionVisitor
+{
+public:
+	explicit SelectionVisitor(const SelectionSetParams& selectionSetParams,
+		const FragmentMap& fragments, const response::Value& variables, const TypeNames& typeNames,
+		const ResolverMap& resolvers, const Object& implementation, size_t count,
+		bool canDefer = false);
+
+	void visit(const peg::ast_node& selection);
+	void visit(const PreparedSelection& selection);
+
+	struct VisitorValue
+	{
+		std::string_view name;
+		std::optional<schema_location> location;
+		AwaitableResolver result;
+
+		// If the selection set is written to a ValueWriter, this is where the field writes its
+		// value until it is attached.
+		std::unique_ptr<ValueWriter> writer {};
+	};
+
+	std::vector<VisitorValue> getValues();
+
+	// Fragments with an @defer directive, which are skipped by this visitor.
+	struct DeferredFragment
+	{
+		const peg::ast_node& selection;
+		std::optional<std::string> label;
+	};
+
+	std::vector<DeferredFragment> getDeferred();
+
+private:
+	[[nodiscard("unnecessary call")]] bool deferFragment(
+		const peg::ast_node& selection, const Directives& directives);
+
+	void visitField(const peg::ast_node& field);
+	void visitFragmentSpread(const peg::ast_node& fragmentSpread);
+	void visitInlineFragment(const peg::ast_node& inlineFragment);
+
+	void visitField(const PreparedField& field);
+	void visitFragmentSpread(const PreparedFragmentSpread& fragmentSpread);
+	void visitInlineFragment(const PreparedInlineFragment& inlineFragment);
+
+	[[nodiscard("unnecessary call")]] const Resolver* findResolver(
+		const peg::ast_node& field, std::string_view name, std::string_view alias);
+	void resolveField(const Resolver& resolver, const peg::ast_node& field, std::string_view alias,
+		Directives&& fieldDirectives, response::Value&& arguments, const peg::ast_node* selection,
+		const PreparedSelectionSet* preparedSelection);
+
+	const ResolverContext _resolverContext;
+	const std::shared_ptr<RequestState>& _state;
+	const Directives& _operationDirectives;
+	const std::optional<std::reference_wrapper<const field_path>> _path;
+	const await_async _launch;
+	const FragmentMap& _fragments;
+	const response::Value& _variables;
+	const TypeNames& _typeNames;
+	const ResolverMap& _resolvers;
+	const Object& _implementation;
+	const std::shared_ptr<IncrementalPayloads> _incremental;
+	std::pmr::memory_resource* const _resource;
+	const bool _streaming;
+	const bool _canDefer;
+
+	std::shared_ptr<FragmentDefinitionDirectiveStack> _fragmentDefinitionDirectives;
+	std::shared_ptr<FragmentSpreadDirectiveStack> _fragmentSpreadDirectives;
+	std::shared_ptr<FragmentSpreadDirectiveStack> _inlineFragmentDirectives;
+	internal::string_view_set _names;
+	std::vector<VisitorValue> _values;
+	std::vector<DeferredFragment> _deferred;
+};
+
+SelectionVisitor::SelectionVisitor(const SelectionSetParams& selectionSetParams,
+	const FragmentMap& fragments, const response::Value& variables, const TypeNames& typeNames,
+	const ResolverMap& resolvers, const Object& implementation, size_t count, bool canDefer)
+	: _resolverContext(selectionSetParams.resolverContext)
+	, _state(selectionSetParams.state)
+	, _operationDirectives(selectionSetParams.operationDirectives)
+	, _path(selectionSetParams.errorPath
+			  ? std::make_optional(std::cref(*selectionSetParams.errorPath))
+			  : std::nullopt)
+	, _launch(selectionSetParams.launch)
+	, _fragments(fragments)
 	, _variables(variables)
 	, _typeNames(typeNames)
 	, _resolvers(resolvers)
+	, _implementation(implementation)
+	, _incremental(selectionSetParams.incremental)
+	, _resource(selectionSetParams.resource)
+	, _streaming(selectionSetParams.writer != nullptr)
+	, _canDefer(canDefer && _incremental)
 	, _fragmentDefinitionDirectives { selectionSetParams.fragmentDefinitionDirectives }
 	, _fragmentSpreadDirectives { selectionSetParams.fragmentSpreadDirectives }
 	, _inlineFragmentDirectives { selectionSetParams.inlineFragmentDirectives }
@@ -958,6 +1837,31 @@ std::vector<SelectionVisitor::VisitorValue> SelectionVisitor::getValues()
 	return values;
 }
 
+std::vector<SelectionVisitor::DeferredFragment> SelectionVisitor::getDeferred()
+{
+	auto deferred = std::move(_deferred);
+
+	return deferred;
+}
+
+bool SelectionVisitor::deferFragment(const peg::ast_node& selection, const Directives& directives)
+{
+	if (!_canDefer)
+	{
+		return false;
+	}
+
+	auto defer = IncrementalPayloads::findDirective(strDefer, directives);
+
+	if (!defer)
+	{
+		return false;
+	}
+
+	_deferred.push_back({ selection, std::move(defer->label) });
+	return true;
+}
+
 void SelectionVisitor::visit(const peg::ast_node& selection)
 {
 	if (selection.is_type<peg::field>())
@@ -1001,22 +1905,10 @@ void SelectionVisitor::visitField(const peg::ast_node& field)
 		return;
 	}
 
-	const auto itrResolver = _resolvers.find(name);
+	const auto resolver = findResolver(field, name, alias);
 
-	if (itrResolver == _resolvers.end())
+	if (resolver == nullptr)
 	{
-		std::promise<ResolverResult> promise;
-		auto position = field.begin();
-		std::ostringstream error;
-
-		error << "Unknown field name: " << name;
-
-		promise.set_exception(
-			std::make_exception_ptr(schema_exception { { schema_error { error.str(),
-				{ position.line, position.column },
-				buildErrorPath(_path ? std::make_optional(_path->get()) : std::nullopt) } } }));
-
-		_values.push_back({ alias, std::nullopt, promise.get_future() });
 		return;
 	}
 
@@ -1034,14 +1926,7 @@ void SelectionVisitor::visitField(const peg::ast_node& field)
 	response::Value arguments(response::Type::Map);
 
 	peg::on_first_child<peg::arguments>(field, [this, &arguments](const peg::ast_node& child) {
-		ValueVisitor visitor(_variables);
-
-		for (auto& argument : child.children)
-		{
-			visitor.visit(*argument->children.back());
-
-			arguments.emplace_back(argument->children.front()->string(), visitor.getValue());
-		}
+		arguments = visitArguments(child, _variables);
 	});
 
 	const peg::ast_node* selection = nullptr;
@@ -1050,6 +1935,49 @@ void SelectionVisitor::visitField(const peg::ast_node& field)
 		selection = &child;
 	});
 
+	resolveField(*resolver,
+		field,
+		alias,
+		directiveVisitor.getDirectives(),
+		std::move(arguments),
+		selection,
+		nullptr);
+}
+
+const Resolver* SelectionVisitor::findResolver(
+	const peg::ast_node& field, std::string_view name, std::string_view alias)
+{
+	const auto itrResolver = _resolvers.find(name);
+
+	if (itrResolver == _resolvers.end())
+	{
+		std::promise<ResolverResult> promise;
+		auto position = field.begin();
+		std::ostringstream error;
+
+		error << "Unknown field name: " << name;
+
+		promise.set_exception(
+			std::make_exception_ptr(schema_exception { { schema_error { error.str(),
+				{ position.line, position.column },
+				buildErrorPath(_path ? std::make_optional(_path->get()) : std::nullopt) } } }));
+
+		_values.push_back({ alias, std::nullopt, promise.get_future() });
+		return nullptr;
+	}
+
+	return &itrResolver->second;
+}
+
+void SelectionVisitor::resolveField(const Resolver& resolver, const peg::ast_node& field,
+	std::string_view alias, Directives&& fieldDirectives, response::Value&& arguments,
+	const peg::ast_node* selection, const PreparedSelectionSet* preparedSelection)
+{
+	// Only fields with a selection set write their own value as it resolves, leaf fields are
+	// written to the parent writer when they are done.
+	auto writer = (_streaming && (selection || preparedSelection))
+		? std::make_unique<ValueWriter>()
+		: std::unique_ptr<ValueWriter> {};
 	const SelectionSetParams selectionSetParams {
 		_resolverContext,
 		_state,
@@ -1059,22 +1987,27 @@ void SelectionVisitor::visitField(const peg::ast_node& field)
 		_inlineFragmentDirectives,
 		std::make_optional(field_path { _path, path_segment { alias } }),
 		_launch,
+		_incremental,
+		_resource,
+		writer.get(),
 	};
 	const auto position = field.begin();
 
 	try
 	{
-		auto result = itrResolver->second(ResolverParams(selectionSetParams,
-			field,
-			std::string(alias),
-			std::move(arguments),
-			directiveVisitor.getDirectives(),
-			selection,
-			_fragments,
-			_variables));
+		auto result = resolver(_implementation,
+			ResolverParams(selectionSetParams,
+				field,
+				std::string(alias),
+				std::move(arguments),
+				std::move(fieldDirectives),
+				selection,
+				_fragments,
+				_variables,
+				preparedSelection));
 		auto location = std::make_optional(schema_location { position.line, position.column });
 
-		_values.push_back({ alias, std::move(location), std::move(result) });
+		_values.push_back({ alias, std::move(location), std::move(result), std::move(writer) });
 	}
 	catch (schema_exception& scx)
 	{
@@ -1149,8 +2082,15 @@ void SelectionVisitor::visitFragmentSpread(const peg::ast_node& fragmentSpread)
 		return;
 	}
 
+	auto directives = directiveVisitor.getDirectives();
+
+	if (deferFragment(itr->second.getSelection(), directives))
+	{
+		return;
+	}
+
 	_fragmentDefinitionDirectives->push_front(itr->second.getDirectives());
-	_fragmentSpreadDirectives->push_front(directiveVisitor.getDirectives());
+	_fragmentSpreadDirectives->push_front(std::move(directives));
 
 	const size_t count = itr->second.getSelection().children.size();
 
@@ -1195,7 +2135,14 @@ void SelectionVisitor::visitInlineFragment(const peg::ast_node& inlineFragment)
 	{
 		peg::on_first_child<peg::selection_set>(inlineFragment,
 			[this, &directiveVisitor](const peg::ast_node& child) {
-				_inlineFragmentDirectives->push_front(directiveVisitor.getDirectives());
+				auto directives = directiveVisitor.getDirectives();
+
+				if (deferFragment(child, directives))
+				{
+					return;
+				}
+
+				_inlineFragmentDirectives->push_front(std::move(directives));
 
 				const size_t count = child.children.size();
 
@@ -1215,67 +2162,348 @@ void SelectionVisitor::visitInlineFragment(const peg::ast_node& inlineFragment)
 	}
 }
 
-Object::Object(TypeNames&& typeNames, ResolverMap&& resolvers) noexcept
-	: _typeNames(std::move(typeNames))
-	, _resolvers(std::move(resolvers))
+void SelectionVisitor::visit(const PreparedSelection& selection)
 {
+	if (const auto field = std::get_if<PreparedField>(&selection))
+	{
+		visitField(*field);
+	}
+	else if (const auto fragmentSpread = std::get_if<PreparedFragmentSpread>(&selection))
+	{
+		visitFragmentSpread(*fragmentSpread);
+	}
+	else if (const auto inlineFragment = std::get_if<PreparedInlineFragment>(&selection))
+	{
+		visitInlineFragment(*inlineFragment);
+	}
 }
 
-AwaitableResolver Object::resolve(const SelectionSetParams& selectionSetParams,
-	const peg::ast_node& selection, const FragmentMap& fragments,
-	const response::Value& variables) const
+void SelectionVisitor::visitField(const PreparedField& field)
 {
-	SelectionVisitor visitor(selectionSetParams,
-		fragments,
-		variables,
-		_typeNames,
-		_resolvers,
-		selection.children.size());
+	if (!_names.emplace(field.alias).second)
+	{
+		// Skip resolving fields which map to the same response name as a field we've already
+		// resolved.
+		return;
+	}
 
-	beginSelectionSet(selectionSetParams);
+	const auto resolver = findResolver(field.field, field.name, field.alias);
 
-	for (const auto& child : selection.children)
+	if (resolver == nullptr)
 	{
-		visitor.visit(*child);
+		return;
 	}
 
-	endSelectionSet(selectionSetParams);
+	auto directives = field.directives.evaluate(_variables);
 
-	auto children = visitor.getValues();
-	const auto launch = selectionSetParams.launch;
-	ResolverResult document { response::Value { response::Type::Map } };
+	if (!directives)
+	{
+		return;
+	}
 
-	document.data.reserve(children.size());
+	resolveField(*resolver,
+		field.field,
+		field.alias,
+		std::move(*directives),
+		field.arguments.evaluate(_variables),
+		field.selection ? &field.selection->node : nullptr,
+		field.selection.get());
+}
 
-	const auto parent = selectionSetParams.errorPath
-		? std::make_optional(std::cref(*selectionSetParams.errorPath))
-		: std::nullopt;
+void SelectionVisitor::visitFragmentSpread(const PreparedFragmentSpread& fragmentSpread)
+{
+	const auto& fragment = fragmentSpread.fragment;
 
-	for (auto& child : children)
+	if (_typeNames.find(fragment.type) == _typeNames.end())
 	{
-		try
-		{
-			co_await launch;
+		return;
+	}
 
-			auto value = co_await std::move(child.result);
+	auto directives = fragmentSpread.directives.evaluate(_variables);
 
-			if (!document.data.emplace_back(std::string { child.name }, std::move(value.data)))
-			{
-				std::ostringstream message;
+	if (!directives)
+	{
+		return;
+	}
 
-				message << "Ambiguous field error name: " << child.name;
+	// Fragment definition directives which reference variables are evaluated once per request in
+	// the FragmentMap.
+	_fragmentDefinitionDirectives->push_front(fragment.directives.node
+			? _fragments.find(fragment.name)->second.getDirectives()
+			: fragment.directives.constant);
+	_fragmentSpreadDirectives->push_front(std::move(*directives));
 
-				field_path path { parent, path_segment { child.name } };
+	const size_t count = fragment.selection->selections.size();
 
-				document.errors.push_back({ message.str(),
-					child.location.value_or(schema_location {}),
-					buildErrorPath(std::make_optional(path)) });
-			}
+	if (count > 1)
+	{
+		_names.reserve(_names.capacity() + count - 1);
+		_values.reserve(_values.capacity() + count - 1);
+	}
 
-			if (!value.errors.empty())
-			{
-				document.errors.splice(document.errors.end(), value.errors);
-			}
+	for (const auto& selection : fragment.selection->selections)
+	{
+		visit(selection);
+	}
+
+	_fragmentSpreadDirectives->pop_front();
+	_fragmentDefinitionDirectives->pop_front();
+}
+
+void SelectionVisitor::visitInlineFragment(const PreparedInlineFragment& inlineFragment)
+{
+	auto directives = inlineFragment.directives.evaluate(_variables);
+
+	if (!directives)
+	{
+		return;
+	}
+
+	if (!inlineFragment.selection
+		|| (!inlineFragment.typeCondition.empty()
+			&& _typeNames.find(inlineFragment.typeCondition) == _typeNames.end()))
+	{
+		return;
+	}
+
+	_inlineFragmentDirectives->push_front(std::move(*directives));
+
+	const size_t count = inlineFragment.selection->selections.size();
+
+	if (count > 1)
+	{
+		_names.reserve(_names.capacity() + count - 1);
+		_values.reserve(_values.capacity() + count - 1);
+	}
+
+	for (const auto& selection : inlineFragment.selection->selections)
+	{
+		visit(selection);
+	}
+
+	_inlineFragmentDirectives->pop_front();
+}
+
+Object::Object(const TypeNames& typeNames, const ResolverMap& resolvers,
+	const Object* implementation) noexcept
+	: _typeNames(typeNames)
+	, _resolvers(resolvers)
+	, _implementation(implementation ? *implementation : *this)
+{
+}
+
+AwaitableResolver Object::resolve(const SelectionSetParams& selectionSetParams,
+	const peg::ast_node& selection, const FragmentMap& fragments,
+	const response::Value& variables) const
+{
+	return resolveSelectionSet(selectionSetParams, &selection, nullptr, fragments, variables);
+}
+
+AwaitableResolver Object::resolve(const SelectionSetParams& selectionSetParams,
+	const PreparedSelectionSet& selection, const FragmentMap& fragments,
+	const response::Value& variables) const
+{
+	return resolveSelectionSet(selectionSetParams, &selection.node, &selection, fragments, variables);
+}
+
+// Resolve a deferred fragment with its own SelectionSetParams, since the frames which owned the
+// original parameters are gone by the time it is started.
+AwaitableResolver resolveDeferredFragment(std::shared_ptr<const Object> object,
+	ResolverContext resolverContext, std::shared_ptr<RequestState> state,
+	const Directives& operationDirectives, std::optional<field_path> errorPath, await_async launch,
+	std::shared_ptr<IncrementalPayloads> incremental, std::pmr::memory_resource* resource,
+	const peg::ast_node& selection, const FragmentMap& fragments, const response::Value& variables)
+{
+	const SelectionSetParams selectionSetParams {
+		resolverContext,
+		state,
+		operationDirectives,
+		std::make_shared<FragmentDefinitionDirectiveStack>(),
+		std::make_shared<FragmentSpreadDirectiveStack>(),
+		std::make_shared<FragmentSpreadDirectiveStack>(),
+		std::move(errorPath),
+		launch,
+		std::move(incremental),
+		resource,
+	};
+
+	co_return co_await object->resolve(selectionSetParams, selection, fragments, variables);
+}
+
+AwaitableResolver Object::resolveSelectionSet(const SelectionSetParams& selectionSetParams,
+	const peg::ast_node* selection, const PreparedSelectionSet* preparedSelection,
+	const FragmentMap& fragments, const response::Value& variables) const
+{
+	std::vector<SelectionVisitor::VisitorValue> children;
+	std::vector<SelectionVisitor::DeferredFragment> deferred;
+
+	{
+		// Start every sibling field before dispatching the batches they loaded.
+		const RequestState::BatchScope batchScope { selectionSetParams.state.get() };
+		SelectionVisitor visitor(selectionSetParams,
+			fragments,
+			variables,
+			_typeNames,
+			_resolvers,
+			_implementation,
+			preparedSelection ? preparedSelection->selections.size() : selection->children.size(),
+			!weak_from_this().expired());
+
+		beginSelectionSet(selectionSetParams);
+
+		if (preparedSelection)
+		{
+			for (const auto& child : preparedSelection->selections)
+			{
+				visitor.visit(child);
+			}
+		}
+		else
+		{
+			for (const auto& child : selection->children)
+			{
+				visitor.visit(*child);
+			}
+		}
+
+		endSelectionSet(selectionSetParams);
+
+		children = visitor.getValues();
+		deferred = visitor.getDeferred();
+	}
+
+	if (!deferred.empty())
+	{
+		// The deferred fragments keep this Object alive until they are delivered.
+		const auto object = shared_from_this();
+		const auto path = buildErrorPath(selectionSetParams.errorPath);
+
+		for (auto& fragment : deferred)
+		{
+			selectionSetParams.incremental->push({ path,
+				std::move(fragment.label),
+				false,
+				[object,
+					resolverContext = selectionSetParams.resolverContext,
+					state = selectionSetParams.state,
+					operationDirectives = &selectionSetParams.operationDirectives,
+					launch = selectionSetParams.launch,
+					resource = selectionSetParams.resource,
+					fragmentSelection = &fragment.selection,
+					fragments = &fragments,
+					variables = &variables](std::optional<field_path> errorPath,
+					std::shared_ptr<IncrementalPayloads> incremental) {
+					return resolveDeferredFragment(object,
+						resolverContext,
+						state,
+						*operationDirectives,
+						std::move(errorPath),
+						launch,
+						std::move(incremental),
+						resource,
+						*fragmentSelection,
+						*fragments,
+						*variables);
+				} });
+		}
+	}
+
+	const auto launch = selectionSetParams.launch;
+	const auto writer = selectionSetParams.writer;
+	ResolverResult document { writer
+			? response::Value {}
+			: response::Value { response::Type::Map, selectionSetParams.resource } };
+	internal::string_view_set writtenNames;
+
+	// With a writer, the first field with each name is attached to it before it is awaited, so it
+	// can write its own value as it resolves. The children are awaited in order, so the writer
+	// receives them in document order.
+	const auto startField = [&writtenNames, writer](SelectionVisitor::VisitorValue& child) {
+		if (!writtenNames.emplace(child.name).second)
+		{
+			return false;
+		}
+
+		writer->add_member(child.name);
+
+		if (child.writer)
+		{
+			child.writer->attach(*writer);
+		}
+
+		return true;
+	};
+
+	// Either add the field to the map, or finish writing it if this is the first field with that
+	// name.
+	const auto addField = [&document, writer](SelectionVisitor::VisitorValue& child,
+							  bool started,
+							  response::Value&& value) -> bool {
+		if (!writer)
+		{
+			return document.data.emplace_back(std::string { child.name }, std::move(value));
+		}
+
+		if (!started)
+		{
+			return false;
+		}
+
+		if (child.writer)
+		{
+			child.writer->finish(std::move(value));
+		}
+		else
+		{
+			writer->write(std::move(value));
+		}
+
+		return true;
+	};
+
+	if (writer)
+	{
+		writtenNames.reserve(children.size());
+		writer->start_object();
+	}
+	else
+	{
+		document.data.reserve(children.size());
+	}
+
+	const auto parent = selectionSetParams.errorPath
+		? std::make_optional(std::cref(*selectionSetParams.errorPath))
+		: std::nullopt;
+
+	for (auto& child : children)
+	{
+		bool started = false;
+
+		try
+		{
+			co_await launch;
+
+			started = writer && startField(child);
+
+			auto value = co_await std::move(child.result);
+
+			if (!addField(child, started, std::move(value.data)))
+			{
+				std::ostringstream message;
+
+				message << "Ambiguous field error name: " << child.name;
+
+				field_path path { parent, path_segment { child.name } };
+
+				document.errors.push_back({ message.str(),
+					child.location.value_or(schema_location {}),
+					buildErrorPath(std::make_optional(path)) });
+			}
+
+			if (!value.errors.empty())
+			{
+				document.errors.splice(document.errors.end(), value.errors);
+			}
 		}
 		catch (schema_exception& scx)
 		{
@@ -1286,7 +2514,7 @@ AwaitableResolver Object::resolve(const SelectionSetParams& selectionSetParams,
 				std::copy(errors.begin(), errors.end(), std::back_inserter(document.errors));
 			}
 
-			document.data.emplace_back(std::string { child.name }, {});
+			addField(child, started || (writer && startField(child)), {});
 		}
 		catch (const std::exception& ex)
 		{
@@ -1299,10 +2527,15 @@ AwaitableResolver Object::resolve(const SelectionSetParams& selectionSetParams,
 			document.errors.push_back({ message.str(),
 				child.location.value_or(schema_location {}),
 				buildErrorPath(std::make_optional(path)) });
-			document.data.emplace_back(std::string { child.name }, {});
+			addField(child, started || (writer && startField(child)), {});
 		}
 	}
 
+	if (writer)
+	{
+		writer->end_object();
+	}
+
 	co_return std::move(document);
 }
 
@@ -1322,7 +2555,7 @@ void Object::endSelectionSet(const SelectionSetParams&) const
 }
 
 OperationData::OperationData(std::shared_ptr<RequestState> state, response::Value variables,
-	Directives directives, FragmentMap fragments)
+	Directives directives, std::shared_ptr<const FragmentMap> fragments)
 	: state(std::move(state))
 	, variables(std::move(variables))
 	, directives(std::move(directives))
@@ -1371,7 +2604,8 @@ class OperationDefinitionVisitor
 public:
 	OperationDefinitionVisitor(ResolverContext resolverContext, await_async launch,
 		std::shared_ptr<RequestState> state, const TypeMap& operations, response::Value&& variables,
-		FragmentMap&& fragments);
+		FragmentMap&& fragments, std::pmr::memory_resource* resource, ValueWriter* writer = nullptr,
+		std::shared_ptr<IncrementalPayloads> incremental = {});
 
 	AwaitableResolver getValue();
 
@@ -1382,17 +2616,26 @@ private:
 	const await_async _launch;
 	std::shared_ptr<OperationData> _params;
 	const TypeMap& _operations;
+	ValueWriter* const _writer;
+	const std::shared_ptr<IncrementalPayloads> _incremental;
+	std::pmr::memory_resource* const _resource;
 	std::optional<AwaitableResolver> _result;
 };
 
 OperationDefinitionVisitor::OperationDefinitionVisitor(ResolverContext resolverContext,
 	await_async launch, std::shared_ptr<RequestState> state, const TypeMap& operations,
-	response::Value&& variables, FragmentMap&& fragments)
+	response::Value&& variables, FragmentMap&& fragments, std::pmr::memory_resource* resource,
+	ValueWriter* writer, std::shared_ptr<IncrementalPayloads> incremental)
 	: _resolverContext(resolverContext)
 	, _launch(launch)
-	, _params(std::make_shared<OperationData>(
-		  std::move(state), std::move(variables), Directives {}, std::move(fragments)))
+	, _params(std::make_shared<OperationData>(std::move(state),
+		  std::move(variables),
+		  Directives {},
+		  std::make_shared<const FragmentMap>(std::move(fragments))))
 	, _operations(operations)
+	, _writer(writer)
+	, _incremental(std::move(incremental))
+	, _resource(resource)
 {
 }
 
@@ -1471,122 +2714,148 @@ void OperationDefinitionVisitor::visit(
 		std::make_shared<FragmentSpreadDirectiveStack>(),
 		std::nullopt,
 		_launch,
+		_incremental,
+		_resource,
+		_writer,
 	};
 
 	_result = std::make_optional(itr->second->resolve(selectionSetParams,
 		*operationDefinition.children.back(),
-		_params->fragments,
+		*_params->fragments,
 		_params->variables));
 }
 
-SubscriptionData::SubscriptionData(std::shared_ptr<OperationData> data, SubscriptionName&& field,
-	response::Value arguments, Directives fieldDirectives, peg::ast&& query,
-	std::string&& operationName, SubscriptionCallback&& callback, const peg::ast_node& selection)
-	: data(std::move(data))
-	, field(std::move(field))
-	, arguments(std::move(arguments))
-	, fieldDirectives(std::move(fieldDirectives))
-	, query(std::move(query))
-	, operationName(std::move(operationName))
-	, callback(std::move(callback))
-	, selection(selection)
+// PreparedOperation is the execution plan for a single query or mutation operation. It holds onto
+// the AST, so the nodes referenced by the plan stay alive as long as it does.
+struct PreparedOperation
 {
-}
+	peg::ast query;
+	std::string_view operationType;
 
-// SubscriptionDefinitionVisitor visits the AST collects the fields referenced in the
-// subscription at the point where we create a subscription.
-class SubscriptionDefinitionVisitor
+	// Operation variable names (without the $ prefix) and their default values.
+	std::vector<std::pair<std::string_view, response::Value>> variables;
+	PreparedDirectives directives { nullptr };
+
+	// The FragmentMap is only built for each request if any of the fragment definition directives
+	// reference variables.
+	std::vector<const peg::ast_node*> fragmentDefinitions;
+	std::optional<FragmentMap> fragments;
+	internal::string_view_map<std::unique_ptr<PreparedFragment>> preparedFragments;
+
+	std::unique_ptr<PreparedSelectionSet> selection;
+};
+
+// PreparedOperationVisitor compiles an operation definition and the fragment definitions it
+// references into a PreparedOperation.
+class PreparedOperationVisitor
 {
 public:
-	SubscriptionDefinitionVisitor(RequestSubscribeParams&& params, FragmentMap&& fragments,
-		const std::shared_ptr<const Object>& subscriptionObject);
-
-	const peg::ast_node& getRoot() const;
-	std::shared_ptr<SubscriptionData> getRegistration();
+	explicit PreparedOperationVisitor(PreparedOperation& operation);
 
 	void visit(const peg::ast_node& operationDefinition);
 
 private:
-	void visitField(const peg::ast_node& field);
-	void visitFragmentSpread(const peg::ast_node& fragmentSpread);
-	void visitInlineFragment(const peg::ast_node& inlineFragment);
+	std::unique_ptr<PreparedSelectionSet> visitSelectionSet(const peg::ast_node& selectionSet);
+	PreparedField visitField(const peg::ast_node& field);
+	PreparedFragmentSpread visitFragmentSpread(const peg::ast_node& fragmentSpread);
+	PreparedInlineFragment visitInlineFragment(const peg::ast_node& inlineFragment);
 
-	RequestSubscribeParams _params;
-	FragmentMap _fragments;
-	const std::shared_ptr<const Object>& _subscriptionObject;
-	SubscriptionName _field;
-	response::Value _arguments;
-	Directives _fieldDirectives;
-	std::shared_ptr<SubscriptionData> _result;
+	PreparedOperation& _operation;
+	internal::string_view_map<const peg::ast_node*> _fragmentDefinitions;
 };
 
-SubscriptionDefinitionVisitor::SubscriptionDefinitionVisitor(RequestSubscribeParams&& params,
-	FragmentMap&& fragments, const std::shared_ptr<const Object>& subscriptionObject)
-	: _params(std::move(params))
-	, _fragments(std::move(fragments))
-	, _subscriptionObject(subscriptionObject)
+PreparedOperationVisitor::PreparedOperationVisitor(PreparedOperation& operation)
+	: _operation(operation)
 {
-}
+	bool constantFragments = true;
 
-const peg::ast_node& SubscriptionDefinitionVisitor::getRoot() const
-{
-	return *_params.query.root;
+	peg::for_each_child<peg::fragment_definition>(*_operation.query.root,
+		[this, &constantFragments](const peg::ast_node& child) {
+			_fragmentDefinitions.emplace(child.children.front()->string_view(), &child);
+			_operation.fragmentDefinitions.push_back(&child);
+
+			peg::on_first_child<peg::directives>(child,
+				[&constantFragments](const peg::ast_node& directives) {
+					constantFragments = constantFragments && !referencesVariables(directives);
+				});
+		});
+
+	if (constantFragments)
+	{
+		FragmentDefinitionVisitor fragmentVisitor(noVariables());
+
+		for (const auto fragmentDefinition : _operation.fragmentDefinitions)
+		{
+			fragmentVisitor.visit(*fragmentDefinition);
+		}
+
+		_operation.fragments = std::make_optional(fragmentVisitor.getFragments());
+	}
 }
 
-std::shared_ptr<SubscriptionData> SubscriptionDefinitionVisitor::getRegistration()
+void PreparedOperationVisitor::visit(const peg::ast_node& operationDefinition)
 {
-	auto result = std::move(_result);
+	peg::for_each_child<peg::variable>(operationDefinition,
+		[this](const peg::ast_node& variable) {
+			std::string_view variableName;
 
-	_result.reset();
+			peg::on_first_child<peg::variable_name>(variable,
+				[&variableName](const peg::ast_node& name) {
+					// Skip the $ prefix
+					variableName = name.string_view().substr(1);
+				});
 
-	return result;
+			response::Value defaultValue;
+
+			peg::on_first_child<peg::default_value>(variable,
+				[&defaultValue](const peg::ast_node& child) {
+					ValueVisitor visitor(noVariables());
+
+					visitor.visit(*child.children.front());
+					defaultValue = visitor.getValue();
+				});
+
+			_operation.variables.emplace_back(variableName, std::move(defaultValue));
+		});
+
+	const peg::ast_node* directives = nullptr;
+
+	peg::on_first_child<peg::directives>(operationDefinition,
+		[&directives](const peg::ast_node& child) {
+			directives = &child;
+		});
+
+	_operation.directives = PreparedDirectives { directives };
+	_operation.selection = visitSelectionSet(*operationDefinition.children.back());
 }
 
-void SubscriptionDefinitionVisitor::visit(const peg::ast_node& operationDefinition)
+std::unique_ptr<PreparedSelectionSet> PreparedOperationVisitor::visitSelectionSet(
+	const peg::ast_node& selectionSet)
 {
-	const auto& selection = *operationDefinition.children.back();
+	auto result = std::make_unique<PreparedSelectionSet>(PreparedSelectionSet { selectionSet, {} });
 
-	for (const auto& child : selection.children)
+	result->selections.reserve(selectionSet.children.size());
+
+	for (const auto& child : selectionSet.children)
 	{
 		if (child->is_type<peg::field>())
 		{
-			visitField(*child);
+			result->selections.emplace_back(visitField(*child));
 		}
 		else if (child->is_type<peg::fragment_spread>())
 		{
-			visitFragmentSpread(*child);
+			result->selections.emplace_back(visitFragmentSpread(*child));
 		}
 		else if (child->is_type<peg::inline_fragment>())
 		{
-			visitInlineFragment(*child);
+			result->selections.emplace_back(visitInlineFragment(*child));
 		}
 	}
 
-	Directives directives;
-
-	peg::on_first_child<peg::directives>(operationDefinition,
-		[this, &directives](const peg::ast_node& child) {
-			DirectiveVisitor directiveVisitor(_params.variables);
-
-			directiveVisitor.visit(child);
-			directives = directiveVisitor.getDirectives();
-		});
-
-	_result =
-		std::make_shared<SubscriptionData>(std::make_shared<OperationData>(std::move(_params.state),
-											   std::move(_params.variables),
-											   std::move(directives),
-											   std::move(_fragments)),
-			std::move(_field),
-			std::move(_arguments),
-			std::move(_fieldDirectives),
-			std::move(_params.query),
-			std::move(_params.operationName),
-			std::move(_params.callback),
-			selection);
+	return result;
 }
 
-void SubscriptionDefinitionVisitor::visitField(const peg::ast_node& field)
+PreparedField PreparedOperationVisitor::visitField(const peg::ast_node& field)
 {
 	std::string_view name;
 
@@ -1594,256 +2863,1923 @@ void SubscriptionDefinitionVisitor::visitField(const peg::ast_node& field)
 		name = child.string_view();
 	});
 
-	// https://spec.graphql.org/October2021/#sec-Single-root-field
-	if (!_field.empty())
-	{
-		auto position = field.begin();
-		std::ostringstream error;
+	std::string_view alias;
 
-		error << "Extra subscription root field name: " << name;
+	peg::on_first_child<peg::alias_name>(field, [&alias](const peg::ast_node& child) {
+		alias = child.string_view();
+	});
 
-		throw schema_exception {
-			{ schema_error { error.str(), { position.line, position.column } } }
-		};
+	if (alias.empty())
+	{
+		alias = name;
 	}
 
-	DirectiveVisitor directiveVisitor(_params.variables);
+	const peg::ast_node* directives = nullptr;
 
-	peg::on_first_child<peg::directives>(field, [&directiveVisitor](const peg::ast_node& child) {
-		directiveVisitor.visit(child);
+	peg::on_first_child<peg::directives>(field, [&directives](const peg::ast_node& child) {
+		directives = &child;
 	});
 
-	if (directiveVisitor.shouldSkip())
-	{
-		return;
-	}
+	const peg::ast_node* arguments = nullptr;
 
-	_fieldDirectives = directiveVisitor.getDirectives();
+	peg::on_first_child<peg::arguments>(field, [&arguments](const peg::ast_node& child) {
+		arguments = &child;
+	});
 
-	response::Value arguments(response::Type::Map);
+	std::unique_ptr<PreparedSelectionSet> selection;
 
-	peg::on_first_child<peg::arguments>(field, [this, &arguments](const peg::ast_node& child) {
-		ValueVisitor visitor(_params.variables);
+	peg::on_first_child<peg::selection_set>(field, [this, &selection](const peg::ast_node& child) {
+		selection = visitSelectionSet(child);
+	});
 
-		for (auto& argument : child.children)
+	return PreparedField {
+		field,
+		name,
+		alias,
+		PreparedDirectives { directives },
+		PreparedArguments { arguments },
+		std::move(selection),
+	};
+}
+
+PreparedFragmentSpread PreparedOperationVisitor::visitFragmentSpread(
+	const peg::ast_node& fragmentSpread)
+{
+	const auto name = fragmentSpread.children.front()->string_view();
+	auto itrPrepared = _operation.preparedFragments.find(name);
+
+	if (itrPrepared == _operation.preparedFragments.end())
+	{
+		auto itrDefinition = _fragmentDefinitions.find(name);
+
+		if (itrDefinition == _fragmentDefinitions.end())
 		{
-			visitor.visit(*argument->children.back());
+			auto position = fragmentSpread.begin();
+			std::ostringstream error;
 
-			arguments.emplace_back(argument->children.front()->string(), visitor.getValue());
+			error << "Unknown fragment name: " << name;
+
+			throw schema_exception {
+				{ schema_error { error.str(), { position.line, position.column } } }
+			};
 		}
+
+		const auto& fragmentDefinition = *itrDefinition->second;
+		const peg::ast_node* directives = nullptr;
+
+		peg::on_first_child<peg::directives>(fragmentDefinition,
+			[&directives](const peg::ast_node& child) {
+				directives = &child;
+			});
+
+		// Validation rejects fragment cycles, so each fragment definition is only compiled once
+		// no matter how many times it's referenced.
+		auto fragment = std::make_unique<PreparedFragment>(PreparedFragment {
+			name,
+			fragmentDefinition.children[1]->children.front()->string_view(),
+			PreparedDirectives { directives },
+			visitSelectionSet(*fragmentDefinition.children.back()),
+		});
+
+		itrPrepared = _operation.preparedFragments.emplace(name, std::move(fragment)).first;
+	}
+
+	const peg::ast_node* directives = nullptr;
+
+	peg::on_first_child<peg::directives>(fragmentSpread, [&directives](const peg::ast_node& child) {
+		directives = &child;
 	});
 
-	_field = std::move(name);
-	_arguments = std::move(arguments);
+	return PreparedFragmentSpread {
+		*itrPrepared->second,
+		PreparedDirectives { directives },
+	};
 }
 
-void SubscriptionDefinitionVisitor::visitFragmentSpread(const peg::ast_node& fragmentSpread)
+PreparedInlineFragment PreparedOperationVisitor::visitInlineFragment(
+	const peg::ast_node& inlineFragment)
 {
-	const auto name = fragmentSpread.children.front()->string_view();
-	auto itr = _fragments.find(name);
+	const peg::ast_node* directives = nullptr;
 
-	if (itr == _fragments.end())
+	peg::on_first_child<peg::directives>(inlineFragment, [&directives](const peg::ast_node& child) {
+		directives = &child;
+	});
+
+	std::string_view typeCondition;
+
+	peg::on_first_child<peg::type_condition>(inlineFragment,
+		[&typeCondition](const peg::ast_node& child) {
+			typeCondition = child.children.front()->string_view();
+		});
+
+	std::unique_ptr<PreparedSelectionSet> selection;
+
+	peg::on_first_child<peg::selection_set>(inlineFragment,
+		[this, &selection](const peg::ast_node& child) {
+			selection = visitSelectionSet(child);
+		});
+
+	return PreparedInlineFragment {
+		typeCondition,
+		PreparedDirectives { directives },
+		std::move(selection),
+	};
+}
+
+SubscriptionData::SubscriptionData(std::shared_ptr<OperationData> data, SubscriptionName&& field,
+	response::Value arguments, Directives fieldDirectives, std::shared_ptr<const peg::ast> query,
+	std::string_view normalizedQuery, std::string&& operationName, SubscriptionCallback&& callback,
+	const peg::ast_node& selection)
+	: data(std::move(data))
+	, field(std::move(field))
+	, arguments(std::move(arguments))
+	, fieldDirectives(std::move(fieldDirectives))
+	, query(std::move(query))
+	, normalizedQuery(normalizedQuery)
+	, operationName(std::move(operationName))
+	, callback(std::move(callback))
+	, selection(selection)
+	, fingerprint((std::hash<std::string_view> {}(this->operationName) * 31)
+		  + std::hash<std::string_view> {}(normalizedQuery))
+{
+}
+
+namespace {
+
+// Values which compare equal must have the same hash. String, EnumValue, and ID values can all
+// compare equal to each other, so those are hashed by their string representation.
+size_t hashArgumentValue(const response::Value& value)
+{
+	switch (value.type())
 	{
-		auto position = fragmentSpread.begin();
-		std::ostringstream error;
+		case response::Type::Map:
+		{
+			size_t hash = static_cast<size_t>(response::Type::Map);
 
-		error << "Unknown fragment name: " << name;
+			for (const auto& [name, member] : value.get<response::MapType>())
+			{
+				hash = (hash * 31) + std::hash<std::string_view> {}(name);
+				hash = (hash * 31) + hashArgumentValue(member);
+			}
 
-		throw schema_exception {
-			{ schema_error { error.str(), { position.line, position.column } } }
-		};
+			return hash;
+		}
+
+		case response::Type::List:
+		{
+			size_t hash = static_cast<size_t>(response::Type::List);
+
+			for (const auto& entry : value.get<response::ListType>())
+			{
+				hash = (hash * 31) + hashArgumentValue(entry);
+			}
+
+			return hash;
+		}
+
+		case response::Type::String:
+		case response::Type::EnumValue:
+			return std::hash<std::string_view> {}(value.get<response::StringType>());
+
+		case response::Type::ID:
+		{
+			const auto& id = value.get<response::IdType>();
+
+			if (id.isBase64())
+			{
+				return std::hash<std::string> {}(
+					internal::Base64::toBase64(id.get<response::IdType::ByteData>()));
+			}
+
+			return std::hash<std::string_view> {}(id.get<response::IdType::OpaqueString>());
+		}
+
+		case response::Type::Boolean:
+			return std::hash<bool> {}(value.get<response::BooleanType>());
+
+		case response::Type::Int:
+			return std::hash<response::IntType> {}(value.get<response::IntType>());
+
+		case response::Type::Float:
+			return std::hash<response::FloatType> {}(value.get<response::FloatType>());
+
+		case response::Type::Scalar:
+			return hashArgumentValue(value.get<response::ScalarType>());
+
+		default:
+			return static_cast<size_t>(value.type());
 	}
+}
 
-	bool skip = !_subscriptionObject->matchesType(itr->second.getType());
-	DirectiveVisitor directiveVisitor(_params.variables);
+// Combine the hashes of the values for every indexed argument, or return std::nullopt if one of
+// them is missing.
+template <typename FindArgument>
+std::optional<size_t> hashIndexedArguments(
+	const std::vector<std::string>& argumentNames, FindArgument&& findArgument)
+{
+	size_t hash = 0;
 
-	if (!skip)
+	for (const auto& name : argumentNames)
 	{
-		peg::on_first_child<peg::directives>(fragmentSpread,
-			[&directiveVisitor](const peg::ast_node& child) {
-				directiveVisitor.visit(child);
-			});
+		const response::Value* value = findArgument(name);
 
-		skip = directiveVisitor.shouldSkip();
+		if (!value)
+		{
+			return std::nullopt;
+		}
+
+		hash = (hash * 31) + hashArgumentValue(*value);
 	}
 
-	if (skip)
+	return { hash };
+}
+
+std::optional<size_t> hashIndexedArguments(
+	const std::vector<std::string>& argumentNames, const SubscriptionData& registration)
+{
+	return hashIndexedArguments(argumentNames,
+		[&arguments = registration.arguments](
+			std::string_view name) noexcept -> const response::Value* {
+			const auto itr = arguments.find(name);
+
+			return itr == arguments.get<response::MapType>().cend() ? nullptr : &itr->second;
+		});
+}
+
+} // namespace
+
+SubscriptionArgumentIndex::SubscriptionArgumentIndex(
+	std::vector<std::string> argumentNames) noexcept
+	: _argumentNames { std::move(argumentNames) }
+{
+}
+
+void SubscriptionArgumentIndex::add(SubscriptionKey key, const SubscriptionData& registration)
+{
+	const auto hash = hashIndexedArguments(_argumentNames, registration);
+	const std::lock_guard lock { _mutex };
+
+	if (hash)
 	{
-		return;
+		_keys.emplace(*hash, key);
 	}
-
-	for (const auto& selection : itr->second.getSelection().children)
+	else
 	{
-		visit(*selection);
+		_unindexed.emplace(key);
 	}
 }
 
-void SubscriptionDefinitionVisitor::visitInlineFragment(const peg::ast_node& inlineFragment)
+void SubscriptionArgumentIndex::remove(SubscriptionKey key, const SubscriptionData& registration)
 {
-	DirectiveVisitor directiveVisitor(_params.variables);
+	const auto hash = hashIndexedArguments(_argumentNames, registration);
+	const std::lock_guard lock { _mutex };
 
-	peg::on_first_child<peg::directives>(inlineFragment,
-		[&directiveVisitor](const peg::ast_node& child) {
-			directiveVisitor.visit(child);
+	if (hash)
+	{
+		const auto [itrBegin, itrEnd] = _keys.equal_range(*hash);
+		const auto itr = std::find_if(itrBegin, itrEnd, [key](const auto& entry) noexcept {
+			return entry.second == key;
 		});
 
-	if (directiveVisitor.shouldSkip())
+		if (itr != itrEnd)
+		{
+			_keys.erase(itr);
+		}
+	}
+	else
 	{
-		return;
+		_unindexed.erase(key);
 	}
+}
 
-	const peg::ast_node* typeCondition = nullptr;
+std::optional<std::vector<SubscriptionKey>> SubscriptionArgumentIndex::find(
+	const SubscriptionArguments& arguments) const
+{
+	const auto hash = hashIndexedArguments(_argumentNames,
+		[&arguments](std::string_view name) noexcept -> const response::Value* {
+			const auto itr = arguments.find(name);
 
-	peg::on_first_child<peg::type_condition>(inlineFragment,
-		[&typeCondition](const peg::ast_node& child) {
-			typeCondition = &child;
+			return itr == arguments.cend() ? nullptr : &itr->second;
 		});
 
-	if (typeCondition == nullptr
-		|| _subscriptionObject->matchesType(typeCondition->children.front()->string()))
+	if (!hash)
 	{
-		peg::on_first_child<peg::selection_set>(inlineFragment, [this](const peg::ast_node& child) {
-			for (const auto& selection : child.children)
-			{
-				visit(*selection);
-			}
-		});
+		return std::nullopt;
+	}
+
+	std::unique_lock lock { _mutex };
+	const auto [itrBegin, itrEnd] = _keys.equal_range(*hash);
+	std::vector<SubscriptionKey> keys(_unindexed.begin(), _unindexed.end());
+
+	std::transform(itrBegin, itrEnd, std::back_inserter(keys), [](const auto& entry) noexcept {
+		return entry.second;
+	});
+
+	lock.unlock();
+
+	// Deliver to the matching subscriptions in the order they were registered.
+	std::sort(keys.begin(), keys.end());
+
+	return { std::move(keys) };
+}
+
+// Hash a SubscriptionName and a std::string_view the same way, so snapshot can look up the
+// listeners on a field without building a SubscriptionName for it.
+struct SubscriptionNameHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view name) const noexcept
+	{
+		return std::hash<std::string_view> {}(name);
 	}
+};
+
+struct SubscriptionRegistry::Shard
+{
+	std::mutex mutex;
+	std::unordered_map<SubscriptionKey, std::shared_ptr<const SubscriptionData>> subscriptions;
+	std::unordered_map<SubscriptionName,
+		std::map<SubscriptionKey, std::shared_ptr<const SubscriptionData>>,
+		SubscriptionNameHash,
+		std::equal_to<>>
+		listeners;
+};
+
+SubscriptionRegistry::SubscriptionRegistry(size_t shardCount)
+	: _shardCount { std::max(shardCount, size_t { 1 }) }
+	, _shards { std::make_unique<Shard[]>(_shardCount) }
+{
 }
 
-Request::Request(TypeMap operationTypes, std::shared_ptr<schema::Schema> schema)
-	: _operations(std::move(operationTypes))
-	, _validation(std::make_unique<ValidateExecutableVisitor>(std::move(schema)))
+SubscriptionRegistry::~SubscriptionRegistry()
 {
+	// The default implementation is fine, but it needs the definition of
+	// SubscriptionRegistry::Shard.
 }
 
-Request::~Request()
+SubscriptionRegistry::Shard& SubscriptionRegistry::getShard(SubscriptionKey key) const noexcept
 {
-	// The default implementation is fine, but it can't be declared as = default because it
-	// needs to know how to destroy the _validation member and it can't do that with just a
-	// forward declaration of the class.
+	// Keys are assigned sequentially, so they already spread out evenly across the shards.
+	return _shards[key % _shardCount];
 }
 
-std::list<schema_error> Request::validate(peg::ast& query) const
+SubscriptionKey SubscriptionRegistry::add(std::shared_ptr<const SubscriptionData> registration)
 {
-	std::list<schema_error> errors;
+	const auto key = _nextKey.fetch_add(1, std::memory_order_relaxed);
+	auto& shard = getShard(key);
+	const std::lock_guard lock { shard.mutex };
 
-	if (!query.validated)
+	auto& listeners = shard.listeners[registration->field];
+
+	// Another thread may have taken a lower key for this shard and not added it yet, but usually
+	// this is the highest key.
+	listeners.emplace_hint(listeners.end(), key, registration);
+	shard.subscriptions.emplace(key, std::move(registration));
+
+	return key;
+}
+
+std::shared_ptr<const SubscriptionData> SubscriptionRegistry::remove(SubscriptionKey key)
+{
+	auto& shard = getShard(key);
+	const std::lock_guard lock { shard.mutex };
+	const auto itrSubscription = shard.subscriptions.find(key);
+
+	if (itrSubscription == shard.subscriptions.end())
 	{
-		const std::lock_guard lock { _validationMutex };
+		return {};
+	}
 
-		_validation->visit(*query.root);
-		errors = _validation->getStructuredErrors();
-		query.validated = errors.empty();
+	auto registration = std::move(itrSubscription->second);
+	const auto itrListeners = shard.listeners.find(registration->field);
+
+	shard.subscriptions.erase(itrSubscription);
+	itrListeners->second.erase(key);
+
+	if (itrListeners->second.empty())
+	{
+		shard.listeners.erase(itrListeners);
 	}
 
-	return errors;
+	return registration;
 }
 
-std::pair<std::string_view, const peg::ast_node*> Request::findOperationDefinition(
-	peg::ast& query, std::string_view operationName) const
+std::shared_ptr<const SubscriptionData> SubscriptionRegistry::find(SubscriptionKey key) const
 {
-	// Ensure the query has been validated.
-	auto errors = validate(query);
+	auto& shard = getShard(key);
+	const std::lock_guard lock { shard.mutex };
+	const auto itr = shard.subscriptions.find(key);
 
-	if (!errors.empty())
+	return itr == shard.subscriptions.end() ? std::shared_ptr<const SubscriptionData> {}
+											: itr->second;
+}
+
+std::vector<std::pair<SubscriptionKey, std::shared_ptr<const SubscriptionData>>>
+SubscriptionRegistry::snapshot(std::string_view field) const
+{
+	std::vector<std::pair<SubscriptionKey, std::shared_ptr<const SubscriptionData>>> listeners;
+	std::vector<size_t> runs { 0 };
+
+	for (size_t i = 0; i < _shardCount; ++i)
 	{
-		throw schema_exception { std::move(errors) };
+		auto& shard = _shards[i];
+		const std::lock_guard lock { shard.mutex };
+		const auto itrListeners = shard.listeners.find(field);
+
+		if (itrListeners != shard.listeners.end())
+		{
+			listeners.insert(listeners.end(),
+				itrListeners->second.cbegin(),
+				itrListeners->second.cend());
+			runs.push_back(listeners.size());
+		}
 	}
 
-	std::pair<std::string_view, const peg::ast_node*> result = { {}, nullptr };
+	// Deliver to the subscriptions in the order they were registered. Each shard copied a sorted
+	// run, so merge the adjacent runs in pairs until there is only one left.
+	while (runs.size() > 2)
+	{
+		std::vector<size_t> merged { 0 };
 
-	peg::on_first_child_if<peg::operation_definition>(*query.root,
-		[&operationName, &result](const peg::ast_node& operationDefinition) noexcept -> bool {
-			std::string_view operationType = strQuery;
+		merged.reserve((runs.size() / 2) + 1);
 
-			peg::on_first_child<peg::operation_type>(operationDefinition,
-				[&operationType](const peg::ast_node& child) {
-					operationType = child.string_view();
+		for (size_t i = 2; i < runs.size(); i += 2)
+		{
+			std::inplace_merge(listeners.begin() + runs[i - 2],
+				listeners.begin() + runs[i - 1],
+				listeners.begin() + runs[i],
+				[](const auto& lhs, const auto& rhs) noexcept {
+					return lhs.first < rhs.first;
 				});
+			merged.push_back(runs[i]);
+		}
 
-			std::string_view name;
+		if (runs.size() % 2 == 0)
+		{
+			merged.push_back(runs.back());
+		}
 
-			peg::on_first_child<peg::operation_name>(operationDefinition,
-				[&name](const peg::ast_node& child) {
-					name = child.string_view();
-				});
+		runs = std::move(merged);
+	}
 
-			if (operationName.empty() || name == operationName)
-			{
-				result = { operationType, &operationDefinition };
-				return true;
-			}
+	return listeners;
+}
 
-			return false;
-		});
+// SubscriptionDocument holds onto a validated AST for Request::subscribe, along with the fragments
+// if they are the same for every subscription on the document.
+struct SubscriptionDocument : std::enable_shared_from_this<SubscriptionDocument>
+{
+	explicit SubscriptionDocument(std::shared_ptr<const peg::ast> query);
 
-	return result;
-}
+	// Build the FragmentMap for a subscription, or share the one on the document if none of the
+	// fragment definition directives reference variables.
+	[[nodiscard("unnecessary call")]] std::shared_ptr<const FragmentMap> getFragments(
+		const response::Value& variables) const;
 
-response::AwaitableValue Request::resolve(RequestResolveParams params) const
+	const std::shared_ptr<const peg::ast> query;
+
+	// Subscriptions on different copies of the same query text only differ in the ignored tokens,
+	// so Request::deliver compares this instead of the text of each definition.
+	std::string normalizedQuery;
+
+	std::vector<const peg::ast_node*> fragmentDefinitions;
+	std::optional<FragmentMap> fragments;
+};
+
+SubscriptionDocument::SubscriptionDocument(std::shared_ptr<const peg::ast> query)
+	: query(std::move(query))
 {
-	try
+	std::string text;
+
+	for (const auto& definition : this->query->root->children)
 	{
-		FragmentDefinitionVisitor fragmentVisitor(params.variables);
+		text.append(definition->string_view());
+		text.push_back('\n');
+	}
 
-		peg::for_each_child<peg::fragment_definition>(*params.query.root,
-			[&fragmentVisitor](const peg::ast_node& child) {
-				fragmentVisitor.visit(child);
-			});
+	normalizedQuery = DocumentCache::normalize(text);
 
-		auto fragments = fragmentVisitor.getFragments();
-		auto [operationType, operationDefinition] =
-			findOperationDefinition(params.query, params.operationName);
+	bool constantFragments = true;
+
+	peg::for_each_child<peg::fragment_definition>(*this->query->root,
+		[this, &constantFragments](const peg::ast_node& child) {
+			fragmentDefinitions.push_back(&child);
+
+			peg::on_first_child<peg::directives>(child,
+				[&constantFragments](const peg::ast_node& directives) {
+					constantFragments = constantFragments && !referencesVariables(directives);
+				});
+		});
+
+	if (constantFragments)
+	{
+		FragmentDefinitionVisitor fragmentVisitor(noVariables());
+
+		for (const auto fragmentDefinition : fragmentDefinitions)
+		{
+			fragmentVisitor.visit(*fragmentDefinition);
+		}
+
+		fragments = std::make_optional(fragmentVisitor.getFragments());
+	}
+}
+
+std::shared_ptr<const FragmentMap> SubscriptionDocument::getFragments(
+	const response::Value& variables) const
+{
+	if (fragments)
+	{
+		// Alias the shared FragmentMap, which also keeps the document alive.
+		return { shared_from_this(), &*fragments };
+	}
+
+	FragmentDefinitionVisitor fragmentVisitor(variables);
+
+	for (const auto fragmentDefinition : fragmentDefinitions)
+	{
+		fragmentVisitor.visit(*fragmentDefinition);
+	}
+
+	return std::make_shared<const FragmentMap>(fragmentVisitor.getFragments());
+}
+
+// SubscriptionDefinitionVisitor visits the AST collects the fields referenced in the
+// subscription at the point where we create a subscription.
+class SubscriptionDefinitionVisitor
+{
+public:
+	SubscriptionDefinitionVisitor(RequestSubscribeParams&& params,
+		std::shared_ptr<const peg::ast> query, std::string_view normalizedQuery,
+		std::shared_ptr<const FragmentMap> fragments,
+		const std::shared_ptr<const Object>& subscriptionObject);
+
+	const peg::ast_node& getRoot() const;
+	std::shared_ptr<SubscriptionData> getRegistration();
+
+	void visit(const peg::ast_node& operationDefinition);
+
+private:
+	void visitField(const peg::ast_node& field);
+	void visitFragmentSpread(const peg::ast_node& fragmentSpread);
+	void visitInlineFragment(const peg::ast_node& inlineFragment);
+
+	RequestSubscribeParams _params;
+	std::shared_ptr<const peg::ast> _query;
+	std::string_view _normalizedQuery;
+	std::shared_ptr<const FragmentMap> _fragments;
+	const std::shared_ptr<const Object>& _subscriptionObject;
+	SubscriptionName _field;
+	response::Value _arguments;
+	Directives _fieldDirectives;
+	std::shared_ptr<SubscriptionData> _result;
+};
+
+SubscriptionDefinitionVisitor::SubscriptionDefinitionVisitor(RequestSubscribeParams&& params,
+	std::shared_ptr<const peg::ast> query, std::string_view normalizedQuery,
+	std::shared_ptr<const FragmentMap> fragments,
+	const std::shared_ptr<const Object>& subscriptionObject)
+	: _params(std::move(params))
+	, _query(std::move(query))
+	, _normalizedQuery(normalizedQuery)
+	, _fragments(std::move(fragments))
+	, _subscriptionObject(subscriptionObject)
+{
+}
+
+const peg::ast_node& SubscriptionDefinitionVisitor::getRoot() const
+{
+	return *_query->root;
+}
+
+std::shared_ptr<SubscriptionData> SubscriptionDefinitionVisitor::getRegistration()
+{
+	auto result = std::move(_result);
+
+	_result.reset();
+
+	return result;
+}
+
+void SubscriptionDefinitionVisitor::visit(const peg::ast_node& operationDefinition)
+{
+	const auto& selection = *operationDefinition.children.back();
+
+	for (const auto& child : selection.children)
+	{
+		if (child->is_type<peg::field>())
+		{
+			visitField(*child);
+		}
+		else if (child->is_type<peg::fragment_spread>())
+		{
+			visitFragmentSpread(*child);
+		}
+		else if (child->is_type<peg::inline_fragment>())
+		{
+			visitInlineFragment(*child);
+		}
+	}
+
+	Directives directives;
+
+	peg::on_first_child<peg::directives>(operationDefinition,
+		[this, &directives](const peg::ast_node& child) {
+			DirectiveVisitor directiveVisitor(_params.variables);
+
+			directiveVisitor.visit(child);
+			directives = directiveVisitor.getDirectives();
+		});
+
+	_result =
+		std::make_shared<SubscriptionData>(std::make_shared<OperationData>(std::move(_params.state),
+											   std::move(_params.variables),
+											   std::move(directives),
+											   std::move(_fragments)),
+			std::move(_field),
+			std::move(_arguments),
+			std::move(_fieldDirectives),
+			std::move(_query),
+			_normalizedQuery,
+			std::move(_params.operationName),
+			std::move(_params.callback),
+			selection);
+}
+
+void SubscriptionDefinitionVisitor::visitField(const peg::ast_node& field)
+{
+	std::string_view name;
+
+	peg::on_first_child<peg::field_name>(field, [&name](const peg::ast_node& child) {
+		name = child.string_view();
+	});
+
+	// https://spec.graphql.org/October2021/#sec-Single-root-field
+	if (!_field.empty())
+	{
+		auto position = field.begin();
+		std::ostringstream error;
+
+		error << "Extra subscription root field name: " << name;
+
+		throw schema_exception {
+			{ schema_error { error.str(), { position.line, position.column } } }
+		};
+	}
+
+	DirectiveVisitor directiveVisitor(_params.variables);
+
+	peg::on_first_child<peg::directives>(field, [&directiveVisitor](const peg::ast_node& child) {
+		directiveVisitor.visit(child);
+	});
+
+	if (directiveVisitor.shouldSkip())
+	{
+		return;
+	}
+
+	_fieldDirectives = directiveVisitor.getDirectives();
+
+	response::Value arguments(response::Type::Map);
+
+	peg::on_first_child<peg::arguments>(field, [this, &arguments](const peg::ast_node& child) {
+		ValueVisitor visitor(_params.variables);
+
+		for (auto& argument : child.children)
+		{
+			visitor.visit(*argument->children.back());
+
+			arguments.emplace_back(argument->children.front()->string(), visitor.getValue());
+		}
+	});
+
+	_field = std::move(name);
+	_arguments = std::move(arguments);
+}
+
+void SubscriptionDefinitionVisitor::visitFragmentSpread(const peg::ast_node& fragmentSpread)
+{
+	const auto name = fragmentSpread.children.front()->string_view();
+	auto itr = _fragments->find(name);
+
+	if (itr == _fragments->end())
+	{
+		auto position = fragmentSpread.begin();
+		std::ostringstream error;
+
+		error << "Unknown fragment name: " << name;
+
+		throw schema_exception {
+			{ schema_error { error.str(), { position.line, position.column } } }
+		};
+	}
+
+	bool skip = !_subscriptionObject->matchesType(itr->second.getType());
+	DirectiveVisitor directiveVisitor(_params.variables);
+
+	if (!skip)
+	{
+		peg::on_first_child<peg::directives>(fragmentSpread,
+			[&directiveVisitor](const peg::ast_node& child) {
+				directiveVisitor.visit(child);
+			});
+
+		skip = directiveVisitor.shouldSkip();
+	}
+
+	if (skip)
+	{
+		return;
+	}
+
+	for (const auto& selection : itr->second.getSelection().children)
+	{
+		visit(*selection);
+	}
+}
+
+void SubscriptionDefinitionVisitor::visitInlineFragment(const peg::ast_node& inlineFragment)
+{
+	DirectiveVisitor directiveVisitor(_params.variables);
+
+	peg::on_first_child<peg::directives>(inlineFragment,
+		[&directiveVisitor](const peg::ast_node& child) {
+			directiveVisitor.visit(child);
+		});
+
+	if (directiveVisitor.shouldSkip())
+	{
+		return;
+	}
+
+	const peg::ast_node* typeCondition = nullptr;
+
+	peg::on_first_child<peg::type_condition>(inlineFragment,
+		[&typeCondition](const peg::ast_node& child) {
+			typeCondition = &child;
+		});
+
+	if (typeCondition == nullptr
+		|| _subscriptionObject->matchesType(typeCondition->children.front()->string()))
+	{
+		peg::on_first_child<peg::selection_set>(inlineFragment, [this](const peg::ast_node& child) {
+			for (const auto& selection : child.children)
+			{
+				visit(*selection);
+			}
+		});
+	}
+}
+
+struct DocumentCache::Shard
+{
+	struct Entry
+	{
+		std::string query;
+		// Hash of the original text, which is enough to tell if a query matches it without
+		// keeping a second copy of the text.
+		size_t textHash;
+		std::shared_ptr<const peg::ast> document;
+	};
+
+	using entry_list = std::list<Entry>;
+
+	// Evict the least recently used entries until the shard fits in its capacity, and return the
+	// number of entries which were evicted. The caller must hold the mutex.
+	size_t trim() noexcept
+	{
+		size_t evicted = 0;
+
+		while (entries.size() > capacity)
+		{
+			index.erase(entries.back().query);
+			entries.pop_back();
+			++evicted;
+		}
+
+		return evicted;
+	}
+
+	std::mutex mutex;
+	size_t capacity = 0;
+	entry_list entries;
+	std::unordered_map<std::string_view, entry_list::iterator> index;
+};
+
+DocumentCache::DocumentCache(size_t capacity, size_t shardCount)
+	: _shardCount { std::max(shardCount, size_t { 1 }) }
+	, _shards { std::make_unique<Shard[]>(_shardCount) }
+{
+	setCapacity(capacity);
+}
+
+DocumentCache::~DocumentCache()
+{
+	// The default implementation is fine, but it needs the definition of DocumentCache::Shard.
+}
+
+DocumentCache::Shard& DocumentCache::getShard(size_t hash) const noexcept
+{
+	// Mix the bits before picking a shard, so the entries in each shard still spread out across
+	// the buckets of its std::unordered_map, even with a power of 2 bucket count.
+	const auto mixed = static_cast<std::uint64_t>(hash) * std::uint64_t { 0x9E3779B97F4A7C15 };
+
+	return _shards[static_cast<size_t>(mixed >> 32) % _shardCount];
+}
+
+std::shared_ptr<const peg::ast> DocumentCache::find(std::string_view query, bool* sameText)
+{
+	const auto key = normalize(query);
+	const auto textHash = sameText ? std::hash<std::string_view> {}(query) : size_t { 0 };
+	auto& shard = getShard(std::hash<std::string_view> {}(key));
+	std::lock_guard lock { shard.mutex };
+	const auto itr = shard.index.find(key);
+
+	if (itr == shard.index.end())
+	{
+		_misses.fetch_add(1, std::memory_order_relaxed);
+		return {};
+	}
+
+	// Move the entry to the front of the LRU list.
+	shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+	_hits.fetch_add(1, std::memory_order_relaxed);
+
+	if (sameText)
+	{
+		*sameText = (itr->second->textHash == textHash);
+	}
+
+	return itr->second->document;
+}
+
+std::shared_ptr<const peg::ast> DocumentCache::insert(
+	std::string_view query, std::shared_ptr<const peg::ast> document)
+{
+	auto key = normalize(query);
+	const auto textHash = std::hash<std::string_view> {}(query);
+	auto& shard = getShard(std::hash<std::string_view> {}(key));
+	std::lock_guard lock { shard.mutex };
+	const auto itr = shard.index.find(key);
+
+	if (itr != shard.index.end())
+	{
+		shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+
+		return itr->second->document;
+	}
+
+	shard.entries.push_front({ std::move(key), textHash, std::move(document) });
+	shard.index.emplace(shard.entries.front().query, shard.entries.begin());
+
+	auto result = shard.entries.front().document;
+	const auto evicted = shard.trim();
+
+	_size.fetch_add(1, std::memory_order_relaxed);
+
+	if (evicted > 0)
+	{
+		_size.fetch_sub(evicted, std::memory_order_relaxed);
+		_evictions.fetch_add(evicted, std::memory_order_relaxed);
+	}
+
+	return result;
+}
+
+void DocumentCache::setCapacity(size_t capacity)
+{
+	const auto shardCapacity = (capacity + _shardCount - 1) / _shardCount;
+
+	for (size_t i = 0; i < _shardCount; ++i)
+	{
+		auto& shard = _shards[i];
+		std::lock_guard lock { shard.mutex };
+
+		shard.capacity = shardCapacity;
+
+		if (const auto evicted = shard.trim(); evicted > 0)
+		{
+			_size.fetch_sub(evicted, std::memory_order_relaxed);
+			_evictions.fetch_add(evicted, std::memory_order_relaxed);
+		}
+	}
+}
+
+void DocumentCache::clear() noexcept
+{
+	for (size_t i = 0; i < _shardCount; ++i)
+	{
+		auto& shard = _shards[i];
+		std::lock_guard lock { shard.mutex };
+
+		_size.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+		shard.index.clear();
+		shard.entries.clear();
+	}
+}
+
+DocumentCache::Statistics DocumentCache::getStatistics() const noexcept
+{
+	return {
+		_hits.load(std::memory_order_relaxed),
+		_misses.load(std::memory_order_relaxed),
+		_evictions.load(std::memory_order_relaxed),
+		_size.load(std::memory_order_relaxed),
+	};
+}
+
+std::string DocumentCache::normalize(std::string_view query)
+{
+	using namespace std::literals;
+
+	// Only keep a space between characters which might otherwise merge into a different token.
+	constexpr auto needsSeparator = [](char ch) noexcept {
+		return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9')
+			|| ch == '_' || ch == '"' || ch == '.' || ch == '-' || ch == '+';
+	};
+
+	std::string result;
+	bool ignored = false;
+
+	result.reserve(query.size());
+
+	for (size_t i = 0; i < query.size();)
+	{
+		switch (query[i])
+		{
+			// https://spec.graphql.org/October2021/#sec-Language.Source-Text.Ignored-Tokens
+			case ' ':
+			case '\t':
+			case '\r':
+			case '\n':
+			case ',':
+				ignored = true;
+				++i;
+				continue;
+
+			case '#':
+				while (i < query.size() && query[i] != '\r' && query[i] != '\n')
+				{
+					++i;
+				}
+
+				ignored = true;
+				continue;
+
+			default:
+				break;
+		}
+
+		if (query.substr(i, 3) == "\xEF\xBB\xBF"sv)
+		{
+			// Unicode BOM
+			ignored = true;
+			i += 3;
+			continue;
+		}
+
+		if (ignored && !result.empty() && needsSeparator(result.back())
+			&& needsSeparator(query[i]))
+		{
+			result.push_back(' ');
+		}
+
+		ignored = false;
+
+		if (query[i] != '"')
+		{
+			result.push_back(query[i++]);
+			continue;
+		}
+
+		// Copy string values verbatim, including any whitespace, commas, or # characters.
+		auto end = i + 1;
+
+		if (query.substr(i, 3) == R"(""")"sv)
+		{
+			end = i + 3;
+
+			while (end < query.size())
+			{
+				if (query.substr(end, 4) == R"(\""")"sv)
+				{
+					end += 4;
+				}
+				else if (query.substr(end, 3) == R"(""")"sv)
+				{
+					end += 3;
+					break;
+				}
+				else
+				{
+					++end;
+				}
+			}
+		}
+		else
+		{
+			while (end < query.size() && query[end] != '"' && query[end] != '\r'
+				&& query[end] != '\n')
+			{
+				end += (query[end] == '\\') ? 2 : 1;
+			}
+
+			end = std::min(end + 1, query.size());
+		}
+
+		result.append(query.substr(i, end - i));
+		i = end;
+	}
+
+	return result;
+}
+
+Request::Request(TypeMap operationTypes, std::shared_ptr<schema::Schema> schema)
+	: _operations(std::move(operationTypes))
+	, _validation(std::make_shared<const ValidateSchema>(std::move(schema)))
+{
+}
+
+Request::~Request()
+{
+	// The default implementation is fine, but it's defined here next to the constructor so the
+	// _validation member is only ever created and destroyed where ValidateSchema is complete.
+}
+
+std::list<schema_error> Request::validate(peg::ast& query) const
+{
+	std::list<schema_error> errors;
+
+	if (!query.validated)
+	{
+		// The schema information in _validation is immutable, and each visitor has its own state
+		// for the query, so validations on different threads do not need to wait for each other.
+		ValidateExecutableVisitor validation { _validation, getCostLimit() };
+
+		validation.visit(*query.root);
+		errors = validation.getStructuredErrors();
+		query.validated = errors.empty();
+	}
+
+	return errors;
+}
+
+std::pair<std::string_view, const peg::ast_node*> Request::findOperationDefinition(
+	peg::ast& query, std::string_view operationName) const
+{
+	// Ensure the query has been validated.
+	auto errors = validate(query);
+
+	if (!errors.empty())
+	{
+		throw schema_exception { std::move(errors) };
+	}
+
+	return findValidatedOperationDefinition(query, operationName);
+}
+
+std::pair<std::string_view, const peg::ast_node*> Request::findValidatedOperationDefinition(
+	const peg::ast& query, std::string_view operationName)
+{
+	std::pair<std::string_view, const peg::ast_node*> result = { {}, nullptr };
+
+	peg::on_first_child_if<peg::operation_definition>(*query.root,
+		[&operationName, &result](const peg::ast_node& operationDefinition) noexcept -> bool {
+			std::string_view operationType = strQuery;
+
+			peg::on_first_child<peg::operation_type>(operationDefinition,
+				[&operationType](const peg::ast_node& child) {
+					operationType = child.string_view();
+				});
+
+			std::string_view name;
+
+			peg::on_first_child<peg::operation_name>(operationDefinition,
+				[&name](const peg::ast_node& child) {
+					name = child.string_view();
+				});
+
+			if (operationName.empty() || name == operationName)
+			{
+				result = { operationType, &operationDefinition };
+				return true;
+			}
+
+			return false;
+		});
+
+	return result;
+}
+
+namespace {
+
+void requireQueryOrMutation(std::string_view operationType,
+	const peg::ast_node* operationDefinition, std::string_view operationName)
+{
+	if (!operationDefinition)
+	{
+		std::ostringstream message;
+
+		message << "Missing operation";
+
+		if (!operationName.empty())
+		{
+			message << " name: " << operationName;
+		}
+
+		throw schema_exception { { message.str() } };
+	}
+	else if (operationType == strSubscription)
+	{
+		auto position = operationDefinition->begin();
+		std::ostringstream message;
+
+		message << "Unexpected subscription";
+
+		if (!operationName.empty())
+		{
+			message << " name: " << operationName;
+		}
+
+		throw schema_exception {
+			{ schema_error { message.str(), { position.line, position.column } } }
+		};
+	}
+}
+
+} // namespace
+
+std::shared_ptr<const PreparedOperation> Request::prepare(
+	peg::ast query, std::string_view operationName) const
+{
+	auto [operationType, operationDefinition] = findOperationDefinition(query, operationName);
+
+	requireQueryOrMutation(operationType, operationDefinition, operationName);
+
+	auto operation = std::make_shared<PreparedOperation>();
+
+	operation->query = std::move(query);
+	operation->operationType = operationType;
+
+	PreparedOperationVisitor operationVisitor(*operation);
+
+	operationVisitor.visit(*operationDefinition);
+
+	return operation;
+}
+
+response::AwaitableValue Request::resolve(RequestResolveParams params) const
+{
+	auto errors = validate(params.query);
+
+	if (!errors.empty())
+	{
+		response::Value document(response::Type::Map);
+
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, buildErrorValues(std::move(errors)));
+
+		co_return std::move(document);
+	}
+
+	co_return co_await resolveValidated(params.query,
+		params.operationName,
+		std::move(params.variables),
+		std::move(params.launch),
+		std::move(params.state),
+		params.resource);
+}
+
+AwaitableStream Request::resolve(RequestResolveParams params, response::Writer writer) const
+{
+	auto errors = validate(params.query);
+
+	if (!errors.empty())
+	{
+		response::Value document(response::Type::Map);
+
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, buildErrorValues(std::move(errors)));
+		writer.write(std::move(document));
+		co_return;
+	}
+
+	// The response is written to the writer, so the value returned from resolveValidated is empty.
+	[[maybe_unused]] auto document = co_await resolveValidated(params.query,
+		params.operationName,
+		std::move(params.variables),
+		std::move(params.launch),
+		std::move(params.state),
+		params.resource,
+		&writer);
+}
+
+AwaitableStream Request::resolveIncremental(
+	RequestResolveParams params, IncrementalCallback callback) const
+{
+	auto errors = validate(params.query);
+
+	if (!errors.empty())
+	{
+		response::Value payload(response::Type::Map);
+
+		payload.emplace_back(std::string { strData }, response::Value());
+		payload.emplace_back(std::string { strErrors }, buildErrorValues(std::move(errors)));
+		payload.emplace_back(std::string { strHasNext }, response::Value(false));
+		callback(std::move(payload));
+		co_return;
+	}
+
+	// Every payload is delivered to the callback, so the value returned from resolveValidated is
+	// empty.
+	[[maybe_unused]] auto document = co_await resolveValidated(params.query,
+		params.operationName,
+		std::move(params.variables),
+		std::move(params.launch),
+		std::move(params.state),
+		params.resource,
+		nullptr,
+		&callback);
+}
+
+response::AwaitableValue Request::resolve(RequestQueryParams params) const
+{
+	std::shared_ptr<const peg::ast> query;
+
+	try
+	{
+		query = loadDocument(params.query);
+	}
+	catch (schema_exception& ex)
+	{
+		response::Value document(response::Type::Map);
+
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, ex.getErrors());
+
+		co_return std::move(document);
+	}
+
+	co_return co_await resolveValidated(*query,
+		params.operationName,
+		std::move(params.variables),
+		std::move(params.launch),
+		std::move(params.state),
+		params.resource);
+}
+
+DocumentCache& Request::getDocumentCache() const noexcept
+{
+	return _documents;
+}
+
+void Request::setCostLimit(RequestCostLimit costLimit) noexcept
+{
+	_maxCost.store(costLimit.maxCost, std::memory_order_relaxed);
+	_variableMultiplier.store(costLimit.variableMultiplier, std::memory_order_relaxed);
+
+	// The cached documents were validated with the previous limit.
+	_documents.clear();
+	_persistedDocuments.clear();
+}
+
+RequestCostLimit Request::getCostLimit() const noexcept
+{
+	return {
+		_maxCost.load(std::memory_order_relaxed),
+		_variableMultiplier.load(std::memory_order_relaxed),
+	};
+}
+
+std::shared_ptr<const peg::ast> Request::loadDocument(std::string_view query) const
+{
+	bool sameText = false;
+	auto document = _documents.find(query, &sameText);
+
+	if (document)
+	{
+		// A query which only differs in the ignored tokens is just as valid, but parse it again so
+		// the error locations refer to this text instead of the cached one.
+		return sameText ? document : parseDocument(query, true);
+	}
+
+	document = parseDocument(query);
+
+	// If another thread inserted an equivalent query first, keep the locations from this one.
+	_documents.insert(query, document);
+
+	return document;
+}
+
+std::shared_ptr<const peg::ast> Request::parseDocument(
+	std::string_view query, bool validated) const
+{
+	peg::ast ast;
+
+	try
+	{
+		ast = peg::parseString(query);
+	}
+	catch (const peg::parse_error& pe)
+	{
+		const auto& positions = pe.positions();
+		schema_location location;
+
+		if (!positions.empty())
+		{
+			location = { positions.front().line, positions.front().column };
+		}
+
+		throw schema_exception { { schema_error { pe.what(), std::move(location) } } };
+	}
+
+	if (validated)
+	{
+		ast.validated = true;
+	}
+	else if (auto errors = validate(ast); !errors.empty())
+	{
+		throw schema_exception { std::move(errors) };
+	}
+
+	return std::make_shared<const peg::ast>(std::move(ast));
+}
+
+response::AwaitableValue Request::resolvePersisted(RequestPersistedParams params) const
+{
+	std::shared_ptr<const peg::ast> query;
+
+	try
+	{
+		query = loadPersistedQuery(params.hash, params.query);
+	}
+	catch (schema_exception& ex)
+	{
+		response::Value document(response::Type::Map);
+
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, ex.getErrors());
+
+		co_return std::move(document);
+	}
+
+	co_return co_await resolveValidated(*query,
+		params.operationName,
+		std::move(params.variables),
+		std::move(params.launch),
+		std::move(params.state),
+		params.resource);
+}
+
+std::string Request::registerPersistedQuery(std::string_view query)
+{
+	auto document = parseDocument(query);
+	auto hash = internal::Sha256::hashHex(query);
+	std::unique_lock lock { _persistedMutex };
+
+	_persistedQueries.insert_or_assign(hash, std::move(document));
+
+	return hash;
+}
+
+size_t Request::registerPersistedQueries(const std::filesystem::path& directory)
+{
+	using namespace std::literals;
+
+	size_t count = 0;
+
+	for (const auto& entry : std::filesystem::directory_iterator { directory })
+	{
+		if (!entry.is_regular_file() || entry.path().extension() != ".graphql")
+		{
+			continue;
+		}
+
+		std::ifstream file { entry.path(), std::ios::in | std::ios::binary };
+
+		if (!file)
+		{
+			throw std::runtime_error { "Unable to read persisted query: "s
+				+ entry.path().string() };
+		}
+
+		std::ostringstream oss;
+
+		oss << file.rdbuf();
+		static_cast<void>(registerPersistedQuery(oss.str()));
+		++count;
+	}
+
+	return count;
+}
+
+std::shared_ptr<const peg::ast> Request::findPersistedQuery(std::string_view hash) const
+{
+	std::string key { hash };
+
+	// Hex digits are case insensitive, but we always register the lowercase form.
+	std::transform(key.begin(), key.end(), key.begin(), [](char ch) noexcept {
+		return static_cast<char>((ch >= 'A' && ch <= 'F') ? ch - 'A' + 'a' : ch);
+	});
+
+	{
+		std::shared_lock lock { _persistedMutex };
+		const auto itr = _persistedQueries.find(key);
+
+		if (itr != _persistedQueries.end())
+		{
+			return itr->second;
+		}
+	}
+
+	return _persistedDocuments.find(key);
+}
+
+DocumentCache& Request::getPersistedQueryCache() const noexcept
+{
+	return _persistedDocuments;
+}
+
+std::shared_ptr<const peg::ast> Request::loadPersistedQuery(
+	std::string_view hash, std::string_view query) const
+{
+	auto document = findPersistedQuery(hash);
+
+	if (document)
+	{
+		return document;
+	}
+
+	// Automatic persisted queries expect this exact message when the client needs to send the
+	// query text with the hash: https://www.apollographql.com/docs/apollo-server/performance/apq/
+	if (query.empty())
+	{
+		throw schema_exception { { "PersistedQueryNotFound" } };
+	}
+
+	auto key = internal::Sha256::hashHex(query);
+
+	if (key.size() != hash.size()
+		|| !std::equal(key.cbegin(), key.cend(), hash.cbegin(), [](char lhs, char rhs) noexcept {
+			   return lhs == ((rhs >= 'A' && rhs <= 'F') ? rhs - 'A' + 'a' : rhs);
+		   }))
+	{
+		throw schema_exception { { "provided sha does not match query" } };
+	}
+
+	return _persistedDocuments.insert(key, loadDocument(query));
+}
+
+// Drop any incremental payloads which were not delivered when resolveValidated returns or throws,
+// since they may refer back to the queue which owns them.
+struct ClearIncrementalPayloads
+{
+	~ClearIncrementalPayloads()
+	{
+		if (payloads)
+		{
+			payloads->clear();
+		}
+	}
+
+	IncrementalPayloads* payloads;
+};
+
+// Start every queued @defer and @stream payload at the same time, and deliver each of them to the
+// callback as soon as it completes. The callback is only called by one payload at a time, and
+// the last payload which is delivered is the only one with hasNext: false.
+class IncrementalDelivery : public std::enable_shared_from_this<IncrementalDelivery>
+{
+public:
+	explicit IncrementalDelivery(await_async launch, const IncrementalCallback& callback)
+		: _launch { std::move(launch) }
+		, _callback { callback }
+	{
+	}
+
+	// Start all of the payloads which are waiting in the queue.
+	void start(IncrementalPayloads& queue)
+	{
+		std::list<IncrementalPayloads::Payload> payloads;
+
+		while (auto next = queue.pop())
+		{
+			payloads.push_back(std::move(*next));
+		}
+
+		{
+			std::lock_guard lock { _mutex };
+
+			_pending += payloads.size();
+		}
+
+		launch(std::move(payloads));
+	}
+
+	// Resume the awaiting coroutine after the last payload has been delivered.
+	struct [[nodiscard("unnecessary construction")]] all_delivered
+	{
+		[[nodiscard("unexpected call")]] bool await_ready() const
+		{
+			std::lock_guard lock { delivery._mutex };
+
+			return delivery._pending == 0;
+		}
+
+		[[nodiscard("unexpected call")]] bool await_suspend(coro::coroutine_handle<> h) const
+		{
+			std::lock_guard lock { delivery._mutex };
+
+			if (delivery._pending == 0)
+			{
+				return false;
+			}
+
+			delivery._waiting = h;
+			return true;
+		}
+
+		constexpr void await_resume() const noexcept
+		{
+		}
+
+		IncrementalDelivery& delivery;
+	};
+
+	all_delivered wait() noexcept
+	{
+		return { *this };
+	}
+
+private:
+	void launch(std::list<IncrementalPayloads::Payload>&& payloads)
+	{
+		for (auto& payload : payloads)
+		{
+			// Nobody awaits the delivery, so the coroutine frame is destroyed when it finishes.
+			static_cast<void>(deliver(shared_from_this(), std::move(payload)));
+		}
+	}
+
+	// Rebuild the field_path chain for the SelectionSetParams from the owned path. Each entry
+	// refers to the one in front of it, so the vector must not be resized after it is built.
+	static std::vector<field_path> buildFieldPath(const error_path& path)
+	{
+		std::vector<field_path> result;
+
+		result.reserve(path.size());
+
+		for (const auto& segment : path)
+		{
+			std::optional<std::reference_wrapper<const field_path>> parent;
+
+			if (!result.empty())
+			{
+				parent = std::cref(result.back());
+			}
+
+			result.push_back({ std::move(parent), segment });
+		}
+
+		return result;
+	}
+
+	static internal::Awaitable<void> deliver(
+		std::shared_ptr<IncrementalDelivery> self, IncrementalPayloads::Payload payload)
+	{
+		coro::coroutine_handle<> waiting;
+
+		{
+			const auto path = buildFieldPath(payload.path);
+			std::optional<field_path> errorPath;
+			ResolverResult payloadResult;
+			const auto nested = std::make_shared<IncrementalPayloads>();
+
+			if (!path.empty())
+			{
+				errorPath = path.back();
+			}
+
+			try
+			{
+				co_await self->_launch;
+
+				payloadResult = co_await payload.start(std::move(errorPath), nested);
+			}
+			catch (schema_exception& scx)
+			{
+				payloadResult.errors = scx.getStructuredErrors();
+			}
+			catch (const std::exception& ex)
+			{
+				std::ostringstream message;
+
+				message << "Incremental payload unknown error: " << ex.what();
+
+				payloadResult.errors.push_back({ message.str(), {}, payload.path });
+			}
+
+			response::Value patch { response::Type::Map };
+
+			if (payload.items)
+			{
+				response::Value items { response::Type::List };
+
+				items.emplace_back(std::move(payloadResult.data));
+				patch.emplace_back(std::string { strItems }, std::move(items));
+			}
+			else
+			{
+				patch.emplace_back(std::string { strData }, std::move(payloadResult.data));
+			}
+
+			if (payload.path.empty())
+			{
+				patch.emplace_back(std::string { strPath },
+					response::Value { response::Type::List });
+			}
+			else
+			{
+				addErrorPath(payload.path, patch);
+			}
+
+			if (payload.label)
+			{
+				patch.emplace_back(std::string { strLabel },
+					response::Value { std::move(*payload.label) });
+			}
+
+			if (!payloadResult.errors.empty())
+			{
+				patch.emplace_back(std::string { strErrors },
+					buildErrorValues(std::move(payloadResult.errors)));
+			}
+
+			// The nested payloads are counted before this one is delivered, but they are not
+			// started until afterwards.
+			std::list<IncrementalPayloads::Payload> payloads;
+
+			while (auto next = nested->pop())
+			{
+				payloads.push_back(std::move(*next));
+			}
+
+			{
+				std::lock_guard lock { self->_mutex };
+
+				self->_pending += payloads.size();
+				--self->_pending;
+
+				patch.emplace_back(std::string { strHasNext },
+					response::Value(self->_pending > 0));
+				self->_callback(std::move(patch));
+
+				if (self->_pending == 0)
+				{
+					waiting = std::exchange(self->_waiting, {});
+				}
+			}
+
+			self->launch(std::move(payloads));
+		}
+
+		// The awaiting coroutine may release everything the payloads refer to as soon as it
+		// resumes, so this must be the last thing the delivery does.
+		if (waiting)
+		{
+			waiting.resume();
+		}
+	}
+
+	const await_async _launch;
+	const IncrementalCallback& _callback;
+
+	std::mutex _mutex;
+	size_t _pending = 0;
+	coro::coroutine_handle<> _waiting;
+};
+
+response::AwaitableValue Request::resolveValidated(const peg::ast& query,
+	std::string_view operationName, response::Value variables, await_async launch,
+	std::shared_ptr<RequestState> state, std::pmr::memory_resource* resource,
+	const response::Writer* writer, const IncrementalCallback* callback) const
+{
+	// The data is written through a ValueWriter, which keeps track of the maps and lists that are
+	// still open if the operation fails part way through.
+	ValueWriter dataWriter;
+	bool startedData = false;
+	const auto incremental = callback ? std::make_shared<IncrementalPayloads>() : nullptr;
+	const ClearIncrementalPayloads clearPayloads { incremental.get() };
+
+	try
+	{
+		FragmentDefinitionVisitor fragmentVisitor(variables);
+
+		peg::for_each_child<peg::fragment_definition>(*query.root,
+			[&fragmentVisitor](const peg::ast_node& child) {
+				fragmentVisitor.visit(child);
+			});
+
+		auto fragments = fragmentVisitor.getFragments();
+		auto [operationType, operationDefinition] =
+			findValidatedOperationDefinition(query, operationName);
+
+		requireQueryOrMutation(operationType, operationDefinition, operationName);
+
+		const bool isMutation = (operationType == strMutation);
+		const auto resolverContext =
+			isMutation ? ResolverContext::Mutation : ResolverContext::Query;
+		// https://spec.graphql.org/October2021/#sec-Normal-and-Serial-Execution
+		auto operationLaunch = isMutation ? await_async {} : launch;
+
+		OperationDefinitionVisitor operationVisitor(resolverContext,
+			std::move(operationLaunch),
+			std::move(state),
+			_operations,
+			std::move(variables),
+			std::move(fragments),
+			resource,
+			writer ? &dataWriter : nullptr,
+			incremental);
+
+		co_await launch;
+
+		if (writer)
+		{
+			// The top-level Object starts writing the data as soon as we visit the operation.
+			writer->start_object();
+			writer->add_member(strData);
+			dataWriter.attach(*writer);
+			startedData = true;
+		}
+
+		operationVisitor.visit(operationType, *operationDefinition);
+
+		auto result = co_await operationVisitor.getValue();
+
+		if (writer)
+		{
+			dataWriter.finish(std::move(result.data));
+
+			if (!result.errors.empty())
+			{
+				writer->add_member(strErrors);
+				writer->write(buildErrorValues(std::move(result.errors)));
+			}
+
+			writer->end_object();
+			co_return response::Value {};
+		}
+
+		if (callback)
+		{
+			response::Value payload { response::Type::Map };
+
+			payload.emplace_back(std::string { strData }, std::move(result.data));
+
+			if (!result.errors.empty())
+			{
+				payload.emplace_back(std::string { strErrors },
+					buildErrorValues(std::move(result.errors)));
+			}
+
+			payload.emplace_back(std::string { strHasNext },
+				response::Value(!incremental->empty()));
+			(*callback)(std::move(payload));
+
+			// The operationVisitor owns the variables and fragments which the deferred payloads
+			// refer to, so they need to be delivered before returning.
+			const auto delivery = std::make_shared<IncrementalDelivery>(launch, *callback);
+
+			delivery->start(*incremental);
+			co_await delivery->wait();
+
+			co_return response::Value {};
+		}
+
+		response::Value document { response::Type::Map, resource };
+
+		document.emplace_back(std::string { strData }, std::move(result.data));
+
+		if (!result.errors.empty())
+		{
+			document.emplace_back(std::string { strErrors },
+				buildErrorValues(std::move(result.errors)));
+		}
+
+		co_return std::move(document);
+	}
+	catch (schema_exception& ex)
+	{
+		if (callback)
+		{
+			response::Value payload(response::Type::Map);
+
+			payload.emplace_back(std::string { strData }, response::Value());
+			payload.emplace_back(std::string { strErrors }, ex.getErrors());
+			payload.emplace_back(std::string { strHasNext }, response::Value(false));
+			(*callback)(std::move(payload));
+			co_return response::Value {};
+		}
+
+		if (writer)
+		{
+			if (!startedData)
+			{
+				writer->start_object();
+				writer->add_member(strData);
+				dataWriter.attach(*writer);
+			}
+
+			// Either write a null data value, or close the maps and lists which are still open.
+			dataWriter.finish({});
+			writer->add_member(strErrors);
+			writer->write(ex.getErrors());
+			writer->end_object();
+			co_return response::Value {};
+		}
+
+		response::Value document(response::Type::Map);
+
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, ex.getErrors());
+
+		co_return std::move(document);
+	}
+}
 
-		if (!operationDefinition)
+response::AwaitableValue Request::resolve(RequestPreparedParams params) const
+{
+	try
+	{
+		if (!params.operation)
 		{
-			std::ostringstream message;
+			throw schema_exception { { "Missing operation" } };
+		}
+
+		const auto& operation = *params.operation;
+		std::optional<FragmentMap> requestFragments;
 
-			message << "Missing operation";
+		if (!operation.fragments)
+		{
+			FragmentDefinitionVisitor fragmentVisitor(params.variables);
 
-			if (!params.operationName.empty())
+			for (const auto fragmentDefinition : operation.fragmentDefinitions)
 			{
-				message << " name: " << params.operationName;
+				fragmentVisitor.visit(*fragmentDefinition);
 			}
 
-			throw schema_exception { { message.str() } };
+			requestFragments = std::make_optional(fragmentVisitor.getFragments());
 		}
-		else if (operationType == strSubscription)
-		{
-			auto position = operationDefinition->begin();
-			std::ostringstream message;
 
-			message << "Unexpected subscription";
+		const auto& fragments = operation.fragments ? *operation.fragments : *requestFragments;
 
-			if (!params.operationName.empty())
-			{
-				message << " name: " << params.operationName;
-			}
+		// Filter the variable definitions down to the ones referenced in this operation
+		response::Value variables(response::Type::Map);
 
-			throw schema_exception {
-				{ schema_error { message.str(), { position.line, position.column } } }
-			};
+		variables.reserve(operation.variables.size());
+
+		for (const auto& [variableName, defaultValue] : operation.variables)
+		{
+			auto itrVar = params.variables.find(variableName);
+
+			variables.emplace_back(std::string { variableName },
+				response::Value(itrVar != params.variables.get<response::MapType>().cend()
+						? itrVar->second
+						: defaultValue));
 		}
 
-		const bool isMutation = (operationType == strMutation);
+		const auto directives = operation.directives.getDirectives(variables);
+		const bool isMutation = (operation.operationType == strMutation);
 		const auto resolverContext =
 			isMutation ? ResolverContext::Mutation : ResolverContext::Query;
 		// https://spec.graphql.org/October2021/#sec-Normal-and-Serial-Execution
-		auto operationLaunch = isMutation ? await_async {} : params.launch;
-
-		OperationDefinitionVisitor operationVisitor(resolverContext,
-			std::move(operationLaunch),
-			std::move(params.state),
-			_operations,
-			std::move(params.variables),
-			std::move(fragments));
+		const auto operationLaunch = isMutation ? await_async {} : params.launch;
 
 		co_await params.launch;
-		operationVisitor.visit(operationType, *operationDefinition);
 
-		auto result = co_await operationVisitor.getValue();
-		response::Value document { response::Type::Map };
+		const SelectionSetParams selectionSetParams {
+			resolverContext,
+			params.state,
+			directives,
+			std::make_shared<FragmentDefinitionDirectiveStack>(),
+			std::make_shared<FragmentSpreadDirectiveStack>(),
+			std::make_shared<FragmentSpreadDirectiveStack>(),
+			std::nullopt,
+			operationLaunch,
+			{},
+			params.resource,
+		};
+		auto value = _operations.find(operation.operationType)
+						 ->second->resolve(selectionSetParams,
+							 *operation.selection,
+							 fragments,
+							 variables);
+
+		co_await operationLaunch;
+
+		auto result = co_await value;
+		response::Value document { response::Type::Map, params.resource };
 
 		document.emplace_back(std::string { strData }, std::move(result.data));
 
@@ -1870,7 +4806,6 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 {
 	const auto spThis = shared_from_this();
 	const auto launch = std::move(params.launch);
-	std::unique_lock lock { spThis->_subscriptionMutex };
 	const auto itrOperation = spThis->_operations.find(strSubscription);
 
 	if (itrOperation == _operations.end())
@@ -1882,11 +4817,10 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 
 	const auto optionalOrDefaultSubscription =
 		params.subscriptionObject ? std::move(params.subscriptionObject) : itrOperation->second;
-	const auto key = spThis->addSubscription(std::move(params));
+	const auto [key, registration] = spThis->addSubscription(std::move(params));
 
 	if (optionalOrDefaultSubscription)
 	{
-		const auto registration = spThis->_subscriptions.at(key);
 		const SelectionSetParams selectionSetParams {
 			ResolverContext::NotifySubscribe,
 			registration->data->state,
@@ -1898,8 +4832,6 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 			launch,
 		};
 
-		lock.unlock();
-
 		try
 		{
 			co_await launch;
@@ -1907,7 +4839,7 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 			auto errors =
 				std::move((co_await optionalOrDefaultSubscription->resolve(selectionSetParams,
 							   registration->selection,
-							   registration->data->fragments,
+							   *registration->data->fragments,
 							   registration->data->variables))
 							  .errors);
 
@@ -1918,8 +4850,6 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 		}
 		catch (...)
 		{
-			lock.lock();
-
 			// Rethrow the exception, but don't leave it subscribed if the resolver failed.
 			spThis->removeSubscription(key);
 			throw;
@@ -1932,7 +4862,6 @@ AwaitableSubscribe Request::subscribe(RequestSubscribeParams params)
 AwaitableUnsubscribe Request::unsubscribe(RequestUnsubscribeParams params)
 {
 	const auto spThis = shared_from_this();
-	std::unique_lock lock { spThis->_subscriptionMutex };
 	const auto itrOperation = spThis->_operations.find(strSubscription);
 
 	if (itrOperation == _operations.end())
@@ -1948,7 +4877,13 @@ AwaitableUnsubscribe Request::unsubscribe(RequestUnsubscribeParams params)
 
 	if (optionalOrDefaultSubscription)
 	{
-		const auto registration = spThis->_subscriptions.at(params.key);
+		const auto registration = spThis->_subscriptions.find(params.key);
+
+		if (!registration)
+		{
+			throw std::out_of_range("Unknown subscription key");
+		}
+
 		const SelectionSetParams selectionSetParams {
 			ResolverContext::NotifyUnsubscribe,
 			registration->data->state,
@@ -1960,16 +4895,12 @@ AwaitableUnsubscribe Request::unsubscribe(RequestUnsubscribeParams params)
 			params.launch,
 		};
 
-		lock.unlock();
-
 		co_await params.launch;
 		errors = std::move((co_await optionalOrDefaultSubscription->resolve(selectionSetParams,
 								registration->selection,
-								registration->data->fragments,
+								*registration->data->fragments,
 								registration->data->variables))
 							   .errors);
-
-		lock.lock();
 	}
 
 	spThis->removeSubscription(params.key);
@@ -1982,6 +4913,156 @@ AwaitableUnsubscribe Request::unsubscribe(RequestUnsubscribeParams params)
 	co_return;
 }
 
+namespace {
+
+// Resolve the event for a single subscription in Request::deliver and build the document for its
+// callback.
+response::AwaitableValue resolveRegistration(std::shared_ptr<const Object> subscriptionObject,
+	std::shared_ptr<const SubscriptionData> registration, await_async launch)
+{
+	const SelectionSetParams selectionSetParams {
+		ResolverContext::Subscription,
+		registration->data->state,
+		registration->data->directives,
+		std::make_shared<FragmentDefinitionDirectiveStack>(),
+		std::make_shared<FragmentSpreadDirectiveStack>(),
+		std::make_shared<FragmentSpreadDirectiveStack>(),
+		std::nullopt,
+		launch,
+	};
+
+	response::Value document { response::Type::Map };
+
+	try
+	{
+		co_await launch;
+
+		auto result = co_await subscriptionObject->resolve(selectionSetParams,
+			registration->selection,
+			*registration->data->fragments,
+			registration->data->variables);
+
+		document.emplace_back(std::string { strData }, std::move(result.data));
+
+		if (!result.errors.empty())
+		{
+			document.emplace_back(std::string { strErrors },
+				buildErrorValues(std::move(result.errors)));
+		}
+	}
+	catch (schema_exception& ex)
+	{
+		document.emplace_back(std::string { strData }, response::Value());
+		document.emplace_back(std::string { strErrors }, ex.getErrors());
+	}
+
+	co_return document;
+}
+
+using RegistrationList = std::vector<std::shared_ptr<const SubscriptionData>>;
+using RegistrationGroup = std::span<const std::shared_ptr<const SubscriptionData>>;
+
+// The arguments and directives on the subscription field come from the document and the variables,
+// so they should match as well, but they are cheap to compare.
+bool resolvesSameResult(const SubscriptionData& lhs, const SubscriptionData& rhs) noexcept
+{
+	return lhs.fingerprint == rhs.fingerprint && lhs.data->state == rhs.data->state
+		&& lhs.operationName == rhs.operationName && lhs.data->variables == rhs.data->variables
+		&& lhs.arguments == rhs.arguments && lhs.fieldDirectives == rhs.fieldDirectives
+		&& lhs.normalizedQuery == rhs.normalizedQuery;
+}
+
+// Reorder the registrations so that the subscriptions which resolve the same result for an event
+// are next to each other, in the order that the first one in each group was registered.
+std::vector<RegistrationGroup> groupRegistrations(RegistrationList& registrations, bool deduplicate)
+{
+	std::vector<RegistrationGroup> groups;
+
+	if (!deduplicate)
+	{
+		groups.reserve(registrations.size());
+
+		for (const auto& registration : registrations)
+		{
+			groups.emplace_back(&registration, 1);
+		}
+
+		return groups;
+	}
+
+	std::vector<RegistrationList> members;
+	std::unordered_multimap<size_t, size_t> leaders;
+
+	for (auto& registration : registrations)
+	{
+		const auto [itrBegin, itrEnd] = leaders.equal_range(registration->fingerprint);
+		const auto itrLeader =
+			std::find_if(itrBegin, itrEnd, [&members, &registration](const auto& entry) noexcept {
+				return resolvesSameResult(*members[entry.second].front(), *registration);
+			});
+
+		if (itrLeader == itrEnd)
+		{
+			leaders.emplace(registration->fingerprint, members.size());
+			members.emplace_back().push_back(std::move(registration));
+		}
+		else
+		{
+			members[itrLeader->second].push_back(std::move(registration));
+		}
+	}
+
+	registrations.clear();
+
+	for (auto& group : members)
+	{
+		std::move(group.begin(), group.end(), std::back_inserter(registrations));
+	}
+
+	groups.reserve(members.size());
+
+	for (size_t offset = 0; const auto& group : members)
+	{
+		groups.emplace_back(registrations.data() + offset, group.size());
+		offset += group.size();
+	}
+
+	return groups;
+}
+
+// Every subscription in a group receives the same result, so they share a single immutable copy
+// of the document instead of copying it for each callback.
+void invokeCallbacks(RegistrationGroup group, response::Value&& document)
+{
+	if (group.size() == 1)
+	{
+		group.front()->callback(std::move(document));
+		return;
+	}
+
+	const auto shared = std::make_shared<const response::Value>(std::move(document));
+
+	for (const auto& registration : group)
+	{
+		registration->callback(response::Value { shared });
+	}
+}
+
+// Invoke the callbacks from the coroutine which resolved the group, for DeliverOrder::Completion.
+// It keeps the registrations alive in case Request::deliver stops waiting for it.
+AwaitableDeliver deliverGroup(std::shared_ptr<const Object> subscriptionObject,
+	[[maybe_unused]] std::shared_ptr<const RegistrationList> registrations,
+	RegistrationGroup group, await_async launch)
+{
+	auto document = co_await resolveRegistration(std::move(subscriptionObject),
+		group.front(),
+		std::move(launch));
+
+	invokeCallbacks(group, std::move(document));
+}
+
+} // namespace
+
 AwaitableDeliver Request::deliver(RequestDeliverParams params) const
 {
 	const auto itrOperation = _operations.find(strSubscription);
@@ -2003,76 +5084,137 @@ AwaitableDeliver Request::deliver(RequestDeliverParams params) const
 		throw std::invalid_argument("Missing subscriptionObject");
 	}
 
-	const auto registrations = collectRegistrations(params.field, std::move(params.filter));
+	auto registrations = std::make_shared<RegistrationList>(
+		collectRegistrations(params.field, std::move(params.filter)));
 
-	if (registrations.empty())
+	if (registrations->empty())
 	{
 		co_return;
 	}
 
-	for (const auto& registration : registrations)
-	{
-		const SelectionSetParams selectionSetParams {
-			ResolverContext::Subscription,
-			registration->data->state,
-			registration->data->directives,
-			std::make_shared<FragmentDefinitionDirectiveStack>(),
-			std::make_shared<FragmentSpreadDirectiveStack>(),
-			std::make_shared<FragmentSpreadDirectiveStack>(),
-			std::nullopt,
-			params.launch,
-		};
+	const auto groups = groupRegistrations(*registrations, params.deduplicate);
+	const auto maxConcurrency =
+		(params.maxConcurrency == 0 ? groups.size() : params.maxConcurrency);
 
-		response::Value document { response::Type::Map };
+	if (params.order == DeliverOrder::Completion)
+	{
+		// Each group invokes its own callbacks, so just wait for the oldest one whenever there are
+		// too many of them resolving at the same time.
+		std::deque<AwaitableDeliver> pending;
 
-		try
+		for (const auto& group : groups)
 		{
-			co_await params.launch;
+			if (pending.size() == maxConcurrency)
+			{
+				auto oldest = std::move(pending.front());
 
-			auto result = co_await optionalOrDefaultSubscription->resolve(selectionSetParams,
-				registration->selection,
-				registration->data->fragments,
-				registration->data->variables);
+				pending.pop_front();
+				co_await oldest;
+			}
 
-			document.emplace_back(std::string { strData }, std::move(result.data));
+			pending.push_back(
+				deliverGroup(optionalOrDefaultSubscription, registrations, group, params.launch));
+		}
 
-			if (!result.errors.empty())
-			{
-				document.emplace_back(std::string { strErrors },
-					buildErrorValues(std::move(result.errors)));
-			}
+		for (auto& delivery : pending)
+		{
+			co_await delivery;
 		}
-		catch (schema_exception& ex)
+
+		co_return;
+	}
+
+	// Keep resolving the groups after the oldest one while it is still pending, but invoke the
+	// callbacks in the order of the groups. Without deduplicate that is the same order that they
+	// were registered, otherwise each group is in the position of its first registration and the
+	// callbacks for the rest of the group are invoked with it.
+	std::deque<std::pair<RegistrationGroup, response::AwaitableValue>> pending;
+
+	for (auto itr = groups.cbegin(); itr != groups.cend() || !pending.empty();)
+	{
+		if (itr != groups.cend() && pending.size() < maxConcurrency)
 		{
-			document.emplace_back(std::string { strData }, response::Value());
-			document.emplace_back(std::string { strErrors }, ex.getErrors());
+			pending.emplace_back(*itr,
+				resolveRegistration(optionalOrDefaultSubscription, itr->front(), params.launch));
+			++itr;
+			continue;
 		}
 
-		registration->callback(std::move(document));
+		auto [group, document] = std::move(pending.front());
+
+		pending.pop_front();
+		invokeCallbacks(group, co_await document);
 	}
 
 	co_return;
 }
 
-SubscriptionKey Request::addSubscription(RequestSubscribeParams&& params)
+std::shared_ptr<const SubscriptionDocument> Request::loadSubscriptionDocument(
+	RequestSubscribeParams& params)
 {
-	auto errors = validate(params.query);
+	// Copies of a peg::ast share the same root node, so this finds the document for any of them.
+	const auto root = (params.document ? params.document->root : params.query.root).get();
 
-	if (!errors.empty())
 	{
-		throw schema_exception { std::move(errors) };
+		const std::lock_guard lock { _subscriptionDocumentsMutex };
+		const auto itr = _subscriptionDocuments.find(root);
+
+		if (itr != _subscriptionDocuments.end())
+		{
+			if (auto document = itr->second.lock())
+			{
+				return document;
+			}
+		}
+	}
+
+	auto query = std::move(params.document);
+
+	if (!query || !query->validated)
+	{
+		peg::ast ast = query ? *query : std::move(params.query);
+		auto errors = validate(ast);
+
+		if (!errors.empty())
+		{
+			throw schema_exception { std::move(errors) };
+		}
+
+		query = std::make_shared<const peg::ast>(std::move(ast));
+	}
+
+	auto document = std::make_shared<const SubscriptionDocument>(std::move(query));
+	const std::lock_guard lock { _subscriptionDocumentsMutex };
+	auto& entry = _subscriptionDocuments[root];
+
+	// Another thread may have added the same document while this one was validating it.
+	if (auto existing = entry.lock())
+	{
+		return existing;
 	}
 
-	FragmentDefinitionVisitor fragmentVisitor(params.variables);
+	entry = document;
 
-	peg::for_each_child<peg::fragment_definition>(*params.query.root,
-		[&fragmentVisitor](const peg::ast_node& child) {
-			fragmentVisitor.visit(child);
+	// Remove the documents which no longer have any subscriptions, once the map doubles in size.
+	if (_subscriptionDocuments.size() > _subscriptionDocumentsPruneSize)
+	{
+		std::erase_if(_subscriptionDocuments, [](const auto& element) noexcept {
+			return element.second.expired();
 		});
+		_subscriptionDocumentsPruneSize =
+			std::max(size_t { 16 }, _subscriptionDocuments.size() * 2);
+	}
+
+	return document;
+}
 
-	auto fragments = fragmentVisitor.getFragments();
+std::pair<SubscriptionKey, std::shared_ptr<const SubscriptionData>> Request::addSubscription(
+	RequestSubscribeParams&& params)
+{
+	const auto document = loadSubscriptionDocument(params);
+	auto fragments = document->getFragments(params.variables);
 	auto [operationType, operationDefinition] =
-		findOperationDefinition(params.query, params.operationName);
+		findValidatedOperationDefinition(*document->query, params.operationName);
 
 	if (!operationDefinition)
 	{
@@ -2105,7 +5247,11 @@ SubscriptionKey Request::addSubscription(RequestSubscribeParams&& params)
 	}
 
 	auto itr = _operations.find(strSubscription);
+	// Alias the AST in the document, so the registration keeps the shared document alive for the
+	// next subscription on it, even if the fragments are not shared.
 	SubscriptionDefinitionVisitor subscriptionVisitor(std::move(params),
+		std::shared_ptr<const peg::ast> { document, document->query.get() },
+		document->normalizedQuery,
 		std::move(fragments),
 		itr->second);
 
@@ -2114,42 +5260,57 @@ SubscriptionKey Request::addSubscription(RequestSubscribeParams&& params)
 			subscriptionVisitor.visit(child);
 		});
 
-	auto registration = subscriptionVisitor.getRegistration();
-	auto key = _nextKey++;
+	std::shared_ptr<const SubscriptionData> registration = subscriptionVisitor.getRegistration();
 
-	_listeners[registration->field].emplace(key);
-	_subscriptions.emplace(key, std::move(registration));
+	// Hold the shared lock on the indexes until this subscription has been added to both the
+	// registry and the index on its field, so indexSubscriptionArguments never adds it twice.
+	const std::shared_lock lock { _argumentIndexMutex };
+	const auto key = _subscriptions.add(registration);
 
-	return key;
+	if (const auto itrIndex = _argumentIndexes.find(registration->field);
+		itrIndex != _argumentIndexes.end())
+	{
+		itrIndex->second->add(key, *registration);
+	}
+
+	return { key, std::move(registration) };
 }
 
-void Request::removeSubscription(SubscriptionKey key)
+void Request::indexSubscriptionArguments(
+	std::string_view field, std::vector<std::string> argumentNames)
 {
-	auto itrSubscription = _subscriptions.find(key);
+	auto index = std::make_shared<SubscriptionArgumentIndex>(std::move(argumentNames));
+	const std::unique_lock lock { _argumentIndexMutex };
 
-	if (itrSubscription == _subscriptions.end())
+	for (const auto& [key, registration] : _subscriptions.snapshot(field))
 	{
-		return;
+		index->add(key, *registration);
 	}
 
-	const auto listenerKey = std::string_view { itrSubscription->second->field };
-	auto& listener = _listeners.at(listenerKey);
-
-	listener.erase(key);
-	if (listener.empty())
+	if (const auto itrIndex = _argumentIndexes.find(field); itrIndex != _argumentIndexes.end())
+	{
+		itrIndex->second = std::move(index);
+	}
+	else
 	{
-		_listeners.erase(listenerKey);
+		_argumentIndexes.emplace(SubscriptionName { field }, std::move(index));
 	}
+}
 
-	_subscriptions.erase(itrSubscription);
+void Request::removeSubscription(SubscriptionKey key)
+{
+	const std::shared_lock lock { _argumentIndexMutex };
+	const auto registration = _subscriptions.remove(key);
 
-	if (_subscriptions.empty())
+	if (!registration)
 	{
-		_nextKey = 0;
+		return;
 	}
-	else
+
+	if (const auto itrIndex = _argumentIndexes.find(registration->field);
+		itrIndex != _argumentIndexes.end())
 	{
-		_nextKey = _subscriptions.rbegin()->first + 1;
+		itrIndex->second->remove(key, *registration);
 	}
 }
 
@@ -2157,144 +5318,177 @@ std::vector<std::shared_ptr<const SubscriptionData>> Request::collectRegistratio
 	std::string_view field, RequestDeliverFilter&& filter) const noexcept
 {
 	std::vector<std::shared_ptr<const SubscriptionData>> registrations;
-	const std::lock_guard lock { _subscriptionMutex };
-	const auto itrListeners = _listeners.find(field);
 
-	if (itrListeners != _listeners.end())
+	if (filter && std::holds_alternative<SubscriptionKey>(*filter))
 	{
-		if (!filter)
-		{
-			// Return all of the registered subscriptions for this field.
-			registrations.reserve(itrListeners->second.size());
-			std::transform(itrListeners->second.begin(),
-				itrListeners->second.end(),
-				std::back_inserter(registrations),
-				[this](const auto& key) noexcept {
-					const auto itr = _subscriptions.find(key);
+		// Return the specific subscription for this key.
+		auto registration = _subscriptions.find(std::get<SubscriptionKey>(*filter));
 
-					return itr == _subscriptions.end() ? std::shared_ptr<const SubscriptionData> {}
-													   : itr->second;
-				});
+		if (registration && registration->field == field)
+		{
+			registrations.push_back(std::move(registration));
 		}
-		else if (std::holds_alternative<SubscriptionKey>(*filter))
+
+		return registrations;
+	}
+
+	std::optional<std::vector<SubscriptionKey>> indexedKeys;
+
+	if (filter && std::holds_alternative<SubscriptionFilter>(*filter))
+	{
+		const auto& arguments = std::get<SubscriptionFilter>(*filter).arguments;
+
+		if (arguments && std::holds_alternative<SubscriptionArguments>(*arguments))
 		{
-			// Return the specific subscription for this key.
-			const auto itr = _subscriptions.find(std::get<SubscriptionKey>(*filter));
+			// Only check the subscriptions with matching values for the indexed arguments.
+			std::shared_lock lock { _argumentIndexMutex };
+			const auto itrIndex = _argumentIndexes.find(field);
 
-			if (itr != _subscriptions.end() && itr->second->field == field)
+			if (itrIndex != _argumentIndexes.end())
 			{
-				registrations.push_back(itr->second);
+				const auto index = itrIndex->second;
+
+				lock.unlock();
+				indexedKeys = index->find(std::get<SubscriptionArguments>(*arguments));
 			}
 		}
-		else if (std::holds_alternative<SubscriptionFilter>(*filter))
-		{
-			auto& subscriptionFilter = std::get<SubscriptionFilter>(*filter);
+	}
 
-			registrations.reserve(itrListeners->second.size());
+	std::vector<std::pair<SubscriptionKey, std::shared_ptr<const SubscriptionData>>> candidates;
 
-			std::optional<SubscriptionArgumentFilterCallback> argumentsMatch;
+	if (indexedKeys)
+	{
+		candidates.reserve(indexedKeys->size());
 
-			if (subscriptionFilter.arguments)
+		for (const auto key : *indexedKeys)
+		{
+			// Skip any subscriptions which were removed after looking them up in the index.
+			if (auto registration = _subscriptions.find(key))
 			{
-				if (std::holds_alternative<SubscriptionArguments>(*subscriptionFilter.arguments))
-				{
-					argumentsMatch = [arguments = std::move(std::get<SubscriptionArguments>(
-										  *subscriptionFilter.arguments))](
-										 response::MapType::const_reference required) noexcept {
-						auto itrArgument = arguments.find(required.first);
-
-						return (itrArgument != arguments.end()
-							&& itrArgument->second == required.second);
-					};
-				}
-				else if (std::holds_alternative<SubscriptionArgumentFilterCallback>(
-							 *subscriptionFilter.arguments))
-				{
-					argumentsMatch = std::move(std::get<SubscriptionArgumentFilterCallback>(
-						*subscriptionFilter.arguments));
-				}
+				candidates.emplace_back(key, std::move(registration));
 			}
+		}
+	}
+	else
+	{
+		candidates = _subscriptions.snapshot(field);
+	}
+
+	registrations.reserve(candidates.size());
+
+	if (!filter)
+	{
+		// Return all of the registered subscriptions for this field.
+		std::transform(std::make_move_iterator(candidates.begin()),
+			std::make_move_iterator(candidates.end()),
+			std::back_inserter(registrations),
+			[](auto&& entry) noexcept {
+				return std::move(entry.second);
+			});
+
+		return registrations;
+	}
+
+	auto& subscriptionFilter = std::get<SubscriptionFilter>(*filter);
+
+	std::optional<SubscriptionArgumentFilterCallback> argumentsMatch;
+
+	if (subscriptionFilter.arguments)
+	{
+		if (std::holds_alternative<SubscriptionArguments>(*subscriptionFilter.arguments))
+		{
+			argumentsMatch = [arguments = std::move(std::get<SubscriptionArguments>(
+								  *subscriptionFilter.arguments))](
+								 response::MapType::const_reference required) noexcept {
+				auto itrArgument = arguments.find(required.first);
+
+				return (itrArgument != arguments.end()
+					&& itrArgument->second == required.second);
+			};
+		}
+		else if (std::holds_alternative<SubscriptionArgumentFilterCallback>(
+					 *subscriptionFilter.arguments))
+		{
+			argumentsMatch = std::move(std::get<SubscriptionArgumentFilterCallback>(
+				*subscriptionFilter.arguments));
+		}
+	}
+
+	std::optional<SubscriptionDirectiveFilterCallback> directivesMatch;
+
+	if (subscriptionFilter.directives)
+	{
+		if (std::holds_alternative<Directives>(*subscriptionFilter.directives))
+		{
+			directivesMatch = [directives = std::move(
+								   std::get<Directives>(*subscriptionFilter.directives))](
+								  Directives::const_reference required) noexcept {
+				auto itrDirective = std::find_if(directives.cbegin(),
+					directives.cend(),
+					[directiveName = required.first](const auto& directive) noexcept {
+						return directive.first == directiveName;
+					});
+
+				return (itrDirective != directives.end()
+					&& itrDirective->second == required.second);
+			};
+		}
+		else if (std::holds_alternative<SubscriptionDirectiveFilterCallback>(
+					 *subscriptionFilter.directives))
+		{
+			directivesMatch = std::move(std::get<SubscriptionDirectiveFilterCallback>(
+				*subscriptionFilter.directives));
+		}
+	}
 
-			std::optional<SubscriptionDirectiveFilterCallback> directivesMatch;
+	for (auto& [key, registration] : candidates)
+	{
+		if (argumentsMatch)
+		{
+			const auto& subscriptionArguments = registration->arguments;
+			bool matchedArguments = true;
 
-			if (subscriptionFilter.directives)
+			// If the field in this subscription had arguments that did not match what
+			// was provided in this event, don't deliver the event to this subscription
+			for (const auto& required : subscriptionArguments)
 			{
-				if (std::holds_alternative<Directives>(*subscriptionFilter.directives))
-				{
-					directivesMatch = [directives = std::move(
-										   std::get<Directives>(*subscriptionFilter.directives))](
-										  Directives::const_reference required) noexcept {
-						auto itrDirective = std::find_if(directives.cbegin(),
-							directives.cend(),
-							[directiveName = required.first](const auto& directive) noexcept {
-								return directive.first == directiveName;
-							});
-
-						return (itrDirective != directives.end()
-							&& itrDirective->second == required.second);
-					};
-				}
-				else if (std::holds_alternative<SubscriptionDirectiveFilterCallback>(
-							 *subscriptionFilter.directives))
+				if (!(*argumentsMatch)(required))
 				{
-					directivesMatch = std::move(std::get<SubscriptionDirectiveFilterCallback>(
-						*subscriptionFilter.directives));
+					matchedArguments = false;
+					break;
 				}
 			}
 
-			for (const auto& key : itrListeners->second)
+			if (!matchedArguments)
 			{
-				auto itrSubscription = _subscriptions.find(key);
-				auto registration = itrSubscription->second;
+				continue;
+			}
+		}
 
-				if (argumentsMatch)
-				{
-					const auto& subscriptionArguments = registration->arguments;
-					bool matchedArguments = true;
-
-					// If the field in this subscription had arguments that did not match what
-					// was provided in this event, don't deliver the event to this subscription
-					for (const auto& required : subscriptionArguments)
-					{
-						if (!(*argumentsMatch)(required))
-						{
-							matchedArguments = false;
-							break;
-						}
-					}
-
-					if (!matchedArguments)
-					{
-						continue;
-					}
-				}
+		if (directivesMatch)
+		{
+			// If the field in this subscription had field directives that did not match
+			// what was provided in this event, don't deliver the event to this
+			// subscription
+			const auto& subscriptionFieldDirectives = registration->fieldDirectives;
+			bool matchedFieldDirectives = true;
 
-				if (directivesMatch)
+			for (const auto& required : subscriptionFieldDirectives)
+			{
+				if (!(*directivesMatch)(required))
 				{
-					// If the field in this subscription had field directives that did not match
-					// what was provided in this event, don't deliver the event to this
-					// subscription
-					const auto& subscriptionFieldDirectives = registration->fieldDirectives;
-					bool matchedFieldDirectives = true;
-
-					for (const auto& required : subscriptionFieldDirectives)
-					{
-						if (!(*directivesMatch)(required))
-						{
-							matchedFieldDirectives = false;
-							break;
-						}
-					}
-
-					if (!matchedFieldDirectives)
-					{
-						continue;
-					}
+					matchedFieldDirectives = false;
+					break;
 				}
+			}
 
-				registrations.push_back(std::move(registration));
+			if (!matchedFieldDirectives)
+			{
+				continue;
 			}
 		}
+
+		registrations.push_back(std::move(registration));
 	}
 
 	return registrations;
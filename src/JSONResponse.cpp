@@ -7,20 +7,31 @@
 #include <rapidjson/rapidjson.h>
 
 #include <rapidjson/reader.h>
-#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#ifdef GRAPHQL_USE_SIMDJSON
+#include <simdjson.h>
+#endif // GRAPHQL_USE_SIMDJSON
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 
 namespace graphql::response {
 
-class StringWriter
+using namespace std::literals;
+
+template <class OutputStream>
+class StreamWriter
 {
 public:
-	StringWriter(rapidjson::StringBuffer& buffer)
-		: _writer { buffer }
+	StreamWriter(OutputStream& stream)
+		: _writer { stream }
 	{
 	}
 
@@ -29,9 +40,9 @@ public:
 		_writer.StartObject();
 	}
 
-	void add_member(const std::string& key)
+	void add_member(std::string_view key)
 	{
-		_writer.Key(key.c_str());
+		_writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size()));
 	}
 
 	void end_object()
@@ -75,16 +86,260 @@ public:
 	}
 
 private:
-	rapidjson::Writer<rapidjson::StringBuffer> _writer;
+	rapidjson::Writer<OutputStream> _writer;
+};
+
+// Appends the JSON text for a Value directly to a std::string. Unlike a StreamWriter wrapped in
+// response::Writer, there is no virtual call per token, every string is written with its length,
+// and nothing needs to be copied out of an intermediate rapidjson::StringBuffer. The output is
+// the same as rapidjson::Writer with the default flags.
+class StringAppender
+{
+public:
+	explicit StringAppender(std::string& output) noexcept
+		: _output { output }
+	{
+	}
+
+	void write(Value&& response)
+	{
+		switch (response.type())
+		{
+			case Type::Map:
+			{
+				auto members = response.release<MapType>();
+				bool first = true;
+
+				_output.push_back('{');
+
+				for (auto& entry : members)
+				{
+					if (!first)
+					{
+						_output.push_back(',');
+					}
+
+					first = false;
+					writeString(entry.first);
+					_output.push_back(':');
+					write(std::move(entry.second));
+				}
+
+				_output.push_back('}');
+				break;
+			}
+
+			case Type::List:
+			{
+				auto elements = response.release<ListType>();
+				bool first = true;
+
+				_output.push_back('[');
+
+				for (auto& entry : elements)
+				{
+					if (!first)
+					{
+						_output.push_back(',');
+					}
+
+					first = false;
+					write(std::move(entry));
+				}
+
+				_output.push_back(']');
+				break;
+			}
+
+			case Type::String:
+			case Type::EnumValue:
+			{
+				writeString(response.get<StringType>());
+				break;
+			}
+
+			case Type::ID:
+			{
+				writeString(response.release<StringType>());
+				break;
+			}
+
+			case Type::Boolean:
+			{
+				_output.append(response.get<BooleanType>() ? "true"sv : "false"sv);
+				break;
+			}
+
+			case Type::Int:
+			{
+				std::array<char, 16> buffer;
+				const auto end =
+					rapidjson::internal::i32toa(response.get<IntType>(), buffer.data());
+
+				_output.append(buffer.data(), end);
+				break;
+			}
+
+			case Type::Float:
+			{
+				const auto value = response.get<FloatType>();
+
+				if (!std::isfinite(value))
+				{
+					_output.append("null"sv);
+					break;
+				}
+
+				std::array<char, 32> buffer;
+				const auto end = rapidjson::internal::dtoa(value, buffer.data());
+
+				_output.append(buffer.data(), end);
+				break;
+			}
+
+			case Type::Scalar:
+			{
+				write(response.release<ScalarType>());
+				break;
+			}
+
+			default:
+			{
+				_output.append("null"sv);
+				break;
+			}
+		}
+	}
+
+private:
+	// The same escape sequences as rapidjson::Writer, indexed by the unsigned value of each byte.
+	static constexpr std::array<char, 256> c_escapes = []() noexcept {
+		std::array<char, 256> escapes {};
+
+		for (std::uint8_t ch = 0; ch < 0x20; ++ch)
+		{
+			escapes[ch] = 'u';
+		}
+
+		escapes['\b'] = 'b';
+		escapes['\t'] = 't';
+		escapes['\n'] = 'n';
+		escapes['\f'] = 'f';
+		escapes['\r'] = 'r';
+		escapes['"'] = '"';
+		escapes['\\'] = '\\';
+
+		return escapes;
+	}();
+
+	void writeString(std::string_view value)
+	{
+		constexpr std::string_view c_hexDigits { "0123456789ABCDEF" };
+		auto run = value.data();
+		const auto end = run + value.size();
+
+		_output.push_back('"');
+
+		// Copy each run of characters which do not need escaping in a single append.
+		for (auto itr = run; itr != end; ++itr)
+		{
+			const auto ch = static_cast<std::uint8_t>(*itr);
+			const auto escape = c_escapes[ch];
+
+			if (escape == 0)
+			{
+				continue;
+			}
+
+			_output.append(run, itr);
+			_output.push_back('\\');
+			_output.push_back(escape);
+
+			if (escape == 'u')
+			{
+				_output.append("00"sv);
+				_output.push_back(c_hexDigits[ch >> 4]);
+				_output.push_back(c_hexDigits[ch & 0xF]);
+			}
+
+			run = itr + 1;
+		}
+
+		_output.append(run, end);
+		_output.push_back('"');
+	}
+
+	std::string& _output;
 };
 
 std::string toJSON(Value&& response)
 {
-	rapidjson::StringBuffer buffer;
-	Writer writer { std::make_unique<StringWriter>(buffer) };
+	std::string json;
 
-	writer.write(std::move(response));
-	return buffer.GetString();
+	toJSON(std::move(response), json);
+	return json;
+}
+
+void toJSON(Value&& response, std::string& output)
+{
+	StringAppender { output }.write(std::move(response));
+}
+
+// Output stream for rapidjson::Writer which passes the buffer to the sink whenever it fills up.
+// The rapidjson::Writer also flushes the stream when the outermost value is complete.
+class SinkStream
+{
+public:
+	using Ch = char;
+
+	SinkStream(JSONSink&& sink, size_t chunkSize)
+		: _sink { std::move(sink) }
+		, _chunkSize { std::max(chunkSize, size_t { 1 }) }
+	{
+		_buffer.reserve(_chunkSize);
+	}
+
+	void Put(Ch ch)
+	{
+		_buffer.push_back(ch);
+
+		if (_buffer.size() >= _chunkSize)
+		{
+			Flush();
+		}
+	}
+
+	void Flush()
+	{
+		if (!_buffer.empty())
+		{
+			_sink(_buffer);
+			_buffer.clear();
+		}
+	}
+
+private:
+	const JSONSink _sink;
+	const size_t _chunkSize;
+	std::string _buffer;
+};
+
+// The SinkStream base class is constructed first, so the StreamWriter base class can borrow it.
+class SinkWriter
+	: private SinkStream
+	, public StreamWriter<SinkStream>
+{
+public:
+	SinkWriter(JSONSink&& sink, size_t chunkSize)
+		: SinkStream { std::move(sink), chunkSize }
+		, StreamWriter<SinkStream> { static_cast<SinkStream&>(*this) }
+	{
+	}
+};
+
+Writer makeJSONWriter(JSONSink sink, size_t chunkSize)
+{
+	return Writer { std::make_unique<SinkWriter>(std::move(sink), chunkSize) };
 }
 
 struct ResponseHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ResponseHandler>
@@ -158,9 +413,9 @@ struct ResponseHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Respons
 		return true;
 	}
 
-	bool String(const Ch* str, rapidjson::SizeType /*length*/, bool /*copy*/)
+	bool String(const Ch* str, rapidjson::SizeType length, bool /*copy*/)
 	{
-		setValue(Value(std::string(str)).from_json());
+		setValue(Value(std::string(str, length)).from_json());
 		return true;
 	}
 
@@ -170,9 +425,9 @@ struct ResponseHandler : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Respons
 		return true;
 	}
 
-	bool Key(const Ch* str, rapidjson::SizeType /*length*/, bool /*copy*/)
+	bool Key(const Ch* str, rapidjson::SizeType length, bool /*copy*/)
 	{
-		_keyStack.push_back(str);
+		_keyStack.emplace_back(str, length);
 		return true;
 	}
 
@@ -218,12 +473,158 @@ private:
 	std::vector<Value> _responseStack;
 };
 
+#ifdef GRAPHQL_USE_SIMDJSON
+
+// Build the Value directly from the simdjson DOM, which has already found the structure of the
+// document, unescaped the strings, and parsed the numbers with SIMD instructions. The DOM has a
+// depth limit, so this recursion is bounded.
+bool fromSimdJSON(simdjson::dom::element element, Value& result)
+{
+	switch (element.type())
+	{
+		case simdjson::dom::element_type::OBJECT:
+		{
+			const auto object = element.get_object().value_unsafe();
+			Value map(Type::Map);
+
+			map.reserve(object.size());
+
+			for (const auto& member : object)
+			{
+				Value value;
+
+				if (!fromSimdJSON(member.value, value))
+				{
+					return false;
+				}
+
+				// Like ResponseHandler, ignore any duplicate members after the first one.
+				map.emplace_back(std::string { member.key }, std::move(value));
+			}
+
+			result = std::move(map);
+			break;
+		}
+
+		case simdjson::dom::element_type::ARRAY:
+		{
+			const auto array = element.get_array().value_unsafe();
+			Value list(Type::List);
+
+			list.reserve(array.size());
+
+			for (const auto entry : array)
+			{
+				Value value;
+
+				if (!fromSimdJSON(entry, value))
+				{
+					return false;
+				}
+
+				list.emplace_back(std::move(value));
+			}
+
+			result = std::move(list);
+			break;
+		}
+
+		case simdjson::dom::element_type::STRING:
+			result = Value(std::string { element.get_string().value_unsafe() }).from_json();
+			break;
+
+		case simdjson::dom::element_type::INT64:
+		{
+			// https://spec.graphql.org/October2021/#sec-Int
+			const auto value = element.get_int64().value_unsafe();
+
+			if (value < std::numeric_limits<IntType>::min()
+				|| value > std::numeric_limits<IntType>::max())
+			{
+				result = Value(static_cast<FloatType>(value));
+			}
+			else
+			{
+				result = Value(static_cast<IntType>(value));
+			}
+
+			break;
+		}
+
+		case simdjson::dom::element_type::UINT64:
+			// https://spec.graphql.org/October2021/#sec-Int
+			result = Value(static_cast<FloatType>(element.get_uint64().value_unsafe()));
+			break;
+
+		case simdjson::dom::element_type::DOUBLE:
+			result = Value(element.get_double().value_unsafe());
+			break;
+
+		case simdjson::dom::element_type::BOOL:
+			result = Value(element.get_bool().value_unsafe());
+			break;
+
+		case simdjson::dom::element_type::NULL_VALUE:
+			result = Value();
+			break;
+
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+// simdjson needs some padding after the end of the document. It only copies the buffer if the
+// std::string does not have enough spare capacity. The parser keeps the buffers it allocated for
+// the last document, so each thread reuses the same one. Returns std::nullopt for valid JSON which
+// simdjson cannot represent, so RapidJSON can parse it instead.
+std::optional<Value> parseSimdJSON(const std::string& json)
+{
+	thread_local simdjson::dom::parser parser;
+	simdjson::dom::element root;
+
+	switch (parser.parse(json).get(root))
+	{
+		case simdjson::SUCCESS:
+			break;
+
+		case simdjson::BIGINT_ERROR:
+		case simdjson::DEPTH_ERROR:
+			return std::nullopt;
+
+		default:
+			// Invalid JSON, e.g. a truncated document or a string which is not valid UTF-8.
+			return Value {};
+	}
+
+	Value result;
+
+	if (!fromSimdJSON(root, result))
+	{
+		return Value {};
+	}
+
+	return result;
+}
+
+#endif // GRAPHQL_USE_SIMDJSON
+
 Value parseJSON(const std::string& json)
 {
+#ifdef GRAPHQL_USE_SIMDJSON
+	if (auto result = parseSimdJSON(json))
+	{
+		return std::move(*result);
+	}
+#endif // GRAPHQL_USE_SIMDJSON
+
 	ResponseHandler handler;
 	rapidjson::Reader reader;
 	rapidjson::StringStream ss(json.c_str());
 
+	// If graphqljson is built with one of the RAPIDJSON_SSE2, RAPIDJSON_SSE42, or RAPIDJSON_NEON
+	// definitions, the reader skips whitespace 16 bytes at a time.
 	reader.Parse(ss, handler);
 
 	return handler.getResponse();
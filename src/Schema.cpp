@@ -452,13 +452,16 @@ struct Field::init
 	std::optional<std::string_view> deprecationReason;
 	std::weak_ptr<const BaseType> type;
 	std::vector<std::shared_ptr<const InputValue>> args;
+	FieldCost cost;
 };
 
 std::shared_ptr<Field> Field::Make(std::string_view name, std::string_view description,
 	std::optional<std::string_view> deprecationReason, std::weak_ptr<const BaseType> type,
-	std::vector<std::shared_ptr<const InputValue>>&& args)
+	std::vector<std::shared_ptr<const InputValue>>&& args, FieldCost&& cost)
 {
-	init params { name, description, deprecationReason, std::move(type), std::move(args) };
+	init params {
+		name, description, deprecationReason, std::move(type), std::move(args), std::move(cost)
+	};
 
 	return std::make_shared<Field>(std::move(params));
 }
@@ -469,6 +472,7 @@ Field::Field(init&& params)
 	, _deprecationReason(params.deprecationReason)
 	, _type(std::move(params.type))
 	, _args(std::move(params.args))
+	, _cost(std::move(params.cost))
 {
 }
 
@@ -497,6 +501,11 @@ const std::optional<std::string_view>& Field::deprecationReason() const noexcept
 	return _deprecationReason;
 }
 
+const FieldCost& Field::cost() const noexcept
+{
+	return _cost;
+}
+
 struct InputValue::init
 {
 	std::string_view name;
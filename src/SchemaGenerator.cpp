@@ -675,8 +675,9 @@ private:
 	{
 		virtual ~Concept() = default;
 
-		[[nodiscard("unnecessary call")]] virtual service::TypeNames getTypeNames() const noexcept = 0;
-		[[nodiscard("unnecessary call")]] virtual service::ResolverMap getResolvers() const noexcept = 0;
+		[[nodiscard("unnecessary call")]] virtual const service::TypeNames& getTypeNames() const noexcept = 0;
+		[[nodiscard("unnecessary call")]] virtual const service::ResolverMap& getResolvers() const noexcept = 0;
+		[[nodiscard("unnecessary call")]] virtual const service::Object& getObject() const noexcept = 0;
 
 		virtual void beginSelectionSet(const service::SelectionSetParams& params) const = 0;
 		virtual void endSelectionSet(const service::SelectionSetParams& params) const = 0;
@@ -691,16 +692,21 @@ private:
 		{
 		}
 
-		[[nodiscard("unnecessary call")]] service::TypeNames getTypeNames() const noexcept override
+		[[nodiscard("unnecessary call")]] const service::TypeNames& getTypeNames() const noexcept override
 		{
 			return _pimpl->getTypeNames();
 		}
 
-		[[nodiscard("unnecessary call")]] service::ResolverMap getResolvers() const noexcept override
+		[[nodiscard("unnecessary call")]] const service::ResolverMap& getResolvers() const noexcept override
 		{
 			return _pimpl->getResolvers();
 		}
 
+		[[nodiscard("unnecessary call")]] const service::Object& getObject() const noexcept override
+		{
+			return *_pimpl;
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const override
 		{
 			_pimpl->beginSelectionSet(params);
@@ -1075,8 +1081,8 @@ private:
 	{
 		headerFile << R"cpp(	const std::unique_ptr<const Concept> _pimpl;
 
-	[[nodiscard("unnecessary call")]] service::TypeNames getTypeNames() const noexcept;
-	[[nodiscard("unnecessary call")]] service::ResolverMap getResolvers() const noexcept;
+	[[nodiscard("unnecessary call")]] static const service::TypeNames& getTypeNames() noexcept;
+	[[nodiscard("unnecessary call")]] static const service::ResolverMap& getResolvers() noexcept;
 
 public:
 	GRAPHQLSERVICE_EXPORT explicit )cpp"
@@ -1139,8 +1145,8 @@ public:
 		}
 
 		headerFile
-			<< R"cpp(	[[nodiscard("unnecessary call")]] service::TypeNames getTypeNames() const noexcept;
-	[[nodiscard("unnecessary call")]] service::ResolverMap getResolvers() const noexcept;
+			<< R"cpp(	[[nodiscard("unnecessary call")]] static const service::TypeNames& getTypeNames() noexcept;
+	[[nodiscard("unnecessary call")]] static const service::ResolverMap& getResolvers() noexcept;
 
 	void beginSelectionSet(const service::SelectionSetParams& params) const override;
 	void endSelectionSet(const service::SelectionSetParams& params) const override;
@@ -2161,7 +2167,7 @@ void Generator::outputInterfaceImplementation(
 	// resolver methods.
 	sourceFile << cppType << R"cpp(::)cpp" << cppType
 			   << R"cpp((std::unique_ptr<const Concept> pimpl) noexcept
-	: service::Object { pimpl->getTypeNames(), pimpl->getResolvers() }
+	: service::Object { pimpl->getTypeNames(), pimpl->getResolvers(), &pimpl->getObject() }
 	, _pimpl { std::move(pimpl) }
 {
 }
@@ -2281,10 +2287,10 @@ void Generator::outputObjectImplementation(
 	}
 
 	sourceFile << R"cpp(
-service::TypeNames )cpp"
-			   << objectType.cppType << R"cpp(::getTypeNames() const noexcept
+const service::TypeNames& )cpp"
+			   << objectType.cppType << R"cpp(::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 )cpp";
 
 	for (const auto& interfaceName : objectType.interfaces)
@@ -2301,12 +2307,14 @@ service::TypeNames )cpp"
 
 	sourceFile << R"cpp(		R"gql()cpp" << objectType.type << R"cpp()gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap )cpp"
-			   << objectType.cppType << R"cpp(::getResolvers() const noexcept
+const service::ResolverMap& )cpp"
+			   << objectType.cppType << R"cpp(::getResolvers() noexcept
 {
-	return {
+	static const service::ResolverMap s_resolvers {
 )cpp";
 
 	std::map<std::string_view, std::string, internal::shorter_or_less> resolvers;
@@ -2314,26 +2322,36 @@ service::ResolverMap )cpp"
 	std::transform(objectType.fields.cbegin(),
 		objectType.fields.cend(),
 		std::inserter(resolvers, resolvers.begin()),
-		[](const OutputField& outputField) noexcept {
+		[&objectType](const OutputField& outputField) noexcept {
 			const auto resolverName = SchemaLoader::getOutputCppResolver(outputField);
 			std::ostringstream output;
 
 			output << R"cpp(		{ R"gql()cpp" << outputField.name
-				   << R"cpp()gql"sv, [this](service::ResolverParams&& params) { return )cpp"
-				   << resolverName << R"cpp((std::move(params)); } })cpp";
+				   << R"cpp()gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const )cpp"
+				   << objectType.cppType << R"cpp(&>(object).)cpp" << resolverName
+				   << R"cpp((std::move(params)); } })cpp";
 
 			return std::make_pair(std::string_view { outputField.name }, output.str());
 		});
 
-	resolvers["__typename"sv] =
-		R"cpp(		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } })cpp"s;
+	const auto outputBuiltinResolver = [&objectType](std::string_view fieldName,
+										   std::string_view resolverName) {
+		std::ostringstream output;
+
+		output << R"cpp(		{ R"gql()cpp" << fieldName
+			   << R"cpp()gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const )cpp"
+			   << objectType.cppType << R"cpp(&>(object).)cpp" << resolverName
+			   << R"cpp((std::move(params)); } })cpp";
+
+		return output.str();
+	};
+
+	resolvers["__typename"sv] = outputBuiltinResolver("__typename"sv, "resolve_typename"sv);
 
 	if (!_options.noIntrospection && isQueryType)
 	{
-		resolvers["__schema"sv] =
-			R"cpp(		{ R"gql(__schema)gql"sv, [this](service::ResolverParams&& params) { return resolve_schema(std::move(params)); } })cpp"s;
-		resolvers["__type"sv] =
-			R"cpp(		{ R"gql(__type)gql"sv, [this](service::ResolverParams&& params) { return resolve_type(std::move(params)); } })cpp"s;
+		resolvers["__schema"sv] = outputBuiltinResolver("__schema"sv, "resolve_schema"sv);
+		resolvers["__type"sv] = outputBuiltinResolver("__type"sv, "resolve_type"sv);
 	}
 
 	bool firstField = true;
@@ -2352,6 +2370,8 @@ service::ResolverMap )cpp"
 
 	sourceFile << R"cpp(
 	};
+
+	return s_resolvers;
 }
 )cpp";
 
@@ -2435,9 +2455,11 @@ service::AwaitableResolver )cpp"
 
 		if (!_loader.isIntrospection())
 		{
+			// Copy the field directives, ModifiedResult::convert still needs to find @stream in
+			// the ResolverParams after the accessor is done with them.
 			sourceFile
 				<< R"cpp(	service::SelectionSetParams selectionSetParams { static_cast<const service::SelectionSetParams&>(params) };
-	auto directives = std::move(params.fieldDirectives);
+	auto directives = params.fieldDirectives;
 )cpp";
 		}
 
@@ -2643,6 +2665,31 @@ void Generator::outputIntrospectionFields(
 		})cpp";
 		}
 
+		if (objectField.costWeight)
+		{
+			if (objectField.arguments.empty())
+			{
+				sourceFile << R"cpp(, {})cpp";
+			}
+
+			sourceFile << R"cpp(, { )cpp" << *objectField.costWeight << R"cpp(, {)cpp";
+
+			bool firstMultiplier = true;
+
+			for (const auto& multiplier : objectField.costMultipliers)
+			{
+				if (!firstMultiplier)
+				{
+					sourceFile << R"cpp(,)cpp";
+				}
+
+				firstMultiplier = false;
+				sourceFile << R"cpp( R"gql()cpp" << multiplier << R"cpp()gql"sv)cpp";
+			}
+
+			sourceFile << R"cpp( } })cpp";
+		}
+
 		sourceFile << R"cpp())cpp";
 	}
 
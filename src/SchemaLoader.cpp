@@ -3,6 +3,7 @@
 
 #include "SchemaLoader.h"
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <iostream>
@@ -1491,10 +1492,71 @@ OutputFieldList SchemaLoader::getOutputFields(const peg::ast_node::children_t& f
 
 							field.deprecationReason = std::move(deprecationReason);
 						}
+						else if (directiveName == "cost"sv)
+						{
+							field.costWeight = 1;
+
+							peg::on_first_child<peg::arguments>(directive,
+								[&field](const peg::ast_node& arguments) {
+									for (const auto& argument : arguments.children)
+									{
+										const auto argumentName =
+											argument->children.front()->string_view();
+										const auto& value = *argument->children.back();
+
+										if (argumentName == "weight"sv)
+										{
+											if (!value.is_type<peg::integer_value>()
+												|| value.string_view().front() == '-')
+											{
+												std::ostringstream error;
+												const auto position = value.begin();
+
+												error << "Invalid @cost weight field name: "
+													  << field.name << " line: " << position.line
+													  << " column: " << position.column;
+
+												throw std::runtime_error(error.str());
+											}
+
+											field.costWeight =
+												static_cast<std::size_t>(std::stoull(
+													std::string { value.string_view() }));
+										}
+										else if (argumentName == "multipliers"sv)
+										{
+											for (const auto& multiplier : value.children)
+											{
+												field.costMultipliers.push_back(
+													multiplier->unescaped_view());
+											}
+										}
+									}
+								});
+						}
 					});
 			}
 		}
 
+		for (const auto& multiplier : field.costMultipliers)
+		{
+			if (std::find_if(field.arguments.cbegin(), field.arguments.cend(),
+					[multiplier](const InputField& argument) noexcept {
+						return argument.name == multiplier;
+					})
+				== field.arguments.cend())
+			{
+				std::ostringstream error;
+				const auto position = fieldDefinition->begin();
+
+				error << "Unknown @cost multiplier argument: " << multiplier
+					  << " field name: " << field.name << " line: " << position.line
+					  << " column: " << position.column;
+
+				throw std::runtime_error(error.str());
+			}
+		}
+
 		std::tie(field.type, field.modifiers) = fieldType.getType();
 		field.position = fieldDefinition->begin();
 		outputFields.push_back(std::move(field));
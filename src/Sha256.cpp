@@ -0,0 +1,216 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "graphqlservice/internal/Sha256.h"
+
+#include <bit>
+
+namespace graphql::internal {
+
+namespace {
+
+// https://csrc.nist.gov/publications/detail/fips/180/4/final
+constexpr std::array<std::uint32_t, 64> c_roundConstants = {
+	0x428A2F98,
+	0x71374491,
+	0xB5C0FBCF,
+	0xE9B5DBA5,
+	0x3956C25B,
+	0x59F111F1,
+	0x923F82A4,
+	0xAB1C5ED5,
+	0xD807AA98,
+	0x12835B01,
+	0x243185BE,
+	0x550C7DC3,
+	0x72BE5D74,
+	0x80DEB1FE,
+	0x9BDC06A7,
+	0xC19BF174,
+	0xE49B69C1,
+	0xEFBE4786,
+	0x0FC19DC6,
+	0x240CA1CC,
+	0x2DE92C6F,
+	0x4A7484AA,
+	0x5CB0A9DC,
+	0x76F988DA,
+	0x983E5152,
+	0xA831C66D,
+	0xB00327C8,
+	0xBF597FC7,
+	0xC6E00BF3,
+	0xD5A79147,
+	0x06CA6351,
+	0x14292967,
+	0x27B70A85,
+	0x2E1B2138,
+	0x4D2C6DFC,
+	0x53380D13,
+	0x650A7354,
+	0x766A0ABB,
+	0x81C2C92E,
+	0x92722C85,
+	0xA2BFE8A1,
+	0xA81A664B,
+	0xC24B8B70,
+	0xC76C51A3,
+	0xD192E819,
+	0xD6990624,
+	0xF40E3585,
+	0x106AA070,
+	0x19A4C116,
+	0x1E376C08,
+	0x2748774C,
+	0x34B0BCB5,
+	0x391C0CB3,
+	0x4ED8AA4A,
+	0x5B9CCA4F,
+	0x682E6FF3,
+	0x748F82EE,
+	0x78A5636F,
+	0x84C87814,
+	0x8CC70208,
+	0x90BEFFFA,
+	0xA4506CEB,
+	0xBEF9A3F7,
+	0xC67178F2,
+};
+
+constexpr std::array<std::uint32_t, 8> c_initialState = {
+	0x6A09E667,
+	0xBB67AE85,
+	0x3C6EF372,
+	0xA54FF53A,
+	0x510E527F,
+	0x9B05688C,
+	0x1F83D9AB,
+	0x5BE0CD19,
+};
+
+constexpr size_t c_blockSize = 64;
+
+using Block = std::array<std::uint8_t, c_blockSize>;
+
+void processBlock(std::array<std::uint32_t, 8>& state, const std::uint8_t* block) noexcept
+{
+	std::array<std::uint32_t, 64> schedule {};
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		schedule[i] = (static_cast<std::uint32_t>(block[i * 4]) << 24)
+			| (static_cast<std::uint32_t>(block[i * 4 + 1]) << 16)
+			| (static_cast<std::uint32_t>(block[i * 4 + 2]) << 8)
+			| static_cast<std::uint32_t>(block[i * 4 + 3]);
+	}
+
+	for (size_t i = 16; i < schedule.size(); ++i)
+	{
+		const auto s0 = std::rotr(schedule[i - 15], 7) ^ std::rotr(schedule[i - 15], 18)
+			^ (schedule[i - 15] >> 3);
+		const auto s1 = std::rotr(schedule[i - 2], 17) ^ std::rotr(schedule[i - 2], 19)
+			^ (schedule[i - 2] >> 10);
+
+		schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+	}
+
+	auto [a, b, c, d, e, f, g, h] = state;
+
+	for (size_t i = 0; i < schedule.size(); ++i)
+	{
+		const auto s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+		const auto ch = (e & f) ^ (~e & g);
+		const auto temp1 = h + s1 + ch + c_roundConstants[i] + schedule[i];
+		const auto s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+		const auto maj = (a & b) ^ (a & c) ^ (b & c);
+		const auto temp2 = s0 + maj;
+
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+} // namespace
+
+Sha256::Digest Sha256::hash(std::string_view data) noexcept
+{
+	auto state = c_initialState;
+	const auto bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+	const auto fullBlocks = data.size() / c_blockSize;
+
+	for (size_t i = 0; i < fullBlocks; ++i)
+	{
+		processBlock(state, bytes + i * c_blockSize);
+	}
+
+	// Pad the remainder with a 1 bit, then 0 bits, then the big-endian length in bits, which may
+	// spill over into one more block.
+	std::array<Block, 2> tail {};
+	const auto remainder = data.size() % c_blockSize;
+
+	for (size_t i = 0; i < remainder; ++i)
+	{
+		tail[0][i] = bytes[fullBlocks * c_blockSize + i];
+	}
+
+	tail[0][remainder] = 0x80;
+
+	const size_t tailBlocks = (remainder + 1 + sizeof(std::uint64_t) > c_blockSize) ? 2 : 1;
+	auto& lastBlock = tail[tailBlocks - 1];
+	const auto bitLength = static_cast<std::uint64_t>(data.size()) * 8;
+
+	for (size_t i = 0; i < sizeof(std::uint64_t); ++i)
+	{
+		lastBlock[c_blockSize - 1 - i] = static_cast<std::uint8_t>(bitLength >> (i * 8));
+	}
+
+	for (size_t i = 0; i < tailBlocks; ++i)
+	{
+		processBlock(state, tail[i].data());
+	}
+
+	Digest result {};
+
+	for (size_t i = 0; i < state.size(); ++i)
+	{
+		result[i * 4] = static_cast<std::uint8_t>(state[i] >> 24);
+		result[i * 4 + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+		result[i * 4 + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+		result[i * 4 + 3] = static_cast<std::uint8_t>(state[i]);
+	}
+
+	return result;
+}
+
+std::string Sha256::toHex(const Digest& digest)
+{
+	constexpr std::string_view digits = "0123456789abcdef";
+	std::string result;
+
+	result.reserve(digest.size() * 2);
+
+	for (const auto byte : digest)
+	{
+		result.push_back(digits[byte >> 4]);
+		result.push_back(digits[byte & 0x0F]);
+	}
+
+	return result;
+}
+
+} // namespace graphql::internal
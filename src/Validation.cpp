@@ -9,8 +9,10 @@
 #include "graphqlservice/introspection/IntrospectionSchema.h"
 
 #include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 
 using namespace std::literals;
@@ -34,6 +36,25 @@ bool operator==(const ValidateType& lhs, const ValidateType& rhs) noexcept
 	return (lhs ? (rhs && &lhs->get() == &rhs->get()) : !rhs);
 }
 
+namespace {
+
+// The cost analysis saturates instead of overflowing, since any operation which gets near the
+// limit of size_t is going to exceed the cost budget anyway.
+constexpr size_t addCost(size_t lhs, size_t rhs) noexcept
+{
+	return (lhs > std::numeric_limits<size_t>::max() - rhs) ? std::numeric_limits<size_t>::max()
+															 : lhs + rhs;
+}
+
+constexpr size_t multiplyCost(size_t lhs, size_t rhs) noexcept
+{
+	return (rhs != 0 && lhs > std::numeric_limits<size_t>::max() / rhs)
+		? std::numeric_limits<size_t>::max()
+		: lhs * rhs;
+}
+
+} // namespace
+
 bool ValidateArgumentVariable::operator==(const ValidateArgumentVariable& other) const
 {
 	return name == other.name;
@@ -264,11 +285,14 @@ void ValidateArgumentValueVisitor::visitObjectValue(const peg::ast_node& objectV
 }
 
 ValidateField::ValidateField(ValidateType&& returnType, ValidateType&& objectType,
-	std::string_view fieldName, ValidateFieldArguments&& arguments)
+	std::string_view fieldName, ValidateFieldArguments&& arguments,
+	std::string_view scopedTypeName, schema_location position)
 	: returnType(std::move(returnType))
 	, objectType(std::move(objectType))
 	, fieldName(fieldName)
 	, arguments(std::move(arguments))
+	, scopedTypeName(scopedTypeName)
+	, position(std::move(position))
 {
 }
 
@@ -358,8 +382,8 @@ ValidateType ValidateVariableTypeVisitor::getType()
 	return result;
 }
 
-ValidateExecutableVisitor::ValidateExecutableVisitor(std::shared_ptr<schema::Schema> schema)
-	: _schema(schema)
+ValidateSchema::ValidateSchema(std::shared_ptr<schema::Schema> schema)
+	: _schema(std::move(schema))
 {
 	const auto& queryType = _schema->queryType();
 	const auto& mutationType = _schema->mutationType();
@@ -478,6 +502,129 @@ ValidateExecutableVisitor::ValidateExecutableVisitor(std::shared_ptr<schema::Sch
 		validateDirective.arguments = getArguments(args);
 		_directives[name] = std::move(validateDirective);
 	}
+
+	// Build the field tables for every type up front, so that they never change while the
+	// ValidateSchema is shared between threads.
+	for (const auto& entry : types)
+	{
+		const auto name = entry.first;
+		const auto kind = entry.second->kind();
+
+		if (kind == introspection::TypeKind::INPUT_OBJECT)
+		{
+			_inputTypeFields.emplace(name, getArguments(entry.second->inputFields()));
+		}
+		else if (!isScalarType(kind))
+		{
+			const bool isQueryType = queryType && name == queryType->name();
+
+			_typeFields.emplace(name, getTypeFields(*entry.second, isQueryType));
+		}
+	}
+}
+
+ValidateSchema::FieldTypes ValidateSchema::getTypeFields(
+	const schema::BaseType& type, bool isQueryType) const
+{
+	const auto& fields = type.fields();
+	FieldTypes validateFields;
+
+	for (auto& entry : fields)
+	{
+		if (!entry)
+		{
+			continue;
+		}
+
+		const auto fieldName = entry->name();
+		ValidateTypeField subField;
+
+		subField.returnType = getValidateType(entry->type().lock());
+
+		if (fieldName.empty() || !subField.returnType)
+		{
+			continue;
+		}
+
+		subField.arguments = getArguments(entry->args());
+
+		const auto& cost = entry->cost();
+
+		subField.costWeight = cost.weight;
+
+		for (auto multiplier : cost.multipliers)
+		{
+			ValidateCostMultiplier costMultiplier { multiplier };
+			const auto& args = entry->args();
+			const auto itrArg = std::find_if(args.cbegin(),
+				args.cend(),
+				[multiplier](const std::shared_ptr<const schema::InputValue>& arg) noexcept {
+					return arg->name() == multiplier;
+				});
+
+			if (itrArg != args.cend())
+			{
+				const auto defaultValue = (*itrArg)->defaultValue();
+
+				std::from_chars(defaultValue.data(),
+					defaultValue.data() + defaultValue.size(),
+					costMultiplier.defaultValue);
+			}
+
+			subField.costMultipliers.push_back(std::move(costMultiplier));
+		}
+
+		validateFields[fieldName] = std::move(subField);
+	}
+
+	if (_schema->supportsIntrospection() && isQueryType)
+	{
+		ValidateTypeField schemaField;
+
+		schemaField.returnType = getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
+			_schema->LookupType(R"gql(__Schema)gql"sv)));
+		validateFields[R"gql(__schema)gql"sv] = std::move(schemaField);
+
+		ValidateTypeField typeField;
+		ValidateArgument nameArgument;
+
+		typeField.returnType = getValidateType(_schema->LookupType(R"gql(__Type)gql"sv));
+
+		nameArgument.type = getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
+			_schema->LookupType(R"gql(String)gql"sv)));
+		typeField.arguments[R"gql(name)gql"sv] = std::move(nameArgument);
+
+		validateFields[R"gql(__type)gql"sv] = std::move(typeField);
+	}
+
+	ValidateTypeField typenameField;
+
+	typenameField.returnType = getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
+		_schema->LookupType(R"gql(String)gql"sv)));
+	validateFields[R"gql(__typename)gql"sv] = std::move(typenameField);
+
+	return validateFields;
+}
+
+ValidateExecutableVisitor::ValidateExecutableVisitor(std::shared_ptr<schema::Schema> schema)
+	: ValidateExecutableVisitor { std::make_shared<const ValidateSchema>(std::move(schema)) }
+{
+}
+
+ValidateExecutableVisitor::ValidateExecutableVisitor(
+	std::shared_ptr<const ValidateSchema> validationSchema, RequestCostLimit costLimit)
+	: _validationSchema { std::move(validationSchema) }
+	, _schema { _validationSchema->_schema }
+	, _costLimit { costLimit }
+	, _operationTypes { _validationSchema->_operationTypes }
+	, _types { _validationSchema->_types }
+	, _matchingTypes { _validationSchema->_matchingTypes }
+	, _directives { _validationSchema->_directives }
+	, _enumValues { _validationSchema->_enumValues }
+	, _scalarTypes { _validationSchema->_scalarTypes }
+	, _typeFields { _validationSchema->_typeFields }
+	, _inputTypeFields { _validationSchema->_inputTypeFields }
+{
 }
 
 void ValidateExecutableVisitor::visit(const peg::ast_node& root)
@@ -597,6 +744,7 @@ std::list<schema_error> ValidateExecutableVisitor::getStructuredErrors()
 	_operationDefinitions.clear();
 	_referencedFragments.clear();
 	_fragmentCycles.clear();
+	_validatedFragments.clear();
 
 	return errors;
 }
@@ -614,7 +762,7 @@ void ValidateExecutableVisitor::visitFragmentDefinition(const peg::ast_node& fra
 
 	auto itrType = _types.find(innerType);
 
-	if (itrType == _types.end() || isScalarType(itrType->second->get().kind()))
+	if (itrType == _types.end() || ValidateSchema::isScalarType(itrType->second->get().kind()))
 	{
 		// https://spec.graphql.org/October2021/#sec-Fragment-Spread-Type-Existence
 		// https://spec.graphql.org/October2021/#sec-Fragments-On-Composite-Types
@@ -785,10 +933,37 @@ void ValidateExecutableVisitor::visitOperationDefinition(const peg::ast_node& op
 	_introspectionFieldCount = 0;
 	_fieldCount = 0;
 
+	// The fragments might reference the variables in this operation, so validate them again.
+	_validatedFragments.clear();
+
 	const auto& selection = *operationDefinition.children.back();
 
+	_subscriptionRoot = (operationType == strSubscription);
+
 	visitSelection(selection);
 
+	_subscriptionRoot = false;
+
+	if (_costLimit.maxCost != 0)
+	{
+		const auto cost = getSelectionCost(_selectionFields);
+
+		if (cost > _costLimit.maxCost)
+		{
+			auto position = operationDefinition.begin();
+			std::ostringstream error;
+
+			error << "Operation cost: " << cost << " exceeds limit: " << _costLimit.maxCost;
+
+			if (!operationName.empty())
+			{
+				error << " name: " << operationName;
+			}
+
+			_errors.push_back({ error.str(), { position.line, position.column } });
+		}
+	}
+
 	if (operationType == strSubscription)
 	{
 		if (_fieldCount > 1)
@@ -845,6 +1020,7 @@ void ValidateExecutableVisitor::visitOperationDefinition(const peg::ast_node& op
 	_operationVariables.reset();
 	_variableDefinitions.clear();
 	_referencedVariables.clear();
+	_validatedFragments.clear();
 }
 
 void ValidateExecutableVisitor::visitSelection(const peg::ast_node& selection)
@@ -866,7 +1042,7 @@ void ValidateExecutableVisitor::visitSelection(const peg::ast_node& selection)
 	}
 }
 
-ValidateTypeFieldArguments ValidateExecutableVisitor::getArguments(
+ValidateTypeFieldArguments ValidateSchema::getArguments(
 	const std::vector<std::shared_ptr<const schema::InputValue>>& args)
 {
 	ValidateTypeFieldArguments result;
@@ -891,7 +1067,7 @@ ValidateTypeFieldArguments ValidateExecutableVisitor::getArguments(
 	return result;
 }
 
-constexpr bool ValidateExecutableVisitor::isScalarType(introspection::TypeKind kind)
+constexpr bool ValidateSchema::isScalarType(introspection::TypeKind kind)
 {
 	switch (kind)
 	{
@@ -1410,91 +1586,15 @@ bool ValidateExecutableVisitor::validateVariableType(bool isNonNull,
 }
 
 ValidateExecutableVisitor::TypeFields::const_iterator ValidateExecutableVisitor::
-	getScopedTypeFields()
+	getScopedTypeFields() const
 {
-	auto typeKind = _scopedType->get().kind();
-	auto itrType = _typeFields.find(_scopedType->get().name());
-
-	if (itrType == _typeFields.end() && !isScalarType(typeKind))
-	{
-		const auto& fields = _scopedType->get().fields();
-		internal::string_view_map<ValidateTypeField> validateFields;
-
-		for (auto& entry : fields)
-		{
-			if (!entry)
-			{
-				continue;
-			}
-
-			const auto fieldName = entry->name();
-			ValidateTypeField subField;
-
-			subField.returnType = getValidateType(entry->type().lock());
-
-			if (fieldName.empty() || !subField.returnType)
-			{
-				continue;
-			}
-
-			subField.arguments = getArguments(entry->args());
-
-			validateFields[fieldName] = std::move(subField);
-		}
-
-		if (_schema->supportsIntrospection() && _scopedType == _operationTypes[strQuery])
-		{
-			ValidateTypeField schemaField;
-
-			schemaField.returnType =
-				getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
-					_schema->LookupType(R"gql(__Schema)gql"sv)));
-			validateFields[R"gql(__schema)gql"sv] = std::move(schemaField);
-
-			ValidateTypeField typeField;
-			ValidateArgument nameArgument;
-
-			typeField.returnType = getValidateType(_schema->LookupType(R"gql(__Type)gql"sv));
-
-			nameArgument.type = getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
-				_schema->LookupType(R"gql(String)gql"sv)));
-			typeField.arguments[R"gql(name)gql"sv] = std::move(nameArgument);
-
-			validateFields[R"gql(__type)gql"sv] = std::move(typeField);
-		}
-
-		ValidateTypeField typenameField;
-
-		typenameField.returnType =
-			getValidateType(_schema->WrapType(introspection::TypeKind::NON_NULL,
-				_schema->LookupType(R"gql(String)gql"sv)));
-		validateFields[R"gql(__typename)gql"sv] = std::move(typenameField);
-
-		itrType = _typeFields.emplace(_scopedType->get().name(), std::move(validateFields)).first;
-	}
-
-	return itrType;
+	return _typeFields.find(_scopedType->get().name());
 }
 
 ValidateExecutableVisitor::InputTypeFields::const_iterator ValidateExecutableVisitor::
-	getInputTypeFields(std::string_view name)
+	getInputTypeFields(std::string_view name) const
 {
-	auto itrFields = _inputTypeFields.find(name);
-
-	if (itrFields == _inputTypeFields.end())
-	{
-		auto itrType = _types.find(name);
-
-		if (itrType != _types.end()
-			&& itrType->second->get().kind() == introspection::TypeKind::INPUT_OBJECT)
-		{
-			itrFields =
-				_inputTypeFields.emplace(name, getArguments(itrType->second->get().inputFields()))
-					.first;
-		}
-	}
-
-	return itrFields;
+	return _inputTypeFields.find(name);
 }
 
 template <class _FieldTypes>
@@ -1623,6 +1723,38 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 		return;
 	}
 
+	peg::on_first_child<peg::directives>(field,
+		[this, &field, &wrappedType, name](const peg::ast_node& directives) {
+			const bool stream = std::any_of(directives.children.cbegin(),
+				directives.children.cend(),
+				[](const auto& directive) noexcept {
+					return directive->children.front()->string_view() == strStream;
+				});
+
+			if (!stream)
+			{
+				return;
+			}
+
+			auto listType = wrappedType;
+
+			if (listType && listType->get().kind() == introspection::TypeKind::NON_NULL)
+			{
+				listType = getValidateType(listType->get().ofType().lock());
+			}
+
+			if (!listType || listType->get().kind() != introspection::TypeKind::LIST)
+			{
+				// https://github.com/graphql/graphql-spec/pull/742
+				auto position = field.begin();
+				std::ostringstream message;
+
+				message << "Stream directive on non-list field name: " << name;
+
+				_errors.push_back({ message.str(), { position.line, position.column } });
+			}
+		});
+
 	std::string_view alias;
 
 	peg::on_first_child<peg::alias_name>(field, [&alias](const peg::ast_node& child) {
@@ -1670,15 +1802,18 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 	ValidateType objectType =
 		(_scopedType->get().kind() == introspection::TypeKind::OBJECT ? _scopedType
 																	  : ValidateType {});
+	const auto fieldPosition = field.begin();
 	ValidateField validateField(std::move(wrappedType),
 		std::move(objectType),
 		name,
-		std::move(validateArguments));
+		std::move(validateArguments),
+		_scopedType->get().name(),
+		{ fieldPosition.line, fieldPosition.column });
 	auto itrValidateField = _selectionFields.find(alias);
 
 	if (itrValidateField != _selectionFields.end())
 	{
-		if (itrValidateField->second == validateField)
+		if (*itrValidateField->second == validateField)
 		{
 			// We already validated this field.
 			return;
@@ -1696,9 +1831,14 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 	}
 
 	auto itrField = itrType->second.find(name);
+	size_t costWeight = 1;
+	size_t costMultiplier = 1;
 
 	if (itrField != itrType->second.end())
 	{
+		costWeight = itrField->second.costWeight;
+		costMultiplier = getCostMultiplier(itrField->second, validateField.arguments);
+
 		for (auto argumentName : argumentNames)
 		{
 			auto itrArgument = itrField->second.arguments.find(argumentName);
@@ -1762,7 +1902,9 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 		}
 	}
 
-	_selectionFields.emplace(alias, std::move(validateField));
+	auto selectionField = std::make_shared<ValidateField>(std::move(validateField));
+
+	_selectionFields.emplace(alias, selectionField);
 
 	const peg::ast_node* selection = nullptr;
 
@@ -1771,6 +1913,7 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 	});
 
 	size_t subFieldCount = 0;
+	size_t subFieldCost = 0;
 
 	if (selection != nullptr)
 	{
@@ -1778,14 +1921,19 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 		auto outerFields = std::move(_selectionFields);
 		auto outerFieldCount = _fieldCount;
 		auto outerIntrospectionFieldCount = _introspectionFieldCount;
+		const auto outerSubscriptionRoot = _subscriptionRoot;
 
 		_fieldCount = 0;
 		_introspectionFieldCount = 0;
+		_subscriptionRoot = false;
 		_selectionFields.clear();
 		_scopedType = std::move(innerType);
 
 		visitSelection(*selection);
 
+		_subscriptionRoot = outerSubscriptionRoot;
+
+		subFieldCost = getSelectionCost(_selectionFields);
 		innerType = std::move(_scopedType);
 		_scopedType = std::move(outerType);
 		_selectionFields = std::move(outerFields);
@@ -1794,7 +1942,9 @@ void ValidateExecutableVisitor::visitField(const peg::ast_node& field)
 		_fieldCount = outerFieldCount;
 	}
 
-	if (subFieldCount == 0 && !isScalarType(innerType->get().kind()))
+	selectionField->cost = addCost(costWeight, multiplyCost(costMultiplier, subFieldCost));
+
+	if (subFieldCount == 0 && !ValidateSchema::isScalarType(innerType->get().kind()))
 	{
 		// https://spec.graphql.org/October2021/#sec-Leaf-Field-Selections
 		auto position = field.begin();
@@ -1840,6 +1990,9 @@ void ValidateExecutableVisitor::visitFragmentSpread(const peg::ast_node& fragmen
 
 	if (_fragmentStack.find(name) != _fragmentStack.end())
 	{
+		// Any fragment which is still being validated depends on the stack, so it isn't reusable.
+		++_cyclicFragmentSpreads;
+
 		if (_fragmentCycles.emplace(name).second)
 		{
 			// https://spec.graphql.org/October2021/#sec-Fragment-spreads-must-not-form-cycles
@@ -1871,17 +2024,129 @@ void ValidateExecutableVisitor::visitFragmentSpread(const peg::ast_node& fragmen
 		return;
 	}
 
+	auto itrValidated = _validatedFragments.find(name);
+
+	if (itrValidated != _validatedFragments.end())
+	{
+		// We already validated this fragment, so we only need to merge the fields again.
+		mergeFragmentFields(*itrValidated->second);
+		return;
+	}
+
+	// Validate the fragment selection set by itself, so the result doesn't depend on the fields
+	// which were already selected at this spread, and then merge the fields into this selection.
 	auto outerType = std::move(_scopedType);
+	auto outerFields = std::move(_selectionFields);
+	const auto outerFieldCount = _fieldCount;
+	const auto outerIntrospectionFieldCount = _introspectionFieldCount;
+	const auto outerCyclicFragmentSpreads = _cyclicFragmentSpreads;
 
 	_fragmentStack.emplace(name);
 	_scopedType = itrInner->second;
+	_selectionFields.clear();
 
 	visitSelection(selection);
 
+	auto fragmentFields = std::make_shared<const ValidateSelectionFields>(std::move(_selectionFields));
+
 	_scopedType = std::move(outerType);
+	_selectionFields = std::move(outerFields);
+	_fieldCount = outerFieldCount;
+	_introspectionFieldCount = outerIntrospectionFieldCount;
 	_fragmentStack.erase(name);
 
 	_referencedFragments.emplace(name);
+
+	if (_cyclicFragmentSpreads == outerCyclicFragmentSpreads)
+	{
+		_validatedFragments.emplace(name, fragmentFields);
+	}
+
+	mergeFragmentFields(*fragmentFields);
+}
+
+void ValidateExecutableVisitor::mergeFragmentFields(const ValidateSelectionFields& fragmentFields)
+{
+	constexpr auto c_introspectionFieldPrefix = R"gql(__)gql"sv;
+
+	for (const auto& [alias, fragmentField] : fragmentFields)
+	{
+		auto itrValidateField = _selectionFields.find(alias);
+
+		if (itrValidateField != _selectionFields.end())
+		{
+			if (*itrValidateField->second == *fragmentField)
+			{
+				// We already validated this field.
+				continue;
+			}
+
+			// https://spec.graphql.org/October2021/#sec-Field-Selection-Merging
+			std::ostringstream message;
+
+			message << "Conflicting field type: " << fragmentField->scopedTypeName
+					<< " name: " << fragmentField->fieldName;
+
+			_errors.push_back({ message.str(), fragmentField->position });
+		}
+		else
+		{
+			_selectionFields.emplace(alias, fragmentField);
+		}
+
+		++_fieldCount;
+
+		if (fragmentField->fieldName.size() >= c_introspectionFieldPrefix.size()
+			&& fragmentField->fieldName.substr(0, c_introspectionFieldPrefix.size())
+				== c_introspectionFieldPrefix)
+		{
+			++_introspectionFieldCount;
+		}
+	}
+}
+
+size_t ValidateExecutableVisitor::getCostMultiplier(
+	const ValidateTypeField& typeField, const ValidateFieldArguments& arguments) const
+{
+	std::optional<size_t> result;
+
+	// If there is more than one pagination argument, e.g. first and last, use the largest one.
+	for (const auto& multiplier : typeField.costMultipliers)
+	{
+		auto value = multiplier.defaultValue;
+		const auto itrArgument = arguments.find(multiplier.argumentName);
+
+		if (itrArgument != arguments.end() && itrArgument->second.value)
+		{
+			const auto& data = itrArgument->second.value->data;
+
+			if (std::holds_alternative<int>(data))
+			{
+				value = static_cast<size_t>(std::max(std::get<int>(data), 0));
+			}
+			else if (std::holds_alternative<ValidateArgumentVariable>(data))
+			{
+				value = _costLimit.variableMultiplier;
+			}
+		}
+
+		result = std::max(result.value_or(0), value);
+	}
+
+	return result.value_or(1);
+}
+
+size_t ValidateExecutableVisitor::getSelectionCost(
+	const ValidateSelectionFields& selectionFields) noexcept
+{
+	size_t result = 0;
+
+	for (const auto& entry : selectionFields)
+	{
+		result = addCost(result, entry.second->cost);
+	}
+
+	return result;
 }
 
 void ValidateExecutableVisitor::visitInlineFragment(const peg::ast_node& inlineFragment)
@@ -1924,13 +2189,14 @@ void ValidateExecutableVisitor::visitInlineFragment(const peg::ast_node& inlineF
 
 		fragmentType = itrInner->second;
 
-		if (isScalarType(fragmentType->get().kind()) || !matchesScopedType(innerType))
+		if (ValidateSchema::isScalarType(fragmentType->get().kind())
+			|| !matchesScopedType(innerType))
 		{
 			// https://spec.graphql.org/October2021/#sec-Fragments-On-Composite-Types
 			// https://spec.graphql.org/October2021/#sec-Fragment-spread-is-possible
 			std::ostringstream message;
 
-			message << (isScalarType(fragmentType->get().kind())
+			message << (ValidateSchema::isScalarType(fragmentType->get().kind())
 					? "Scalar target type on inline fragment name: "
 					: "Incompatible target type on inline fragment name: ")
 					<< innerType;
@@ -2038,6 +2304,17 @@ void ValidateExecutableVisitor::visitDirectives(
 			continue;
 		}
 
+		if (_subscriptionRoot && (directiveName == strDefer || directiveName == strStream))
+		{
+			// https://github.com/graphql/graphql-spec/pull/742
+			auto position = directive->begin();
+			std::ostringstream message;
+
+			message << "Incremental directive on subscription root name: " << directiveName;
+
+			_errors.push_back({ message.str(), { position.line, position.column } });
+		}
+
 		peg::on_first_child<peg::arguments>(*directive,
 			[this, &directive, &directiveName, itrDirective](const peg::ast_node& child) {
 				ValidateFieldArguments validateArguments;
@@ -2129,6 +2406,29 @@ void ValidateExecutableVisitor::visitDirectives(
 						_errors.push_back({ message.str(), { position.line, position.column } });
 					}
 				}
+
+				if (directiveName == strStream)
+				{
+					const auto itrInitialCount = validateArguments.find(strInitialCount);
+
+					if (itrInitialCount != validateArguments.end() && itrInitialCount->second.value)
+					{
+						const auto initialCount =
+							std::get_if<int>(&itrInitialCount->second.value->data);
+
+						if (initialCount && *initialCount < 0)
+						{
+							// https://github.com/graphql/graphql-spec/pull/742
+							std::ostringstream message;
+
+							message << "Negative argument directive: " << directiveName
+									<< " name: " << strInitialCount;
+
+							_errors.push_back(
+								{ message.str(), argumentLocations[strInitialCount] });
+						}
+					}
+				}
 			});
 	}
 }
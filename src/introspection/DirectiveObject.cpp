@@ -31,23 +31,27 @@ Directive::~Directive()
 	// of the implementation type.
 }
 
-service::TypeNames Directive::getTypeNames() const noexcept
+const service::TypeNames& Directive::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__Directive)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Directive::getResolvers() const noexcept
+const service::ResolverMap& Directive::getResolvers() noexcept
 {
-	return {
-		{ R"gql(args)gql"sv, [this](service::ResolverParams&& params) { return resolveArgs(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(locations)gql"sv, [this](service::ResolverParams&& params) { return resolveLocations(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(isRepeatable)gql"sv, [this](service::ResolverParams&& params) { return resolveIsRepeatable(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(args)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolveArgs(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolveName(std::move(params)); } },
+		{ R"gql(locations)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolveLocations(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(isRepeatable)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Directive&>(object).resolveIsRepeatable(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver Directive::resolveName(service::ResolverParams&& params) const
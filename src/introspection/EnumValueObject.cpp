@@ -30,22 +30,26 @@ EnumValue::~EnumValue()
 	// of the implementation type.
 }
 
-service::TypeNames EnumValue::getTypeNames() const noexcept
+const service::TypeNames& EnumValue::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__EnumValue)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap EnumValue::getResolvers() const noexcept
+const service::ResolverMap& EnumValue::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(isDeprecated)gql"sv, [this](service::ResolverParams&& params) { return resolveIsDeprecated(std::move(params)); } },
-		{ R"gql(deprecationReason)gql"sv, [this](service::ResolverParams&& params) { return resolveDeprecationReason(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const EnumValue&>(object).resolveName(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const EnumValue&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const EnumValue&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(isDeprecated)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const EnumValue&>(object).resolveIsDeprecated(std::move(params)); } },
+		{ R"gql(deprecationReason)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const EnumValue&>(object).resolveDeprecationReason(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver EnumValue::resolveName(service::ResolverParams&& params) const
@@ -32,24 +32,28 @@ Field::~Field()
 	// of the implementation type.
 }
 
-service::TypeNames Field::getTypeNames() const noexcept
+const service::TypeNames& Field::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__Field)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Field::getResolvers() const noexcept
+const service::ResolverMap& Field::getResolvers() noexcept
 {
-	return {
-		{ R"gql(args)gql"sv, [this](service::ResolverParams&& params) { return resolveArgs(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(type)gql"sv, [this](service::ResolverParams&& params) { return resolveType(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(isDeprecated)gql"sv, [this](service::ResolverParams&& params) { return resolveIsDeprecated(std::move(params)); } },
-		{ R"gql(deprecationReason)gql"sv, [this](service::ResolverParams&& params) { return resolveDeprecationReason(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(args)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveArgs(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveName(std::move(params)); } },
+		{ R"gql(type)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveType(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(isDeprecated)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveIsDeprecated(std::move(params)); } },
+		{ R"gql(deprecationReason)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Field&>(object).resolveDeprecationReason(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver Field::resolveName(service::ResolverParams&& params) const
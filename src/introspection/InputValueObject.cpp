@@ -31,22 +31,26 @@ InputValue::~InputValue()
 	// of the implementation type.
 }
 
-service::TypeNames InputValue::getTypeNames() const noexcept
+const service::TypeNames& InputValue::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__InputValue)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap InputValue::getResolvers() const noexcept
+const service::ResolverMap& InputValue::getResolvers() noexcept
 {
-	return {
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(type)gql"sv, [this](service::ResolverParams&& params) { return resolveType(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(defaultValue)gql"sv, [this](service::ResolverParams&& params) { return resolveDefaultValue(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const InputValue&>(object).resolveName(std::move(params)); } },
+		{ R"gql(type)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const InputValue&>(object).resolveType(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const InputValue&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const InputValue&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(defaultValue)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const InputValue&>(object).resolveDefaultValue(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver InputValue::resolveName(service::ResolverParams&& params) const
@@ -237,6 +237,20 @@ void AddTypesToSchema(const std::shared_ptr<schema::Schema>& schema)
 	}, {
 		schema::InputValue::Make(R"gql(url)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(String)gql"sv)), R"gql()gql"sv)
 	}, false));
+	schema->AddDirective(schema::Directive::Make(R"gql(defer)gql"sv, R"md()md"sv, {
+		introspection::DirectiveLocation::FRAGMENT_SPREAD,
+		introspection::DirectiveLocation::INLINE_FRAGMENT
+	}, {
+		schema::InputValue::Make(R"gql(if)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Boolean)gql"sv)), R"gql(true)gql"sv),
+		schema::InputValue::Make(R"gql(label)gql"sv, R"md()md"sv, schema->LookupType(R"gql(String)gql"sv), R"gql()gql"sv)
+	}, false));
+	schema->AddDirective(schema::Directive::Make(R"gql(stream)gql"sv, R"md()md"sv, {
+		introspection::DirectiveLocation::FIELD
+	}, {
+		schema::InputValue::Make(R"gql(if)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Boolean)gql"sv)), R"gql(true)gql"sv),
+		schema::InputValue::Make(R"gql(label)gql"sv, R"md()md"sv, schema->LookupType(R"gql(String)gql"sv), R"gql()gql"sv),
+		schema::InputValue::Make(R"gql(initialCount)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)), R"gql(0)gql"sv)
+	}, false));
 }
 
 } // namespace introspection
@@ -32,24 +32,28 @@ Schema::~Schema()
 	// of the implementation type.
 }
 
-service::TypeNames Schema::getTypeNames() const noexcept
+const service::TypeNames& Schema::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__Schema)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Schema::getResolvers() const noexcept
+const service::ResolverMap& Schema::getResolvers() noexcept
 {
-	return {
-		{ R"gql(types)gql"sv, [this](service::ResolverParams&& params) { return resolveTypes(std::move(params)); } },
-		{ R"gql(queryType)gql"sv, [this](service::ResolverParams&& params) { return resolveQueryType(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(directives)gql"sv, [this](service::ResolverParams&& params) { return resolveDirectives(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(mutationType)gql"sv, [this](service::ResolverParams&& params) { return resolveMutationType(std::move(params)); } },
-		{ R"gql(subscriptionType)gql"sv, [this](service::ResolverParams&& params) { return resolveSubscriptionType(std::move(params)); } }
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(types)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveTypes(std::move(params)); } },
+		{ R"gql(queryType)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveQueryType(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(directives)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveDirectives(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(mutationType)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveMutationType(std::move(params)); } },
+		{ R"gql(subscriptionType)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Schema&>(object).resolveSubscriptionType(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver Schema::resolveDescription(service::ResolverParams&& params) const
@@ -34,28 +34,32 @@ Type::~Type()
 	// of the implementation type.
 }
 
-service::TypeNames Type::getTypeNames() const noexcept
+const service::TypeNames& Type::getTypeNames() noexcept
 {
-	return {
+	static const service::TypeNames s_typeNames {
 		R"gql(__Type)gql"sv
 	};
+
+	return s_typeNames;
 }
 
-service::ResolverMap Type::getResolvers() const noexcept
-{
-	return {
-		{ R"gql(kind)gql"sv, [this](service::ResolverParams&& params) { return resolveKind(std::move(params)); } },
-		{ R"gql(name)gql"sv, [this](service::ResolverParams&& params) { return resolveName(std::move(params)); } },
-		{ R"gql(fields)gql"sv, [this](service::ResolverParams&& params) { return resolveFields(std::move(params)); } },
-		{ R"gql(ofType)gql"sv, [this](service::ResolverParams&& params) { return resolveOfType(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
-		{ R"gql(enumValues)gql"sv, [this](service::ResolverParams&& params) { return resolveEnumValues(std::move(params)); } },
-		{ R"gql(interfaces)gql"sv, [this](service::ResolverParams&& params) { return resolveInterfaces(std::move(params)); } },
-		{ R"gql(description)gql"sv, [this](service::ResolverParams&& params) { return resolveDescription(std::move(params)); } },
-		{ R"gql(inputFields)gql"sv, [this](service::ResolverParams&& params) { return resolveInputFields(std::move(params)); } },
-		{ R"gql(possibleTypes)gql"sv, [this](service::ResolverParams&& params) { return resolvePossibleTypes(std::move(params)); } },
-		{ R"gql(specifiedByURL)gql"sv, [this](service::ResolverParams&& params) { return resolveSpecifiedByURL(std::move(params)); } }
+const service::ResolverMap& Type::getResolvers() noexcept
+{
+	static const service::ResolverMap s_resolvers {
+		{ R"gql(kind)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveKind(std::move(params)); } },
+		{ R"gql(name)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveName(std::move(params)); } },
+		{ R"gql(fields)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveFields(std::move(params)); } },
+		{ R"gql(ofType)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveOfType(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolve_typename(std::move(params)); } },
+		{ R"gql(enumValues)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveEnumValues(std::move(params)); } },
+		{ R"gql(interfaces)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveInterfaces(std::move(params)); } },
+		{ R"gql(description)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveDescription(std::move(params)); } },
+		{ R"gql(inputFields)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveInputFields(std::move(params)); } },
+		{ R"gql(possibleTypes)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolvePossibleTypes(std::move(params)); } },
+		{ R"gql(specifiedByURL)gql"sv, [](const service::Object& object, service::ResolverParams&& params) { return static_cast<const Type&>(object).resolveSpecifiedByURL(std::move(params)); } }
 	};
+
+	return s_resolvers;
 }
 
 service::AwaitableResolver Type::resolveKind(service::ResolverParams&& params) const
@@ -8,6 +8,8 @@
 #include "SubscribeClient.h"
 #include "TodayMock.h"
 
+#include "graphqlservice/BinaryResponse.h"
+
 #include <chrono>
 
 using namespace graphql;
@@ -169,6 +171,54 @@ TEST_F(ClientCase, MutateCompleteTask)
 	}
 }
 
+TEST_F(ClientCase, QueryBinaryEncodings)
+{
+	using namespace client::query::Query;
+
+	const auto checkResponse = [](response::Value&& result) {
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		auto serviceResponse = client::parseServiceResponse(std::move(result));
+		const auto response = parseResponse(std::move(serviceResponse.data));
+
+		EXPECT_EQ(size_t { 0 }, serviceResponse.errors.size()) << "no errors expected";
+
+		ASSERT_TRUE(response.appointments.edges.has_value()) << "appointments should be set";
+		ASSERT_EQ(size_t { 1 }, response.appointments.edges->size())
+			<< "appointments should have 1 entry";
+		ASSERT_TRUE((*response.appointments.edges)[0].has_value()) << "edge should be set";
+		const auto& appointmentNode = (*response.appointments.edges)[0]->node;
+		ASSERT_TRUE(appointmentNode.has_value()) << "node should be set";
+		EXPECT_EQ(today::getFakeAppointmentId(), appointmentNode->id)
+			<< "id should match the binary bytes";
+		ASSERT_TRUE(appointmentNode->subject.has_value()) << "subject should be set";
+		EXPECT_EQ("Lunch?", *(appointmentNode->subject)) << "subject should match";
+		EXPECT_EQ(client::query::Query::TaskState::Unassigned, response.testTaskState)
+			<< "testTaskState should match";
+	};
+	const auto resolve = [this]() {
+		auto query = GetRequestObject();
+
+		return _mockService->service
+			->resolve({ query, {}, response::Value { response::Type::Map } })
+			.get();
+	};
+
+	try
+	{
+		const auto cbor = response::toCBOR(resolve());
+
+		checkResponse(response::parseCBOR(cbor));
+
+		const auto msgpack = response::toMessagePack(resolve());
+
+		checkResponse(response::parseMessagePack(msgpack));
+	}
+	catch (const std::logic_error& ex)
+	{
+		FAIL() << ex.what();
+	}
+}
+
 TEST_F(ClientCase, SubscribeNextAppointmentChangeDefault)
 {
 	using namespace client::subscription::TestSubscription;
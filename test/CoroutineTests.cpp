@@ -7,6 +7,10 @@
 
 #include "graphqlservice/JSONResponse.h"
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 using namespace graphql;
 
 using namespace std::literals;
@@ -408,3 +412,308 @@ TEST_F(CoroutineCase, QueryEverythingThreaded)
 		FAIL() << response::toJSON(ex.getErrors());
 	}
 }
+
+TEST_F(CoroutineCase, QueryEverythingPooled)
+{
+	auto query = R"(
+		query Everything {
+			appointments {
+				edges {
+					node {
+						id
+						subject
+						when
+						isNow
+						__typename
+					}
+				}
+			}
+			tasks {
+				edges {
+					node {
+						id
+						title
+						isComplete
+						__typename
+					}
+				}
+			}
+			unreadCounts {
+				edges {
+					node {
+						id
+						name
+						unreadCount
+						__typename
+					}
+				}
+			}
+		})"_graphql;
+	response::Value variables(response::Type::Map);
+	auto state = std::make_shared<today::RequestState>(4);
+	const auto worker = std::make_shared<service::await_worker_pool>(2);
+	auto result = _mockService->service
+					  ->resolve({ query,
+						  "Everything"sv,
+						  std::move(variables),
+						  service::await_async { worker },
+						  state })
+					  .get();
+	worker->shutdown();
+	EXPECT_EQ(size_t { 2 }, worker->size()) << "pool should keep a fixed number of workers";
+	EXPECT_EQ(size_t { 1 }, _mockService->getAppointmentsCount)
+		<< "today service lazy loads the appointments and caches the result";
+	EXPECT_EQ(size_t { 1 }, _mockService->getTasksCount)
+		<< "today service lazy loads the tasks and caches the result";
+	EXPECT_EQ(size_t { 1 }, _mockService->getUnreadCountsCount)
+		<< "today service lazy loads the unreadCounts and caches the result";
+	EXPECT_EQ(size_t { 4 }, state->appointmentsRequestId)
+		<< "today service passed the same RequestState";
+	EXPECT_EQ(size_t { 4 }, state->tasksRequestId) << "today service passed the same RequestState";
+	EXPECT_EQ(size_t { 4 }, state->unreadCountsRequestId)
+		<< "today service passed the same RequestState";
+	EXPECT_EQ(size_t { 1 }, state->loadAppointmentsCount) << "today service called the loader once";
+	EXPECT_EQ(size_t { 1 }, state->loadTasksCount) << "today service called the loader once";
+	EXPECT_EQ(size_t { 1 }, state->loadUnreadCountsCount) << "today service called the loader once";
+
+	try
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		auto errorsItr = result.find("errors");
+		if (errorsItr != result.get<response::MapType>().cend())
+		{
+			FAIL() << response::toJSON(response::Value(errorsItr->second));
+		}
+		const auto data = service::ScalarArgument::require("data", result);
+
+		const auto appointments = service::ScalarArgument::require("appointments", data);
+		const auto appointmentEdges =
+			service::ScalarArgument::require<service::TypeModifier::List>("edges", appointments);
+		ASSERT_EQ(size_t { 1 }, appointmentEdges.size()) << "appointments should have 1 entry";
+		ASSERT_TRUE(appointmentEdges[0].type() == response::Type::Map)
+			<< "appointment should be an object";
+		const auto appointmentNode = service::ScalarArgument::require("node", appointmentEdges[0]);
+		EXPECT_EQ(today::getFakeAppointmentId(),
+			service::IdArgument::require("id", appointmentNode))
+			<< "id should match in base64 encoding";
+		EXPECT_EQ("Lunch?", service::StringArgument::require("subject", appointmentNode))
+			<< "subject should match";
+		EXPECT_EQ("tomorrow", service::StringArgument::require("when", appointmentNode))
+			<< "when should match";
+		EXPECT_FALSE(service::BooleanArgument::require("isNow", appointmentNode))
+			<< "isNow should match";
+		EXPECT_EQ("Appointment", service::StringArgument::require("__typename", appointmentNode))
+			<< "__typename should match";
+
+		const auto tasks = service::ScalarArgument::require("tasks", data);
+		const auto taskEdges =
+			service::ScalarArgument::require<service::TypeModifier::List>("edges", tasks);
+		ASSERT_EQ(size_t { 1 }, taskEdges.size()) << "tasks should have 1 entry";
+		ASSERT_TRUE(taskEdges[0].type() == response::Type::Map) << "task should be an object";
+		const auto taskNode = service::ScalarArgument::require("node", taskEdges[0]);
+		EXPECT_EQ(today::getFakeTaskId(), service::IdArgument::require("id", taskNode))
+			<< "id should match in base64 encoding";
+		EXPECT_EQ("Don't forget", service::StringArgument::require("title", taskNode))
+			<< "title should match";
+		EXPECT_TRUE(service::BooleanArgument::require("isComplete", taskNode))
+			<< "isComplete should match";
+		EXPECT_EQ("Task", service::StringArgument::require("__typename", taskNode))
+			<< "__typename should match";
+
+		const auto unreadCounts = service::ScalarArgument::require("unreadCounts", data);
+		const auto unreadCountEdges =
+			service::ScalarArgument::require<service::TypeModifier::List>("edges", unreadCounts);
+		ASSERT_EQ(size_t { 1 }, unreadCountEdges.size()) << "unreadCounts should have 1 entry";
+		ASSERT_TRUE(unreadCountEdges[0].type() == response::Type::Map)
+			<< "unreadCount should be an object";
+		const auto unreadCountNode = service::ScalarArgument::require("node", unreadCountEdges[0]);
+		EXPECT_EQ(today::getFakeFolderId(), service::IdArgument::require("id", unreadCountNode))
+			<< "id should match in base64 encoding";
+		EXPECT_EQ("\"Fake\" Inbox", service::StringArgument::require("name", unreadCountNode))
+			<< "name should match";
+		EXPECT_EQ(3, service::IntArgument::require("unreadCount", unreadCountNode))
+			<< "unreadCount should match";
+		EXPECT_EQ("Folder", service::StringArgument::require("__typename", unreadCountNode))
+			<< "__typename should match";
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+namespace {
+
+// Switch to the pool, report which thread resumed the coroutine, and optionally wait for the gate
+// before finishing, so the test can keep a worker busy.
+internal::Awaitable<std::thread::id> resumeOnPool(std::shared_ptr<service::await_worker_pool> pool,
+	std::atomic_size_t& completed, std::promise<std::thread::id>* started = nullptr,
+	std::shared_future<void> gate = {})
+{
+	co_await service::await_async { std::move(pool) };
+
+	const auto threadId = std::this_thread::get_id();
+
+	if (started)
+	{
+		started->set_value(threadId);
+	}
+
+	if (gate.valid())
+	{
+		gate.wait();
+	}
+
+	++completed;
+	co_return threadId;
+}
+
+// Give the workers a bounded amount of time to catch up, so a failure does not hang the test.
+bool waitForCount(const std::atomic_size_t& count, size_t expected)
+{
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+
+	while (count < expected && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(1ms);
+	}
+
+	return count >= expected;
+}
+
+} // namespace
+
+TEST(WorkerPoolCase, ResumeInlineWhenQueuesAreFull)
+{
+	const auto pool = std::make_shared<service::await_worker_pool>(1, 2);
+	std::atomic_size_t completed = 0;
+	std::promise<void> gate;
+	std::promise<std::thread::id> started;
+
+	// Keep the only worker busy, and then fill its queue.
+	auto blocked = resumeOnPool(pool, completed, &started, gate.get_future().share());
+	const auto workerId = started.get_future().get();
+	auto queued1 = resumeOnPool(pool, completed);
+	auto queued2 = resumeOnPool(pool, completed);
+
+	// The queue is full, so this one should resume inline on the calling thread.
+	auto overflow = resumeOnPool(pool, completed);
+
+	EXPECT_EQ(std::this_thread::get_id(), overflow.get()) << "should resume inline";
+	EXPECT_EQ(size_t { 1 }, completed.load()) << "should not run the queued coroutines yet";
+
+	gate.set_value();
+
+	EXPECT_EQ(workerId, blocked.get()) << "should run on the worker";
+	EXPECT_EQ(workerId, queued1.get()) << "should run on the worker";
+	EXPECT_EQ(workerId, queued2.get()) << "should run on the worker";
+	EXPECT_NE(std::this_thread::get_id(), workerId) << "worker should be a different thread";
+
+	pool->shutdown();
+}
+
+TEST(WorkerPoolCase, StealFromBusyWorker)
+{
+	constexpr size_t c_queuedCount = 16;
+	const auto pool = std::make_shared<service::await_worker_pool>(2);
+	std::atomic_size_t completed = 0;
+	std::promise<void> gate;
+	std::promise<std::thread::id> started;
+
+	auto blocked = resumeOnPool(pool, completed, &started, gate.get_future().share());
+	const auto blockedId = started.get_future().get();
+	std::vector<internal::Awaitable<std::thread::id>> queued;
+
+	// These are distributed round-robin between both queues, but only the other worker is free to
+	// resume them, so it needs to steal the ones in the busy worker's queue.
+	queued.reserve(c_queuedCount);
+
+	for (size_t i = 0; i < c_queuedCount; ++i)
+	{
+		queued.push_back(resumeOnPool(pool, completed));
+	}
+
+	const bool finished = waitForCount(completed, c_queuedCount);
+
+	gate.set_value();
+
+	EXPECT_TRUE(finished) << "should finish while one of the workers is busy";
+
+	for (auto& awaitable : queued)
+	{
+		const auto threadId = awaitable.get();
+
+		EXPECT_NE(blockedId, threadId) << "should run on the other worker";
+		EXPECT_NE(std::this_thread::get_id(), threadId) << "should not resume inline";
+	}
+
+	EXPECT_EQ(blockedId, blocked.get()) << "should finish on the same worker";
+
+	pool->shutdown();
+}
+
+TEST(WorkerPoolCase, DrainAndShutdownWithPendingWork)
+{
+	constexpr size_t c_queuedCount = 4;
+	const auto pool = std::make_shared<service::await_worker_pool>(1);
+	std::atomic_size_t completed = 0;
+	std::promise<void> drainGate;
+	std::promise<std::thread::id> drainStarted;
+	std::vector<internal::Awaitable<std::thread::id>> awaitables;
+
+	awaitables.push_back(
+		resumeOnPool(pool, completed, &drainStarted, drainGate.get_future().share()));
+	drainStarted.get_future().wait();
+
+	for (size_t i = 0; i < c_queuedCount; ++i)
+	{
+		awaitables.push_back(resumeOnPool(pool, completed));
+	}
+
+	std::atomic_bool drained = false;
+	std::thread drainThread([&pool, &drained]() {
+		pool->drain();
+		drained = true;
+	});
+
+	std::this_thread::sleep_for(50ms);
+	EXPECT_FALSE(drained) << "drain should wait for the busy worker";
+
+	drainGate.set_value();
+	drainThread.join();
+
+	EXPECT_TRUE(drained) << "drain should return once the pool is idle";
+	EXPECT_EQ(c_queuedCount + 1, completed.load()) << "drain should resume every coroutine";
+
+	std::promise<void> shutdownGate;
+	std::promise<std::thread::id> shutdownStarted;
+
+	awaitables.push_back(
+		resumeOnPool(pool, completed, &shutdownStarted, shutdownGate.get_future().share()));
+	shutdownStarted.get_future().wait();
+
+	for (size_t i = 0; i < c_queuedCount; ++i)
+	{
+		awaitables.push_back(resumeOnPool(pool, completed));
+	}
+
+	std::thread shutdownThread([&pool]() {
+		pool->shutdown();
+	});
+
+	shutdownGate.set_value();
+	shutdownThread.join();
+
+	EXPECT_EQ(2 * (c_queuedCount + 1), completed.load())
+		<< "shutdown should resume the pending coroutines before joining the workers";
+
+	for (auto& awaitable : awaitables)
+	{
+		EXPECT_NE(std::this_thread::get_id(), awaitable.get()) << "should run on the worker";
+	}
+
+	auto afterShutdown = resumeOnPool(pool, completed);
+
+	EXPECT_EQ(std::this_thread::get_id(), afterShutdown.get())
+		<< "should resume inline after shutdown";
+}
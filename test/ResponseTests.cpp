@@ -3,10 +3,17 @@
 
 #include <gtest/gtest.h>
 
+#include "graphqlservice/BinaryResponse.h"
 #include "graphqlservice/GraphQLResponse.h"
+#include "graphqlservice/GraphQLService.h"
+#include "graphqlservice/JSONResponse.h"
+
+#include <limits>
 
 using namespace graphql;
 
+using namespace std::literals;
+
 TEST(ResponseCase, ValueConstructorFromStringLiteral)
 {
 	auto expected = "Test String";
@@ -33,3 +40,360 @@ TEST(ResponseCase, IdTypeCompareEqual)
 	EXPECT_TRUE(fakeId == response::IdType { "ZmFrZUlk" })
 		<< "actual string should compare as equal";
 }
+
+TEST(ResponseCase, WideMapMemberLookup)
+{
+	constexpr size_t memberCount = 200;
+	response::Value wide(response::Type::Map);
+
+	for (size_t i = 0; i < memberCount; ++i)
+	{
+		ASSERT_TRUE(wide.emplace_back("field" + std::to_string(i), response::Value(int(i))));
+	}
+
+	ASSERT_FALSE(wide.emplace_back("field100", response::Value(0)))
+		<< "duplicate members should be rejected";
+	ASSERT_EQ(memberCount, wide.size());
+	EXPECT_EQ(response::Value(150), wide["field150"]);
+	EXPECT_TRUE(wide.find("field200") == wide.end()) << "missing member should not be found";
+
+	const auto copy = response::Value { wide };
+
+	EXPECT_EQ(response::Value(199), copy["field199"]) << "copy should rebuild the index";
+	EXPECT_EQ(0, wide.begin()->second.get<int>()) << "members keep insertion order";
+}
+
+response::Value buildBinaryTestValue()
+{
+	response::Value value(response::Type::Map);
+	response::Value ints(response::Type::List);
+
+	for (const auto i : { 0, 23, 24, 127, 128, 255, 256, 65536, -1, -24, -25, -32, -33, -129,
+			 -32769, std::numeric_limits<int>::max(), std::numeric_limits<int>::min() })
+	{
+		ints.emplace_back(response::Value(i));
+	}
+
+	[[maybe_unused]] auto added = value.emplace_back("ints", std::move(ints));
+	added = value.emplace_back("float", response::Value(0.1));
+	added = value.emplace_back("bool", response::Value(true));
+	added = value.emplace_back("null", response::Value());
+	added = value.emplace_back("long string", response::Value(std::string(300, 'x')));
+	added = value.emplace_back("id", response::Value(response::IdType { 0, 1, 2, 0xFF }));
+
+	return value;
+}
+
+TEST(ResponseCase, BinaryEncodingsRoundTrip)
+{
+	const auto expected = buildBinaryTestValue();
+	const auto cbor = response::toCBOR(buildBinaryTestValue());
+	const auto msgpack = response::toMessagePack(buildBinaryTestValue());
+
+	for (const auto& actual : { response::parseCBOR(cbor), response::parseMessagePack(msgpack) })
+	{
+		ASSERT_TRUE(actual.type() == response::Type::Map);
+		EXPECT_EQ(expected["ints"], actual["ints"]) << "ints should round trip";
+		EXPECT_EQ(expected["float"], actual["float"]) << "float should round trip";
+		EXPECT_EQ(expected["bool"], actual["bool"]) << "bool should round trip";
+		EXPECT_EQ(expected["null"], actual["null"]) << "null should round trip";
+		EXPECT_EQ(std::string(300, 'x'), actual["long string"].get<std::string>())
+			<< "string should round trip";
+		ASSERT_TRUE(actual["id"].type() == response::Type::ID) << "id should stay binary";
+		EXPECT_EQ(expected["id"].get<response::IdType>(), actual["id"].get<response::IdType>())
+			<< "id bytes should round trip";
+	}
+
+	EXPECT_EQ(response::BinaryData({ 0xA1, 0x61, 'a', 0x01 }),
+		response::toCBOR(response::parseMessagePack({ 0x81, 0xA1, 'a', 0x01 })))
+		<< "small maps should use the shortest header";
+}
+
+TEST(ResponseCase, ParseIndefiniteLengthCBOR)
+{
+	// {_ "a": [_ 1, 2], "b": (_ h'01' h'02'), "c": 1.0 as a half precision float }
+	const auto actual = response::parseCBOR({ 0xBF,
+		0x61,
+		'a',
+		0x9F,
+		0x01,
+		0x02,
+		0xFF,
+		0x61,
+		'b',
+		0x5F,
+		0x41,
+		0x01,
+		0x41,
+		0x02,
+		0xFF,
+		0x61,
+		'c',
+		0xF9,
+		0x3C,
+		0x00,
+		0xFF });
+
+	ASSERT_TRUE(actual.type() == response::Type::Map);
+	EXPECT_EQ(size_t { 2 }, actual["a"].size()) << "list should have 2 elements";
+	EXPECT_EQ(response::IdType({ 1, 2 }), actual["b"].get<response::IdType>())
+		<< "byte string chunks should be concatenated";
+	EXPECT_EQ(1.0, actual["c"].get<double>()) << "half precision float should be decoded";
+	EXPECT_THROW(static_cast<void>(response::parseCBOR({ 0x82, 0x01 })), std::runtime_error)
+		<< "truncated input should throw";
+	EXPECT_THROW(static_cast<void>(response::parseMessagePack({ 0xC0, 0xC0 })), std::runtime_error)
+		<< "trailing input should throw";
+}
+
+TEST(ResponseCase, ParseTaggedCBOR)
+{
+	// 6(6(1)), then a run of 10 million tags before a null
+	response::BinaryData longRun(10'000'000, 0xC6);
+
+	longRun.push_back(0xF6);
+
+	EXPECT_EQ(response::Value { 1 }, response::parseCBOR({ 0xC6, 0xC6, 0x01 }))
+		<< "tags should be skipped";
+	EXPECT_TRUE(response::parseCBOR(longRun).type() == response::Type::Null)
+		<< "a long run of tags should not overflow the stack";
+	EXPECT_THROW(static_cast<void>(response::parseCBOR({ 0xC6, 0xC6 })), std::runtime_error)
+		<< "a tag without a value should throw";
+	EXPECT_THROW(static_cast<void>(response::parseCBOR({ 0xDF, 0x01 })), std::runtime_error)
+		<< "an indefinite length tag should throw";
+}
+
+TEST(ValueWriterCase, WriteSiblingsInOrder)
+{
+	std::string result;
+	auto output = response::makeJSONWriter([&result](std::string_view chunk) {
+		result.append(chunk);
+	});
+	service::ValueWriter list;
+	service::ValueWriter first;
+	service::ValueWriter second;
+
+	list.attach(output);
+	list.start_array();
+
+	// The second item is ready first, so it is buffered until the first item has been written.
+	second.start_object();
+	second.add_member("id");
+	second.write(response::Value(2));
+	second.end_object();
+
+	first.attach(list);
+	first.start_object();
+	first.add_member("id");
+	first.write(response::Value(1));
+	first.end_object();
+	first.finish({});
+
+	second.attach(list);
+	second.finish({});
+
+	list.end_array();
+	list.finish({});
+
+	EXPECT_EQ(R"js([{"id":1},{"id":2}])js", result);
+}
+
+TEST(ValueWriterCase, WriteReturnedValue)
+{
+	std::string result;
+	auto output = response::makeJSONWriter([&result](std::string_view chunk) {
+		result.append(chunk);
+	});
+	service::ValueWriter object;
+	service::ValueWriter field;
+
+	object.attach(output);
+	object.start_object();
+	object.add_member("field");
+
+	// Nothing was written to the field, so finish writes the value the resolver returned.
+	field.attach(object);
+	field.finish(response::Value(std::string { "value" }));
+
+	object.end_object();
+	object.finish({});
+
+	EXPECT_EQ(R"js({"field":"value"})js", result);
+}
+
+TEST(ValueWriterCase, CloseOpenValues)
+{
+	std::string result;
+	auto output = response::makeJSONWriter([&result](std::string_view chunk) {
+		result.append(chunk);
+	});
+	service::ValueWriter document;
+	service::ValueWriter data;
+
+	document.attach(output);
+	document.start_object();
+	document.add_member("data");
+
+	data.attach(document);
+	data.start_object();
+	data.add_member("list");
+	data.start_array();
+	data.write(response::Value(1));
+	data.start_object();
+	data.add_member("field");
+
+	// The data failed part way through, so the member gets a null value, and the open map, list,
+	// and map are closed. Anything written after that is ignored.
+	data.finish({});
+	data.write(response::Value(2));
+
+	document.add_member("errors");
+	document.write(response::Value(response::Type::List));
+	document.end_object();
+	document.finish({});
+
+	EXPECT_EQ(R"js({"data":{"list":[1,{"field":null}]},"errors":[]})js", result);
+}
+
+TEST(JSONResponseCase, ToJSONMatchesJSONWriter)
+{
+	const auto buildValue = []() {
+		response::Value value(response::Type::Map);
+		response::Value list(response::Type::List);
+
+		list.emplace_back(response::Value());
+		list.emplace_back(response::Value(-17));
+		list.emplace_back(response::Value(0.25));
+		list.emplace_back(response::Value(1e30));
+		list.emplace_back(response::Value(response::IdType { 0, 1, 2, 3 }));
+		list.emplace_back(response::Value(std::string { "\b\f\n\r\t\x01\x1F/" }));
+		[[maybe_unused]] auto added = value.emplace_back("quoted \"key\\", std::move(list));
+		added = value.emplace_back("nested", response::Value(response::Type::Map));
+		added = value.emplace_back("enabled", response::Value(true));
+		added = value.emplace_back("unicode", response::Value(std::string { "\xC3\xA9" }));
+
+		return value;
+	};
+	std::string expected;
+	auto writer = response::makeJSONWriter([&expected](std::string_view chunk) {
+		expected.append(chunk);
+	});
+
+	writer.write(buildValue());
+
+	EXPECT_EQ(expected, response::toJSON(buildValue()))
+		<< "toJSON should match the response::Writer output";
+
+	std::string appended { "prefix:" };
+
+	response::toJSON(buildValue(), appended);
+
+	EXPECT_EQ("prefix:" + expected, appended) << "toJSON should append to the buffer";
+}
+
+TEST(JSONResponseCase, ParseJSONEmbeddedNull)
+{
+	const auto parsed = response::parseJSON(R"js({"key\u0000suffix":"value\u0000suffix"})js");
+
+	ASSERT_TRUE(parsed.type() == response::Type::Map);
+	ASSERT_EQ(size_t { 1 }, parsed.size());
+	EXPECT_EQ("key\0suffix"s, parsed.begin()->first) << "keys should keep the embedded null";
+	EXPECT_EQ("value\0suffix"s, parsed.begin()->second.get<std::string>())
+		<< "strings should keep the embedded null";
+}
+
+TEST(JSONResponseCase, ParseJSONValues)
+{
+	const std::string json { R"js({
+		"string": "line 1\nline 2 \"quoted\" \u00e9",
+		"int": -2147483648,
+		"bigint": 2147483648,
+		"float": 1.5e3,
+		"list": [ true, false, null, [], {} ],
+		"duplicate": 1,
+		"duplicate": 2
+	})js" };
+
+	// The result should be the same whether or not graphqljson is built with GRAPHQL_USE_SIMDJSON.
+	const auto parsed = response::parseJSON(json);
+
+	ASSERT_TRUE(parsed.type() == response::Type::Map);
+	EXPECT_EQ(size_t { 6 }, parsed.size()) << "should ignore duplicate members";
+	EXPECT_EQ("line 1\nline 2 \"quoted\" \xC3\xA9"s, parsed["string"].get<std::string>())
+		<< "should unescape strings";
+	EXPECT_EQ(std::numeric_limits<int>::min(), parsed["int"].get<int>());
+	ASSERT_TRUE(parsed["bigint"].type() == response::Type::Float)
+		<< "should convert integers which do not fit in an Int to a Float";
+	EXPECT_EQ(2147483648.0, parsed["bigint"].get<double>());
+	EXPECT_EQ(1500.0, parsed["float"].get<double>());
+	EXPECT_EQ(1, parsed["duplicate"].get<int>()) << "should keep the first member";
+
+	const auto& list = parsed["list"];
+
+	ASSERT_TRUE(list.type() == response::Type::List);
+	ASSERT_EQ(size_t { 5 }, list.size());
+	EXPECT_TRUE(list[0].get<bool>());
+	EXPECT_FALSE(list[1].get<bool>());
+	EXPECT_TRUE(list[2].type() == response::Type::Null);
+	EXPECT_TRUE(list[3].type() == response::Type::List && list[3].size() == 0);
+	EXPECT_TRUE(list[4].type() == response::Type::Map && list[4].size() == 0);
+}
+
+TEST(ResultCase, ConvertBuiltinScalarLists)
+{
+	auto query = R"(query { values })"_graphql;
+	const std::shared_ptr<service::RequestState> state;
+	const service::Directives operationDirectives;
+	const service::SelectionSetParams selectionSetParams {
+		service::ResolverContext::Query,
+		state,
+		operationDirectives,
+		std::make_shared<service::FragmentDefinitionDirectiveStack>(),
+		std::make_shared<service::FragmentSpreadDirectiveStack>(),
+		std::make_shared<service::FragmentSpreadDirectiveStack>(),
+		std::nullopt,
+	};
+	const service::FragmentMap fragments;
+	const response::Value variables { response::Type::Map };
+	const auto makeParams = [&]() {
+		return service::ResolverParams { selectionSetParams,
+			*query.root,
+			"values"s,
+			response::Value { response::Type::Map },
+			{},
+			nullptr,
+			fragments,
+			variables };
+	};
+
+	auto intsResult = service::IntResult::convert<service::TypeModifier::List>(
+		std::vector<int> { 1, 2, 3 },
+		makeParams());
+	auto flagsResult = service::BooleanResult::convert<service::TypeModifier::List>(
+		std::vector<bool> { true, false },
+		makeParams());
+	auto stringsResult = service::StringResult::convert<service::TypeModifier::List,
+		service::TypeModifier::Nullable>(
+		std::vector<std::optional<std::string>> { "first"s, std::nullopt },
+		makeParams());
+	auto ints = intsResult.get();
+	auto flags = flagsResult.get();
+	auto strings = stringsResult.get();
+
+	response::Value expectedInts { response::Type::List };
+	response::Value expectedFlags { response::Type::List };
+	response::Value expectedStrings { response::Type::List };
+
+	expectedInts.emplace_back(response::Value { 1 });
+	expectedInts.emplace_back(response::Value { 2 });
+	expectedInts.emplace_back(response::Value { 3 });
+	expectedFlags.emplace_back(response::Value { true });
+	expectedFlags.emplace_back(response::Value { false });
+	expectedStrings.emplace_back(response::Value { "first"s });
+	expectedStrings.emplace_back(response::Value {});
+
+	EXPECT_TRUE(ints.errors.empty() && flags.errors.empty() && strings.errors.empty())
+		<< "no errors expected";
+	EXPECT_EQ(expectedInts, ints.data) << "ints should match";
+	EXPECT_EQ(expectedFlags, flags.data) << "booleans should match";
+	EXPECT_EQ(expectedStrings, strings.data) << "nullable strings should match";
+}
@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+
+#include "TodayMock.h"
+
+#include "graphqlservice/JSONResponse.h"
+
+using namespace graphql;
+
+using namespace std::literals;
+
+namespace {
+
+struct BatchRequestState : service::RequestState
+{
+	explicit BatchRequestState(bool cache, bool fail = false)
+		: subjects { *this,
+			[this, fail](std::vector<response::IdType>&& ids) {
+				std::vector<std::optional<std::string>> result;
+
+				batches.push_back(ids.size());
+
+				if (fail)
+				{
+					throw std::runtime_error("subjects are unavailable");
+				}
+
+				result.reserve(ids.size());
+
+				for (const auto& id : ids)
+				{
+					result.push_back("Subject " + id.get<response::IdType::OpaqueString>());
+				}
+
+				return result;
+			},
+			cache }
+	{
+	}
+
+	std::vector<size_t> batches;
+	service::BatchLoader<response::IdType, std::optional<std::string>> subjects;
+};
+
+class BatchAppointment
+{
+public:
+	explicit BatchAppointment(response::IdType&& id)
+		: _id { std::move(id) }
+	{
+	}
+
+	const response::IdType& getId() const noexcept
+	{
+		return _id;
+	}
+
+	service::AwaitableScalar<std::optional<std::string>> getSubject(
+		service::FieldParams&& params) const
+	{
+		auto state = std::static_pointer_cast<BatchRequestState>(params.state);
+
+		co_return co_await state->subjects.load(response::IdType { _id });
+	}
+
+private:
+	response::IdType _id;
+};
+
+class BatchQuery
+{
+public:
+	std::vector<std::shared_ptr<today::object::Appointment>> getAppointmentsById(
+		std::vector<response::IdType>&& ids) const
+	{
+		std::vector<std::shared_ptr<today::object::Appointment>> result;
+
+		result.reserve(ids.size());
+
+		for (auto& id : ids)
+		{
+			result.push_back(std::make_shared<today::object::Appointment>(
+				std::make_shared<BatchAppointment>(std::move(id))));
+		}
+
+		return result;
+	}
+};
+
+std::shared_ptr<today::Operations> makeBatchService()
+{
+	return std::make_shared<today::Operations>(std::make_shared<BatchQuery>(),
+		std::make_shared<today::Mutation>(
+			[](today::CompleteTaskInput&&) -> std::shared_ptr<today::CompleteTaskPayload> {
+				return {};
+			}));
+}
+
+} // namespace
+
+TEST(BatchLoaderCase, LoadSiblingsInOneBatch)
+{
+	auto query = R"(query {
+			first: appointmentsById(ids: ["1", "2", "1"]) {
+				subject
+			}
+			second: appointmentsById(ids: ["3", "2"]) {
+				subject
+			}
+		})"_graphql;
+	const auto service = makeBatchService();
+	const auto state = std::make_shared<BatchRequestState>(true);
+	auto result = service->resolve({ query, {}, {}, {}, state }).get();
+
+	try
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		auto errorsItr = result.find("errors");
+		if (errorsItr != result.get<response::MapType>().cend())
+		{
+			FAIL() << response::toJSON(response::Value(errorsItr->second));
+		}
+		EXPECT_EQ(
+			R"js({"data":{"first":[{"subject":"Subject 1"},{"subject":"Subject 2"},{"subject":"Subject 1"}],"second":[{"subject":"Subject 3"},{"subject":"Subject 2"}]}})js",
+			response::toJSON(std::move(result)))
+			<< "every item should get the value for its own key";
+		EXPECT_EQ(std::vector<size_t> { 3 }, state->batches)
+			<< "siblings in both lists should load the distinct keys in one batch";
+
+		result = service->resolve({ query, {}, {}, {}, state }).get();
+
+		EXPECT_EQ(std::vector<size_t> { 3 }, state->batches)
+			<< "cached keys should not be loaded again in the same request state";
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST(BatchLoaderCase, BatchErrorWithoutCache)
+{
+	auto query = R"(query {
+			appointmentsById(ids: ["1", "2"]) {
+				subject
+			}
+		})"_graphql;
+	const auto service = makeBatchService();
+	const auto state = std::make_shared<BatchRequestState>(false, true);
+	auto result = service->resolve({ query, {}, {}, {}, state }).get();
+
+	try
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		const auto errors = service::ScalarArgument::require<service::TypeModifier::List>("errors",
+			result);
+		EXPECT_EQ(size_t { 2 }, errors.size()) << "each item should report the batch error";
+		EXPECT_EQ(std::vector<size_t> { 2 }, state->batches)
+			<< "both keys should be loaded in one batch";
+
+		result = service->resolve({ query, {}, {}, {}, state }).get();
+
+		EXPECT_EQ((std::vector<size_t> { 2, 2 }), state->batches)
+			<< "without the cache, the keys should be loaded again";
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST(DocumentCacheCase, EvictLeastRecentlyUsed)
+{
+	service::DocumentCache cache { 2, 1 };
+	const auto makeDocument = [](std::string_view query) {
+		return std::make_shared<const peg::ast>(peg::parseString(query));
+	};
+
+	const auto a = cache.insert("{ a }"sv, makeDocument("{ a }"sv));
+	const auto b = cache.insert("{ b }"sv, makeDocument("{ b }"sv));
+
+	bool sameText = true;
+
+	EXPECT_EQ(a, cache.find("{a}"sv, &sameText)) << "whitespace should not affect the key";
+	EXPECT_FALSE(sameText) << "the cached document was parsed from different text";
+	EXPECT_EQ(a, cache.insert("{ a }"sv, makeDocument("{ a }"sv)))
+		<< "inserting the same query again should return the existing document";
+
+	const auto c = cache.insert("{ c }"sv, makeDocument("{ c }"sv));
+
+	EXPECT_EQ(nullptr, cache.find("{ b }"sv)) << "least recently used document should be evicted";
+	EXPECT_EQ(c, cache.find("{ c }"sv, &sameText));
+	EXPECT_TRUE(sameText) << "the cached document was parsed from the same text";
+
+	const auto statistics = cache.getStatistics();
+
+	EXPECT_EQ(size_t { 2 }, statistics.hits);
+	EXPECT_EQ(size_t { 1 }, statistics.misses);
+	EXPECT_EQ(size_t { 1 }, statistics.evictions);
+	EXPECT_EQ(size_t { 2 }, statistics.size);
+}
+
+TEST(DocumentCacheCase, NormalizeIgnoredTokens)
+{
+	EXPECT_EQ(R"(query{a b s(x:"a,  b # c")t(y:""" x,
+  y """)})",
+		service::DocumentCache::normalize(R"(  query  {
+			a, b # comment
+			s(x: "a,  b # c")
+			t(y: """ x,
+  y """)
+		}
+)"sv))
+		<< "ignored tokens outside of strings should only leave a space between names";
+}
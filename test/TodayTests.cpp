@@ -7,7 +7,18 @@
 
 #include "graphqlservice/JSONResponse.h"
 
+#include "graphqlservice/internal/Sha256.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 using namespace graphql;
 
@@ -1775,6 +1786,346 @@ TEST_F(TodayServiceCase, SubscribeNextAppointmentChangeAsync)
 	}
 }
 
+TEST_F(TodayServiceCase, DeliverNodeChangeIndexedArguments)
+{
+	auto subscriptionObject =
+		std::make_shared<today::object::Subscription>(std::make_shared<today::NodeChange>(
+			[](service::ResolverContext,
+				const std::shared_ptr<service::RequestState>&,
+				response::IdType&& idArg) -> std::shared_ptr<today::object::Node> {
+				return std::make_shared<today::object::Node>(std::make_shared<today::object::Task>(
+					std::make_shared<today::Task>(std::move(idArg), "Don't forget", true)));
+			}));
+	std::vector<std::string> delivered;
+	std::vector<service::SubscriptionKey> keys;
+
+	_mockService->service->indexSubscriptionArguments("nodeChange"sv, { "id"s });
+
+	for (const auto& id : { "ZmFrZVRhc2tJZA=="s, "b3RoZXJJZA=="s, "ZmFrZVRhc2tJZA=="s })
+	{
+		auto query = peg::parseString(R"(subscription TestSubscription($id: ID!) {
+				changedNode: nodeChange(id: $id) {
+					changedId: id
+				}
+			})");
+		response::Value variables(response::Type::Map);
+
+		variables.emplace_back("id", response::Value(std::string { id }).from_input());
+		keys.push_back(_mockService->service
+						   ->subscribe({ [&delivered, id](response::Value&&) {
+											delivered.push_back(id);
+										},
+							   std::move(query),
+							   "TestSubscription"s,
+							   std::move(variables),
+							   {},
+							   {},
+							   subscriptionObject })
+						   .get());
+	}
+
+	_mockService->service
+		->deliver({ "nodeChange"sv,
+			{ service::SubscriptionFilter { { service::SubscriptionArguments {
+				{ "id", response::Value("ZmFrZVRhc2tJZA=="s).from_input() } } } } },
+			{}, // launch
+			subscriptionObject })
+		.get();
+
+	EXPECT_EQ((std::vector { "ZmFrZVRhc2tJZA=="s, "ZmFrZVRhc2tJZA=="s }), delivered)
+		<< "should only deliver to the subscriptions with a matching id";
+
+	_mockService->service->unsubscribe({ keys[0], {}, subscriptionObject }).get();
+	delivered.clear();
+	_mockService->service
+		->deliver({ "nodeChange"sv,
+			{ service::SubscriptionFilter { { service::SubscriptionArguments {
+				{ "id", response::Value("b3RoZXJJZA=="s).from_input() } } } } },
+			{}, // launch
+			subscriptionObject })
+		.get();
+
+	EXPECT_EQ((std::vector { "b3RoZXJJZA=="s }), delivered)
+		<< "should deliver to the other subscription";
+
+	for (size_t i = 1; i < keys.size(); ++i)
+	{
+		_mockService->service->unsubscribe({ keys[i], {}, subscriptionObject }).get();
+	}
+}
+
+TEST_F(TodayServiceCase, DeliverNextAppointmentChangeConcurrently)
+{
+	constexpr size_t c_subscriptionCount = 32;
+	std::mutex callbackMutex;
+	std::vector<size_t> delivered;
+	std::vector<service::SubscriptionKey> keys;
+
+	keys.reserve(c_subscriptionCount);
+
+	for (size_t i = 0; i < c_subscriptionCount; ++i)
+	{
+		auto callback = [i, &callbackMutex, &delivered](response::Value&& response) {
+			const std::lock_guard lock { callbackMutex };
+
+			EXPECT_EQ(response.find("errors"), response.get<response::MapType>().cend())
+				<< "should not have any errors";
+			delivered.push_back(i);
+		};
+		auto query = peg::parseString(R"(subscription {
+				nextAppointmentChange {
+					id
+				}
+			})");
+		auto state = std::make_shared<today::RequestState>(i);
+
+		keys.push_back(_mockService->service
+						   ->subscribe({ std::move(callback),
+							   std::move(query),
+							   {},
+							   response::Value(response::Type::Map),
+							   {},
+							   state })
+						   .get());
+	}
+
+	_mockService->service
+		->deliver({ "nextAppointmentChange"sv,
+			{}, // filter
+			std::launch::async,
+			{}, // subscriptionObject
+			4,
+			service::DeliverOrder::Registration })
+		.get();
+
+	std::vector<size_t> expected(c_subscriptionCount);
+
+	std::iota(expected.begin(), expected.end(), size_t { 0 });
+	EXPECT_EQ(expected, delivered) << "should invoke the callbacks in registration order";
+
+	delivered.clear();
+	_mockService->service
+		->deliver({ "nextAppointmentChange"sv,
+			{}, // filter
+			std::launch::async,
+			{}, // subscriptionObject
+			0,
+			service::DeliverOrder::Completion })
+		.get();
+
+	std::sort(delivered.begin(), delivered.end());
+	EXPECT_EQ(expected, delivered) << "should invoke every callback once";
+
+	for (auto key : keys)
+	{
+		_mockService->service->unsubscribe({ key }).get();
+	}
+}
+
+TEST_F(TodayServiceCase, DeliverNextAppointmentChangeDeduplicated)
+{
+	auto sharedState = std::make_shared<today::RequestState>(23);
+	auto otherState = std::make_shared<today::RequestState>(24);
+	constexpr auto queryText = R"(subscription TestSubscription {
+			nextAppointment: nextAppointmentChange {
+				nextAppointmentId: id
+				subject
+			}
+		})"sv;
+	constexpr auto reformattedText = R"(# Only the ignored tokens are different
+		subscription TestSubscription { nextAppointment : nextAppointmentChange {
+			nextAppointmentId : id, subject } })"sv;
+	std::vector<response::Value> results;
+	std::vector<size_t> order;
+	std::vector<service::SubscriptionKey> keys;
+
+	for (const auto& [state, text] : std::initializer_list<
+			 std::pair<std::shared_ptr<today::RequestState>, std::string_view>> {
+			 { sharedState, queryText },
+			 { sharedState, queryText },
+			 { otherState, queryText },
+			 { sharedState, reformattedText },
+		 })
+	{
+		auto query = peg::parseString(text);
+
+		keys.push_back(_mockService->service
+						   ->subscribe({ [&results, &order, index = keys.size()](
+											 response::Value&& response) {
+											results.push_back(std::move(response));
+											order.push_back(index);
+										},
+							   std::move(query),
+							   "TestSubscription"s,
+							   response::Value(response::Type::Map),
+							   {},
+							   state })
+						   .get());
+	}
+
+	const auto subscriptionBegin =
+		today::NextAppointmentChange::getCount(service::ResolverContext::Subscription);
+
+	_mockService->service
+		->deliver({ "nextAppointmentChange"sv,
+			{}, // filter
+			{}, // launch
+			{}, // subscriptionObject
+			1,
+			service::DeliverOrder::Registration,
+			true })
+		.get();
+
+	const auto subscriptionEnd =
+		today::NextAppointmentChange::getCount(service::ResolverContext::Subscription);
+
+	for (auto key : keys)
+	{
+		_mockService->service->unsubscribe({ key }).get();
+	}
+
+	EXPECT_EQ(subscriptionBegin + 2, subscriptionEnd)
+		<< "should resolve once for each RequestState";
+	ASSERT_EQ(size_t { 4 }, results.size()) << "should invoke every callback";
+	EXPECT_EQ((std::vector<size_t> { 0, 1, 3, 2 }), order)
+		<< "should invoke the callbacks in the order of the groups";
+
+	for (const auto& result : results)
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		EXPECT_EQ(result.find("errors"), result.get<response::MapType>().cend())
+			<< "should not have any errors";
+
+		const auto data = service::ScalarArgument::require("data", result);
+		const auto appointmentNode = service::ScalarArgument::require("nextAppointment", data);
+
+		EXPECT_EQ("Lunch?", service::StringArgument::require("subject", appointmentNode))
+			<< "subject should match";
+	}
+}
+
+TEST_F(TodayServiceCase, SubscribeSharedDocument)
+{
+	auto query = peg::parseString(R"(subscription TestSubscription($withSubject: Boolean!) {
+			nextAppointment: nextAppointmentChange {
+				...AppointmentFragment
+			}
+		}
+
+		fragment AppointmentFragment on Appointment {
+			nextAppointmentId: id
+			subject @include(if: $withSubject)
+		})");
+	const auto document = std::make_shared<const peg::ast>(std::move(query));
+	std::vector<response::Value> results;
+	std::vector<service::SubscriptionKey> keys;
+
+	for (const bool withSubject : { true, false })
+	{
+		response::Value variables(response::Type::Map);
+
+		variables.emplace_back("withSubject", response::Value(withSubject));
+		keys.push_back(_mockService->service
+						   ->subscribe({ [&results](response::Value&& response) {
+											results.push_back(std::move(response));
+										},
+							   {}, // query
+							   "TestSubscription"s,
+							   std::move(variables),
+							   {}, // launch
+							   {}, // state
+							   {}, // subscriptionObject
+							   document })
+						   .get());
+	}
+
+	_mockService->service->deliver({ "nextAppointmentChange"sv }).get();
+
+	for (auto key : keys)
+	{
+		_mockService->service->unsubscribe({ key }).get();
+	}
+
+	ASSERT_EQ(size_t { 2 }, results.size()) << "should invoke both callbacks";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const auto& result = results[i];
+
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		EXPECT_EQ(result.find("errors"), result.get<response::MapType>().cend())
+			<< "should not have any errors";
+
+		const auto data = service::ScalarArgument::require("data", result);
+		const auto appointmentNode = service::ScalarArgument::require("nextAppointment", data);
+
+		EXPECT_EQ(today::getFakeAppointmentId(),
+			service::IdArgument::require("nextAppointmentId", appointmentNode))
+			<< "id should match";
+
+		if (i == 0)
+		{
+			EXPECT_EQ("Lunch?", service::StringArgument::require("subject", appointmentNode))
+				<< "subject should match";
+		}
+		else
+		{
+			EXPECT_EQ(appointmentNode.find("subject"),
+				appointmentNode.get<response::MapType>().cend())
+				<< "should skip the subject for the second subscription";
+		}
+	}
+}
+
+TEST_F(TodayServiceCase, SubscribeUnsubscribeConcurrently)
+{
+	constexpr size_t c_threadCount = 4;
+	constexpr size_t c_subscriptionsPerThread = 50;
+	std::mutex keysMutex;
+	std::vector<service::SubscriptionKey> keys;
+	std::vector<std::thread> threads;
+
+	threads.reserve(c_threadCount);
+
+	for (size_t i = 0; i < c_threadCount; ++i)
+	{
+		threads.emplace_back([this, &keysMutex, &keys]() {
+			for (size_t j = 0; j < c_subscriptionsPerThread; ++j)
+			{
+				auto query = peg::parseString(R"(subscription {
+						nextAppointmentChange {
+							id
+						}
+					})");
+				auto callback = [](response::Value&&) {
+				};
+				const auto key =
+					_mockService->service->subscribe({ std::move(callback), std::move(query) }).get();
+
+				{
+					const std::lock_guard lock { keysMutex };
+
+					keys.push_back(key);
+				}
+
+				_mockService->service->deliver({ "nextAppointmentChange"sv }).get();
+				_mockService->service->unsubscribe({ key }).get();
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	EXPECT_EQ(c_threadCount * c_subscriptionsPerThread, keys.size());
+	EXPECT_EQ(keys.end(), std::adjacent_find(keys.begin(), keys.end()))
+		<< "should never reuse a key";
+}
+
 TEST_F(TodayServiceCase, NonblockingDeferredExpensive)
 {
 	auto query = R"(query NonblockingDeferredExpensive {
@@ -2084,3 +2435,648 @@ TEST_F(TodayServiceCase, MutateCoerceSetFloat)
 		FAIL() << response::toJSON(ex.getErrors());
 	}
 }
+
+TEST_F(TodayServiceCase, PreparedOperationMatchesResolve)
+{
+	auto query = R"(query PreparedAppointments($appointmentId: ID!, $withSubject: Boolean = true) {
+			appointmentsById(ids: [$appointmentId]) {
+				...AppointmentFragment
+				subject @include(if: $withSubject)
+				isNow @skip(if: true)
+			}
+			appointments {
+				edges {
+					node {
+						...on Appointment {
+							appointmentId: id
+							when
+						}
+					}
+				}
+			}
+		}
+
+		fragment AppointmentFragment on Appointment {
+			appointmentId: id
+			when
+		})"_graphql;
+	const auto prepared = _mockService->service->prepare(query, "PreparedAppointments"sv);
+
+	try
+	{
+		for (const bool withSubject : { true, false })
+		{
+			response::Value variables(response::Type::Map);
+			variables.emplace_back("appointmentId",
+				response::Value("ZmFrZUFwcG9pbnRtZW50SWQ="s).from_json());
+			variables.emplace_back("withSubject", response::Value(withSubject));
+			auto expected = _mockService->service
+								->resolve({ query,
+									"PreparedAppointments"sv,
+									response::Value(variables),
+									{},
+									std::make_shared<today::RequestState>(23) })
+								.get();
+			auto result = _mockService->service
+							  ->resolve({ prepared,
+								  std::move(variables),
+								  {},
+								  std::make_shared<today::RequestState>(24) })
+							  .get();
+
+			ASSERT_TRUE(result.type() == response::Type::Map);
+			auto errorsItr = result.find("errors");
+			if (errorsItr != result.get<response::MapType>().cend())
+			{
+				FAIL() << response::toJSON(response::Value(errorsItr->second));
+			}
+			const auto data = service::ScalarArgument::require("data", result);
+			const auto appointmentsById =
+				service::ScalarArgument::require<service::TypeModifier::List>("appointmentsById",
+					data);
+			ASSERT_EQ(size_t { 1 }, appointmentsById.size());
+			const auto& appointmentEntry = appointmentsById.front();
+			EXPECT_EQ(today::getFakeAppointmentId(),
+				service::IdArgument::require("appointmentId", appointmentEntry))
+				<< "id should match in base64 encoding";
+			EXPECT_EQ(withSubject,
+				appointmentEntry.find("subject")
+					!= appointmentEntry.get<response::MapType>().cend())
+				<< "subject should only be included with the variable";
+			EXPECT_TRUE(
+				appointmentEntry.find("isNow") == appointmentEntry.get<response::MapType>().cend())
+				<< "isNow should be skipped";
+			EXPECT_EQ(response::toJSON(std::move(expected)), response::toJSON(std::move(result)))
+				<< "prepared operation should match the result of resolving the AST";
+		}
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST_F(TodayServiceCase, PreparedOperationDirectives)
+{
+	auto query = R"(query PreparedDirectives($tag: String!) @queryTag(query: $tag) {
+			nested {
+				depth
+			}
+		})"_graphql;
+	const auto prepared = _mockService->service->prepare(query, "PreparedDirectives"sv);
+	response::Value variables(response::Type::Map);
+
+	variables.emplace_back("tag", response::Value("prepared"s));
+
+	auto result = _mockService->service->resolve({ prepared, std::move(variables) }).get();
+
+	try
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		auto errorsItr = result.find("errors");
+		if (errorsItr != result.get<response::MapType>().cend())
+		{
+			FAIL() << response::toJSON(response::Value(errorsItr->second));
+		}
+		auto capturedParams = today::NestedType::getCapturedParams();
+		ASSERT_EQ(size_t { 1 }, capturedParams.size()) << "should resolve one NestedType";
+		const auto params = std::move(capturedParams.top());
+		ASSERT_EQ(size_t { 1 }, params.operationDirectives.size())
+			<< "missing operation directive";
+		const auto itrQueryTag = params.operationDirectives.cbegin();
+		ASSERT_TRUE(itrQueryTag->first == "queryTag"sv) << "missing required directive";
+		EXPECT_EQ("prepared", service::StringArgument::require("query", itrQueryTag->second))
+			<< "should evaluate the operation directive with the variables";
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST_F(TodayServiceCase, PreparedOperationValidationError)
+{
+	auto query = R"(query {
+			unknownField
+		})"_graphql;
+
+	try
+	{
+		const auto prepared = _mockService->service->prepare(query);
+		FAIL() << "prepare should throw a schema_exception";
+	}
+	catch (service::schema_exception& ex)
+	{
+		EXPECT_FALSE(ex.getStructuredErrors().empty()) << "validation errors should be reported";
+	}
+}
+
+TEST_F(TodayServiceCase, ResolveQueryTextCache)
+{
+	const auto first = R"(query { appointments { edges { node { id subject } } } })"sv;
+	const auto second = R"(query {
+			# Same document with different whitespace, commas, and comments.
+			appointments { edges { node { id, subject } } }
+		})"sv;
+	auto expected = _mockService->service
+						->resolve({ first, {}, {}, {}, std::make_shared<today::RequestState>(25) })
+						.get();
+	auto result = _mockService->service
+					  ->resolve({ second, {}, {}, {}, std::make_shared<today::RequestState>(26) })
+					  .get();
+	const auto statistics = _mockService->service->getDocumentCache().getStatistics();
+
+	EXPECT_EQ(size_t { 1 }, statistics.misses) << "first query should be parsed and validated";
+	EXPECT_EQ(size_t { 1 }, statistics.hits) << "second query should reuse the cached document";
+	EXPECT_EQ(size_t { 1 }, statistics.size) << "both queries should share one cache entry";
+	EXPECT_EQ(response::toJSON(std::move(expected)), response::toJSON(std::move(result)))
+		<< "cached document should resolve the same result";
+}
+
+TEST_F(TodayServiceCase, ResolveQueryTextCacheLocations)
+{
+	const auto first = R"(query { unimplemented })"sv;
+	const auto second = R"(query {
+  unimplemented
+})"sv;
+	auto firstResult = _mockService->service->resolve({ first }).get();
+	auto secondResult = _mockService->service->resolve({ second }).get();
+	const auto statistics = _mockService->service->getDocumentCache().getStatistics();
+
+	EXPECT_EQ(size_t { 1 }, statistics.hits) << "second query should skip validation";
+	EXPECT_EQ(size_t { 1 }, statistics.size) << "both queries should share one cache entry";
+
+	for (const auto& [result, line, column] :
+		{ std::make_tuple(&firstResult, 1, 9), std::make_tuple(&secondResult, 2, 3) })
+	{
+		const auto errors =
+			service::ScalarArgument::require<service::TypeModifier::List>("errors", *result);
+
+		ASSERT_EQ(size_t { 1 }, errors.size());
+
+		const auto locations =
+			service::ScalarArgument::require<service::TypeModifier::List>("locations",
+				errors.front());
+
+		ASSERT_EQ(size_t { 1 }, locations.size());
+		EXPECT_EQ(line, service::IntArgument::require("line", locations.front()))
+			<< "line should refer to the text of each query";
+		EXPECT_EQ(column, service::IntArgument::require("column", locations.front()))
+			<< "column should refer to the text of each query";
+	}
+}
+
+TEST_F(TodayServiceCase, ResolveQueryTextErrors)
+{
+	auto syntaxError =
+		_mockService->service->resolve({ R"(query { appointments { )"sv }).get();
+	auto validationError =
+		_mockService->service->resolve({ R"(query { unknownField })"sv }).get();
+	const auto statistics = _mockService->service->getDocumentCache().getStatistics();
+
+	ASSERT_TRUE(syntaxError.type() == response::Type::Map);
+	EXPECT_FALSE(service::ScalarArgument::require<service::TypeModifier::List>("errors",
+		syntaxError)
+					 .empty())
+		<< "syntax error should be reported in the errors";
+	ASSERT_TRUE(validationError.type() == response::Type::Map);
+	EXPECT_FALSE(service::ScalarArgument::require<service::TypeModifier::List>("errors",
+		validationError)
+					 .empty())
+		<< "validation error should be reported in the errors";
+	EXPECT_EQ(size_t { 0 }, statistics.size) << "invalid documents should not be cached";
+}
+
+TEST_F(TodayServiceCase, ResolveStreaming)
+{
+	constexpr auto c_query = R"(query {
+			appointments { edges { node { id subject } } }
+			tasks { edges { node { id title isComplete } } }
+			unreadCounts { edges { node { id name unreadCount } } }
+		})"sv;
+	auto expectedQuery = peg::parseString(c_query);
+	auto streamedQuery = peg::parseString(c_query);
+	auto expected = _mockService->service
+						->resolve({ expectedQuery,
+							{},
+							response::Value { response::Type::Map },
+							std::launch::async,
+							std::make_shared<today::RequestState>(27) })
+						.get();
+	std::vector<std::string> chunks;
+	auto writer = response::makeJSONWriter(
+		[&chunks](std::string_view chunk) {
+			chunks.emplace_back(chunk);
+		},
+		16);
+
+	_mockService->service
+		->resolve({ streamedQuery,
+					  {},
+					  response::Value { response::Type::Map },
+					  std::launch::async,
+					  std::make_shared<today::RequestState>(28) },
+			writer)
+		.get();
+
+	std::string result;
+
+	for (const auto& chunk : chunks)
+	{
+		EXPECT_FALSE(chunk.empty()) << "sink should not receive empty chunks";
+		result.append(chunk);
+	}
+
+	EXPECT_LT(size_t { 1 }, chunks.size()) << "response should be written in several chunks";
+	EXPECT_EQ(response::toJSON(std::move(expected)), result)
+		<< "streamed response should match the resolved response";
+}
+
+TEST_F(TodayServiceCase, ResolveStreamingErrors)
+{
+	auto query = R"(query { unknownField })"_graphql;
+	std::string result;
+	auto writer = response::makeJSONWriter([&result](std::string_view chunk) {
+		result.append(chunk);
+	});
+
+	_mockService->service->resolve({ query }, writer).get();
+
+	const auto document = response::parseJSON(result);
+
+	ASSERT_TRUE(document.type() == response::Type::Map);
+	EXPECT_FALSE(
+		service::ScalarArgument::require<service::TypeModifier::List>("errors", document).empty())
+		<< "validation error should be reported in the errors";
+}
+
+TEST_F(TodayServiceCase, ResolveStreamingFieldErrors)
+{
+	constexpr auto c_query = R"(query {
+			appointments { edges { node { id subject } } }
+			unimplemented
+			tasks { edges { node { id title } } }
+		})"sv;
+	auto expectedQuery = peg::parseString(c_query);
+	auto streamedQuery = peg::parseString(c_query);
+	auto expected = _mockService->service
+						->resolve({ expectedQuery,
+							{},
+							response::Value { response::Type::Map },
+							std::launch::async,
+							std::make_shared<today::RequestState>(29) })
+						.get();
+	std::string result;
+	auto writer = response::makeJSONWriter([&result](std::string_view chunk) {
+		result.append(chunk);
+	});
+
+	_mockService->service
+		->resolve({ streamedQuery,
+					  {},
+					  response::Value { response::Type::Map },
+					  std::launch::async,
+					  std::make_shared<today::RequestState>(30) },
+			writer)
+		.get();
+
+	EXPECT_EQ(response::toJSON(std::move(expected)), result)
+		<< "streamed response should match the resolved response";
+}
+
+TEST_F(TodayServiceCase, ResolveIncremental)
+{
+	auto query = R"(query Incremental($appointmentId: ID!) {
+			appointmentsById(ids: [$appointmentId, $appointmentId, $appointmentId])
+				@stream(label: "more", initialCount: 1) {
+				appointmentId: id
+			}
+			... @defer(label: "later") {
+				unreadCounts { edges { node { name } } }
+			}
+		})"_graphql;
+	response::Value variables(response::Type::Map);
+	variables.emplace_back("appointmentId",
+		response::Value("ZmFrZUFwcG9pbnRtZW50SWQ="s).from_json());
+	std::vector<response::Value> payloads;
+
+	_mockService->service
+		->resolveIncremental({ query, {}, std::move(variables) },
+			[&payloads](response::Value&& payload) {
+				payloads.push_back(std::move(payload));
+			})
+		.get();
+
+	try
+	{
+		ASSERT_EQ(size_t { 4 }, payloads.size())
+			<< "initial payload, 1 deferred fragment, and 2 streamed items";
+
+		for (size_t i = 0; i < payloads.size(); ++i)
+		{
+			ASSERT_TRUE(payloads[i].type() == response::Type::Map);
+			EXPECT_TRUE(payloads[i].find("errors") == payloads[i].get<response::MapType>().cend())
+				<< response::toJSON(response::Value(payloads[i]));
+			EXPECT_EQ(i + 1 < payloads.size(),
+				service::BooleanArgument::require("hasNext", payloads[i]))
+				<< "only the last payload should have hasNext: false";
+		}
+
+		const auto initial = service::ScalarArgument::require("data", payloads.front());
+		const auto appointmentsById =
+			service::ScalarArgument::require<service::TypeModifier::List>("appointmentsById",
+				initial);
+		ASSERT_EQ(size_t { 1 }, appointmentsById.size()) << "initialCount should be 1";
+		EXPECT_EQ(today::getFakeAppointmentId(),
+			service::IdArgument::require("appointmentId", appointmentsById.front()));
+		EXPECT_TRUE(initial.find("unreadCounts") == initial.get<response::MapType>().cend())
+			<< "deferred fragment should not be in the initial payload";
+
+		std::vector<int> streamedIndices;
+		size_t deferredCount = 0;
+
+		for (auto itr = payloads.cbegin() + 1; itr != payloads.cend(); ++itr)
+		{
+			const auto label = service::StringArgument::require("label", *itr);
+			const auto path =
+				service::ScalarArgument::require<service::TypeModifier::List>("path", *itr);
+
+			if (label == "more")
+			{
+				ASSERT_EQ(size_t { 2 }, path.size());
+				EXPECT_EQ("appointmentsById", path.front().get<std::string>());
+				streamedIndices.push_back(path.back().get<int>());
+
+				const auto items =
+					service::ScalarArgument::require<service::TypeModifier::List>("items", *itr);
+				ASSERT_EQ(size_t { 1 }, items.size()) << "items should be delivered one at a time";
+				EXPECT_EQ(today::getFakeAppointmentId(),
+					service::IdArgument::require("appointmentId", items.front()));
+			}
+			else
+			{
+				EXPECT_EQ("later", label);
+				EXPECT_TRUE(path.empty()) << "fragment was deferred on the Query type";
+				++deferredCount;
+
+				const auto data = service::ScalarArgument::require("data", *itr);
+				const auto unreadCounts = service::ScalarArgument::require("unreadCounts", data);
+				const auto edges =
+					service::ScalarArgument::require<service::TypeModifier::List>("edges",
+						unreadCounts);
+				ASSERT_EQ(size_t { 1 }, edges.size());
+				const auto node = service::ScalarArgument::require("node", edges.front());
+				EXPECT_EQ("\"Fake\" Inbox", service::StringArgument::require("name", node));
+			}
+		}
+
+		EXPECT_EQ(size_t { 1 }, deferredCount);
+		EXPECT_EQ((std::vector<int> { 1, 2 }), streamedIndices)
+			<< "streamed items should be delivered in order";
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST_F(TodayServiceCase, ResolveIncrementalSlowDeferred)
+{
+	// The tasks are not loaded until the callback has received the fast deferred fragment, so the
+	// slow one can only finish if the initial payload and the fast one are delivered first.
+	std::promise<void> releaseTasks;
+	auto tasksReleased = releaseTasks.get_future().share();
+	std::atomic_bool tasksTimedOut = false;
+	auto query = std::make_shared<today::Query>(
+		[]() -> std::vector<std::shared_ptr<today::Appointment>> {
+			return { std::make_shared<today::Appointment>(
+				response::IdType(today::getFakeAppointmentId()),
+				"tomorrow",
+				"Lunch?",
+				false) };
+		},
+		[tasksReleased, &tasksTimedOut]() -> std::vector<std::shared_ptr<today::Task>> {
+			tasksTimedOut = tasksReleased.wait_for(10s) == std::future_status::timeout;
+			return { std::make_shared<today::Task>(response::IdType(today::getFakeTaskId()),
+				"Don't forget",
+				true) };
+		},
+		[]() -> std::vector<std::shared_ptr<today::Folder>> {
+			return { std::make_shared<today::Folder>(response::IdType(today::getFakeFolderId()),
+				"\"Fake\" Inbox",
+				3) };
+		});
+	auto service =
+		std::make_shared<today::Operations>(std::move(query), std::shared_ptr<today::Mutation> {});
+	auto document = R"(query {
+			appointments { edges { node { subject } } }
+			... @defer(label: "slow") {
+				tasks { edges { node { title } } }
+			}
+			... @defer(label: "fast") {
+				unreadCounts { edges { node { name } } }
+			}
+		})"_graphql;
+	std::vector<std::string> labels;
+
+	service
+		->resolveIncremental({ document, {}, response::Value { response::Type::Map } },
+			[&labels, &releaseTasks](response::Value&& payload) {
+				const auto itrLabel = payload.find("label");
+
+				if (itrLabel == payload.get<response::MapType>().cend())
+				{
+					labels.push_back({});
+					return;
+				}
+
+				labels.push_back(itrLabel->second.get<std::string>());
+
+				if (labels.back() == "fast")
+				{
+					releaseTasks.set_value();
+				}
+			})
+		.get();
+
+	EXPECT_FALSE(tasksTimedOut) << "slow fragment should not hold up the fast one";
+	EXPECT_EQ((std::vector<std::string> { {}, "fast", "slow" }), labels)
+		<< "deferred fragments should be delivered as they complete";
+}
+
+TEST_F(TodayServiceCase, IncrementalDirectivesResolveInline)
+{
+	auto query = R"(query {
+			tasks { edges @stream(initialCount: 0) { node { title } } }
+			... @defer { unreadCounts { edges { node { name } } } }
+		})"_graphql;
+	auto result = _mockService->service->resolve({ query }).get();
+
+	try
+	{
+		ASSERT_TRUE(result.type() == response::Type::Map);
+		EXPECT_TRUE(result.find("errors") == result.get<response::MapType>().cend())
+			<< response::toJSON(response::Value(result));
+		EXPECT_TRUE(result.find("hasNext") == result.get<response::MapType>().cend())
+			<< "resolve should not deliver incremental payloads";
+
+		const auto data = service::ScalarArgument::require("data", result);
+		const auto tasks = service::ScalarArgument::require("tasks", data);
+		const auto unreadCounts = service::ScalarArgument::require("unreadCounts", data);
+
+		EXPECT_EQ(size_t { 1 },
+			service::ScalarArgument::require<service::TypeModifier::List>("edges", tasks).size());
+		EXPECT_EQ(size_t { 1 },
+			service::ScalarArgument::require<service::TypeModifier::List>("edges", unreadCounts)
+				.size());
+	}
+	catch (service::schema_exception& ex)
+	{
+		FAIL() << response::toJSON(ex.getErrors());
+	}
+}
+
+TEST_F(TodayServiceCase, ResolveWithValueArena)
+{
+	auto query = R"(query {
+			appointments { edges { node { id subject when isNow } } }
+			tasks { edges { node { id title isComplete } } }
+			unreadCounts { edges { node { id name unreadCount } } }
+		})"_graphql;
+	auto expected = _mockService->service->resolve({ query }).get();
+	response::ValueArena arena;
+	auto result = _mockService->service
+					  ->resolve({ query,
+						  {},
+						  response::Value { response::Type::Map },
+						  std::launch::async,
+						  {},
+						  &arena })
+					  .get();
+
+	EXPECT_TRUE(expected == result) << "arena should not change the response";
+
+	const auto& data = result["data"sv];
+
+	ASSERT_TRUE(data.type() == response::Type::Map);
+	EXPECT_EQ(&arena, data.get<response::MapType>().get_allocator().resource())
+		<< "maps in the response should allocate from the arena";
+	EXPECT_EQ(&arena,
+		data["appointments"sv]["edges"sv].get<response::ListType>().get_allocator().resource())
+		<< "lists in the response should allocate from the arena";
+}
+
+TEST_F(TodayServiceCase, AutomaticPersistedQuery)
+{
+	const auto query = R"(query { appointments { edges { node { id subject } } } })"sv;
+	const auto hash = internal::Sha256::hashHex(query);
+	auto notFound = _mockService->service->resolvePersisted({ hash }).get();
+
+	EXPECT_EQ(R"js({"data":null,"errors":[{"message":"PersistedQueryNotFound"}]})js",
+		response::toJSON(std::move(notFound)))
+		<< "unknown hash without the query text should ask for the query";
+
+	auto mismatch =
+		_mockService->service->resolvePersisted({ hash, R"(query { tasks { id } })"sv }).get();
+
+	EXPECT_EQ(R"js({"data":null,"errors":[{"message":"provided sha does not match query"}]})js",
+		response::toJSON(std::move(mismatch)))
+		<< "query text should match the hash";
+
+	auto expected =
+		_mockService->service
+			->resolvePersisted(
+				{ hash, query, {}, {}, {}, std::make_shared<today::RequestState>(27) })
+			.get();
+	auto result =
+		_mockService->service
+			->resolvePersisted({ hash, {}, {}, {}, {}, std::make_shared<today::RequestState>(28) })
+			.get();
+
+	EXPECT_EQ(response::toJSON(std::move(expected)), response::toJSON(std::move(result)))
+		<< "hash should resolve the registered query without the query text";
+	EXPECT_EQ(size_t { 1 }, _mockService->service->getPersistedQueryCache().getStatistics().size)
+		<< "query text should only be registered once";
+}
+
+TEST_F(TodayServiceCase, RegisterPersistedQuery)
+{
+	const auto query = R"(query { appointments { edges { node { id subject } } } })"sv;
+	const auto hash = _mockService->service->registerPersistedQuery(query);
+
+	EXPECT_EQ(internal::Sha256::hashHex(query), hash);
+
+	std::string upperHash { hash };
+
+	std::transform(upperHash.begin(), upperHash.end(), upperHash.begin(), [](char ch) noexcept {
+		return static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+	});
+
+	auto result = _mockService->service
+					  ->resolvePersisted(
+						  { upperHash, {}, {}, {}, {}, std::make_shared<today::RequestState>(29) })
+					  .get();
+
+	ASSERT_TRUE(result.type() == response::Type::Map);
+	EXPECT_TRUE(result.find("errors"sv) == result.end()) << "hex digits should be case insensitive";
+	EXPECT_EQ(size_t { 0 }, _mockService->service->getPersistedQueryCache().getStatistics().size)
+		<< "registered queries should not use the cache";
+
+	try
+	{
+		static_cast<void>(
+			_mockService->service->registerPersistedQuery(R"(query { unknownField })"sv));
+		FAIL() << "invalid query should throw";
+	}
+	catch (service::schema_exception& ex)
+	{
+		EXPECT_FALSE(ex.getStructuredErrors().empty());
+	}
+}
+
+TEST_F(TodayServiceCase, RegisterPersistedQueries)
+{
+	const auto query = R"(query { tasks { edges { node { id title } } } })"sv;
+	const auto directory =
+		std::filesystem::temp_directory_path() / "cppgraphqlgen-RegisterPersistedQueries";
+
+	std::filesystem::remove_all(directory);
+	ASSERT_TRUE(std::filesystem::create_directories(directory));
+
+	{
+		std::ofstream graphql { directory / "tasks.graphql", std::ios::out | std::ios::binary };
+		std::ofstream ignored { directory / "README.txt", std::ios::out | std::ios::binary };
+
+		graphql << query;
+		ignored << "not a query";
+	}
+
+	const auto count = _mockService->service->registerPersistedQueries(directory);
+
+	std::filesystem::remove_all(directory);
+
+	EXPECT_EQ(size_t { 1 }, count) << "only the .graphql files should be registered";
+
+	auto result = _mockService->service
+					  ->resolvePersisted({ internal::Sha256::hashHex(query),
+						  {},
+						  {},
+						  {},
+						  {},
+						  std::make_shared<today::RequestState>(31) })
+					  .get();
+
+	ASSERT_TRUE(result.type() == response::Type::Map);
+	EXPECT_TRUE(result.find("errors"sv) == result.end())
+		<< "hash of the file contents should resolve the registered query";
+	EXPECT_EQ(size_t { 0 }, _mockService->service->getPersistedQueryCache().getStatistics().size)
+		<< "registered queries should not use the cache";
+
+	auto unknown =
+		_mockService->service->resolvePersisted({ internal::Sha256::hashHex("{ unknown }"sv) })
+			.get();
+
+	EXPECT_EQ(R"js({"data":null,"errors":[{"message":"PersistedQueryNotFound"}]})js",
+		response::toJSON(std::move(unknown)))
+		<< "unknown hash should not resolve";
+}
@@ -7,7 +7,11 @@
 
 #include "graphqlservice/JSONResponse.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <sstream>
+#include <thread>
 
 using namespace graphql;
 
@@ -2037,3 +2041,359 @@ TEST_F(ValidationExamplesCase, Example187)
 
 	ASSERT_TRUE(errors.empty());
 }
+
+TEST_F(ValidationExamplesCase, ConcurrentValidation)
+{
+	constexpr size_t c_iterations = 200;
+	const size_t threadCount = std::max(size_t { 4 }, size_t { std::thread::hardware_concurrency() });
+	std::atomic_size_t validCount = 0;
+	std::atomic_size_t invalidCount = 0;
+	std::vector<std::thread> threads;
+
+	threads.reserve(threadCount);
+
+	const auto startTime = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([&validCount, &invalidCount]() {
+			for (size_t j = 0; j < c_iterations; ++j)
+			{
+				auto valid = peg::parseString(R"(query getDogName {
+						dog {
+							name
+							nickname
+							barkVolume
+						}
+					})"sv);
+				auto invalid = peg::parseString(R"(query getDogName {
+						dog {
+							name
+							color
+						}
+					})"sv);
+
+				if (_service->validate(valid).empty())
+				{
+					++validCount;
+				}
+
+				if (_service->validate(invalid).size() == 1)
+				{
+					++invalidCount;
+				}
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - startTime);
+
+	EXPECT_EQ(threadCount * c_iterations, validCount.load())
+		<< "every valid query should pass validation on every thread";
+	EXPECT_EQ(threadCount * c_iterations, invalidCount.load())
+		<< "every invalid query should report the same error on every thread";
+
+	RecordProperty("threads", static_cast<int>(threadCount));
+	RecordProperty("validationsPerSecond",
+		static_cast<int>(threadCount * c_iterations * 2 * 1000000
+			/ std::max(std::chrono::microseconds::rep { 1 }, elapsed.count())));
+}
+
+TEST_F(ValidationExamplesCase, ReusedFragmentConflictingField)
+{
+	// The second spread reuses the fields from validating the fragment the first time.
+	auto query = R"(query {
+			dog {
+				...dogName
+			}
+			otherDog: dog {
+				name: nickname
+				...dogName
+			}
+		}
+
+		fragment dogName on Dog {
+			name
+		})"_graphql;
+
+	auto errors =
+		service::buildErrorValues(_service->validate(query)).release<response::ListType>();
+
+	EXPECT_EQ(errors.size(), size_t { 1 }) << "1 conflicting field";
+	ASSERT_GE(errors.size(), size_t { 1 });
+	EXPECT_EQ(
+		R"js({"message":"Conflicting field type: Dog name: name","locations":[{"line":12,"column":4}]})js",
+		response::toJSON(std::move(errors[0])))
+		<< "error should match";
+}
+
+TEST_F(ValidationExamplesCase, DeeplyReusedFragments)
+{
+	// Each fragment spreads the next one twice, which should not take exponential time.
+	constexpr size_t c_depth = 64;
+	std::ostringstream oss;
+
+	oss << "query { dog { ...dogFragment0 } }";
+
+	for (size_t i = 0; i < c_depth; ++i)
+	{
+		oss << " fragment dogFragment" << i << " on Dog { name owner { pets { ... on Dog { "
+			<< "...dogFragment" << (i + 1) << " } } } otherOwner: owner { pets { ... on Dog { "
+			<< "...dogFragment" << (i + 1) << " } } } }";
+	}
+
+	oss << " fragment dogFragment" << c_depth << " on Dog { name }";
+
+	auto query = peg::parseString(oss.str());
+	auto errors = _service->validate(query);
+
+	EXPECT_TRUE(errors.empty()) << response::toJSON(service::buildErrorValues(std::move(errors)));
+}
+
+TEST_F(ValidationExamplesCase, OperationCostLimit)
+{
+	// Use a separate service so the cost limit does not affect any of the other tests.
+	auto costService =
+		std::make_shared<validation::Operations>(std::make_shared<validation::Query>(),
+			std::make_shared<validation::Mutation>());
+	auto query = R"(query getDogOwner {
+			dog {
+				name
+				owner {
+					name
+				}
+			}
+		})"_graphql;
+
+	costService->setCostLimit({ 4 });
+
+	auto errors = costService->validate(query);
+
+	EXPECT_TRUE(errors.empty()) << response::toJSON(service::buildErrorValues(std::move(errors)));
+
+	query.validated = false;
+	costService->setCostLimit({ 3 });
+
+	auto rejected =
+		service::buildErrorValues(costService->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(rejected.size(), size_t { 1 });
+	EXPECT_EQ(
+		R"js({"message":"Operation cost: 4 exceeds limit: 3 name: getDogOwner","locations":[{"line":1,"column":1}]})js",
+		response::toJSON(std::move(rejected[0])))
+		<< "error should match";
+}
+
+TEST_F(ValidationExamplesCase, ReusedFragmentsCostLimit)
+{
+	// Each fragment spreads the next one twice, so the cost grows exponentially even though the
+	// fragments are only validated once.
+	constexpr size_t c_depth = 64;
+	auto costService =
+		std::make_shared<validation::Operations>(std::make_shared<validation::Query>(),
+			std::make_shared<validation::Mutation>());
+	std::ostringstream oss;
+
+	oss << "query { dog { ...dogFragment0 } }";
+
+	for (size_t i = 0; i < c_depth; ++i)
+	{
+		oss << " fragment dogFragment" << i << " on Dog { name owner { pets { ... on Dog { "
+			<< "...dogFragment" << (i + 1) << " } } } otherOwner: owner { pets { ... on Dog { "
+			<< "...dogFragment" << (i + 1) << " } } } }";
+	}
+
+	oss << " fragment dogFragment" << c_depth << " on Dog { name }";
+
+	auto query = peg::parseString(oss.str());
+
+	costService->setCostLimit({ 1'000'000 });
+
+	auto errors =
+		service::buildErrorValues(costService->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(errors.size(), size_t { 1 });
+
+	const auto message = errors[0][R"js(message)js"].get<std::string>();
+
+	EXPECT_EQ(message.substr(0, 16), "Operation cost: "sv) << message;
+}
+
+TEST_F(ValidationExamplesCase, WeightedFieldCostLimit)
+{
+	auto costService =
+		std::make_shared<validation::Operations>(std::make_shared<validation::Query>(),
+			std::make_shared<validation::Mutation>());
+	auto query = R"(query getDogBarkVolume {
+			dog {
+				name
+				barkVolume
+			}
+		})"_graphql;
+
+	// dog (1) + name (1) + barkVolume @cost(weight: 5)
+	costService->setCostLimit({ 7 });
+
+	auto errors = costService->validate(query);
+
+	EXPECT_TRUE(errors.empty()) << response::toJSON(service::buildErrorValues(std::move(errors)));
+
+	query.validated = false;
+	costService->setCostLimit({ 6 });
+
+	auto rejected =
+		service::buildErrorValues(costService->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(rejected.size(), size_t { 1 });
+	EXPECT_EQ(
+		R"js({"message":"Operation cost: 7 exceeds limit: 6 name: getDogBarkVolume","locations":[{"line":1,"column":1}]})js",
+		response::toJSON(std::move(rejected[0])))
+		<< "error should match";
+}
+
+TEST_F(ValidationExamplesCase, MultiplierCostLimit)
+{
+	auto costService =
+		std::make_shared<validation::Operations>(std::make_shared<validation::Query>(),
+			std::make_shared<validation::Mutation>());
+	const auto getCost = [&costService](std::string_view queryText, size_t variableMultiplier) {
+		auto query = peg::parseString(queryText);
+
+		// Set a limit which every operation exceeds, and read the cost from the error.
+		costService->setCostLimit({ 1, variableMultiplier });
+
+		auto errors =
+			service::buildErrorValues(costService->validate(query)).release<response::ListType>();
+
+		EXPECT_EQ(errors.size(), size_t { 1 }) << queryText;
+
+		if (errors.size() != 1)
+		{
+			return std::string {};
+		}
+
+		return errors[0][R"js(message)js"].get<std::string>();
+	};
+
+	// dogs @cost(weight: 2, multipliers: ["first", "last"]) with the default first: 10
+	EXPECT_EQ("Operation cost: 12 exceeds limit: 1", getCost("{ dogs { name } }", 100));
+
+	// The largest multiplier wins.
+	EXPECT_EQ("Operation cost: 32 exceeds limit: 1",
+		getCost("{ dogs(first: 3, last: 5) { name barkVolume } }", 100));
+	EXPECT_EQ("Operation cost: 22 exceeds limit: 1", getCost("{ dogs(last: 20) { name } }", 100));
+	EXPECT_EQ("Operation cost: 12 exceeds limit: 1", getCost("{ dogs(last: 2) { name } }", 100));
+	EXPECT_EQ("Operation cost: 2 exceeds limit: 1",
+		getCost("{ dogs(first: 0, last: 0) { name } }", 100));
+
+	// A multiplier passed as a variable uses the variableMultiplier.
+	EXPECT_EQ("Operation cost: 9 exceeds limit: 1",
+		getCost("query ($count: Int) { dogs(first: $count) { name } }", 7));
+	EXPECT_EQ("Operation cost: 302 exceeds limit: 1",
+		getCost("query ($count: Int) { dogs(last: $count) { name } }", 300));
+
+	// Multipliers apply to the whole selection set, including nested selection sets.
+	EXPECT_EQ("Operation cost: 10 exceeds limit: 1",
+		getCost("{ dogs(first: 2) { owner { pets { name } } name } }", 100));
+}
+
+TEST_F(ValidationExamplesCase, StreamOnListField)
+{
+	auto query = R"(query getDogNames {
+			dogs @stream(label: "more", initialCount: 1) {
+				name
+			}
+		})"_graphql;
+
+	auto errors = _service->validate(query);
+
+	EXPECT_TRUE(errors.empty()) << response::toJSON(service::buildErrorValues(std::move(errors)));
+}
+
+TEST_F(ValidationExamplesCase, StreamOnNonListField)
+{
+	auto query = R"(query getDogName {
+			dog @stream {
+				name @stream
+			}
+		})"_graphql;
+
+	auto errors =
+		service::buildErrorValues(_service->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(errors.size(), size_t { 2 });
+	EXPECT_EQ(
+		R"js({"message":"Stream directive on non-list field name: dog","locations":[{"line":2,"column":4}]})js",
+		response::toJSON(std::move(errors[0])))
+		<< "error should match";
+	EXPECT_EQ(
+		R"js({"message":"Stream directive on non-list field name: name","locations":[{"line":3,"column":5}]})js",
+		response::toJSON(std::move(errors[1])))
+		<< "error should match";
+}
+
+TEST_F(ValidationExamplesCase, StreamWithNegativeInitialCount)
+{
+	auto query = R"(query getDogNames {
+			dogs @stream(initialCount: -1) {
+				name
+			}
+		})"_graphql;
+
+	auto errors =
+		service::buildErrorValues(_service->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(errors.size(), size_t { 1 });
+	EXPECT_EQ(
+		R"js({"message":"Negative argument directive: stream name: initialCount","locations":[{"line":2,"column":17}]})js",
+		response::toJSON(std::move(errors[0])))
+		<< "error should match";
+}
+
+TEST_F(ValidationExamplesCase, IncrementalOnSubscriptionRoot)
+{
+	auto query = R"(subscription sub {
+			... @defer {
+				newMessage {
+					body
+				}
+			}
+		}
+
+		subscription subFragment {
+			...newMessageFields @defer
+		}
+
+		subscription nestedDefer {
+			newMessage {
+				... @defer {
+					body
+				}
+			}
+		}
+
+		fragment newMessageFields on Subscription {
+			newMessage {
+				body
+			}
+		})"_graphql;
+
+	auto errors =
+		service::buildErrorValues(_service->validate(query)).release<response::ListType>();
+
+	ASSERT_EQ(errors.size(), size_t { 2 }) << "nested @defer is allowed in a subscription";
+	EXPECT_EQ(
+		R"js({"message":"Incremental directive on subscription root name: defer","locations":[{"line":2,"column":8}]})js",
+		response::toJSON(std::move(errors[0])))
+		<< "error should match";
+	EXPECT_EQ(
+		R"js({"message":"Incremental directive on subscription root name: defer","locations":[{"line":10,"column":24}]})js",
+		response::toJSON(std::move(errors[1])))
+		<< "error should match";
+}